@@ -0,0 +1,368 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAILODSubsystem.h"
+#include "PantherJamPlayerSnapshotSubsystem.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("PantherJamAILOD"), STATGROUP_PantherJamAILOD, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Update Buckets"), STAT_PantherJamAILODUpdate, STATGROUP_PantherJamAILOD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Near Agents"), STAT_PantherJamAILODNear, STATGROUP_PantherJamAILOD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Mid Agents"), STAT_PantherJamAILODMid, STATGROUP_PantherJamAILOD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Far Agents"), STAT_PantherJamAILODFar, STATGROUP_PantherJamAILOD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Agents"), STAT_PantherJamAILODDormant, STATGROUP_PantherJamAILOD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Skipped Agent Ticks"), STAT_PantherJamAILODSkippedTicks, STATGROUP_PantherJamAILOD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Est. Time Saved (ms)"), STAT_PantherJamAILODTimeSaved, STATGROUP_PantherJamAILOD);
+
+static TAutoConsoleVariable<bool> CVarAILODEnable(
+	TEXT("AI.LOD.Enable"),
+	true,
+	TEXT("If true, AI pawns tick at reduced rates depending on their distance to the closest player."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODUpdateInterval(
+	TEXT("AI.LOD.UpdateInterval"),
+	0.25f,
+	TEXT("Time between AI LOD bucket updates, in seconds."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODMidDistance(
+	TEXT("AI.LOD.MidDistance"),
+	1500.0f,
+	TEXT("Distance to the closest player beyond which AI pawns move to the Mid bucket."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODFarDistance(
+	TEXT("AI.LOD.FarDistance"),
+	3000.0f,
+	TEXT("Distance to the closest player beyond which AI pawns move to the Far bucket."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODDormantDistance(
+	TEXT("AI.LOD.DormantDistance"),
+	6000.0f,
+	TEXT("Distance to the closest player beyond which off screen AI pawns go dormant."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODMidTickInterval(
+	TEXT("AI.LOD.MidTickInterval"),
+	0.1f,
+	TEXT("Tick interval for AI pawns in the Mid bucket, in seconds."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODFarTickInterval(
+	TEXT("AI.LOD.FarTickInterval"),
+	0.25f,
+	TEXT("Tick interval for AI pawns in the Far bucket, in seconds."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarAILODAnimUpdateRate(
+	TEXT("AI.LOD.AnimUpdateRate"),
+	true,
+	TEXT("If true, AI pawn meshes update their animation at reduced rates depending on their bucket and visibility."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAILODMidAnimUpdateRate(
+	TEXT("AI.LOD.MidAnimUpdateRate"),
+	2,
+	TEXT("Animation update rate for visible AI pawns in the Mid bucket, in frames."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAILODFarAnimUpdateRate(
+	TEXT("AI.LOD.FarAnimUpdateRate"),
+	4,
+	TEXT("Animation update rate for visible AI pawns in the Far bucket, in frames."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAILODOffscreenAnimUpdateRate(
+	TEXT("AI.LOD.OffscreenAnimUpdateRate"),
+	8,
+	TEXT("Animation update rate for AI pawns that are off screen, in frames."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAILODMaxInterpolatedAnimUpdateRate(
+	TEXT("AI.LOD.MaxInterpolatedAnimUpdateRate"),
+	2,
+	TEXT("Highest animation update rate that still interpolates between updates. Slower meshes skip interpolation."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAILODAgentTickCost(
+	TEXT("AI.LOD.AgentTickCostMs"),
+	0.05f,
+	TEXT("Game thread cost of one full rate AI pawn tick, in milliseconds. Used to estimate the time saved. Measure it with stat game and AI.LOD.Enable 0."),
+	ECVF_Default);
+
+void UPantherJamAILODSubsystem::RegisterAgent(APawn* Pawn)
+{
+	if (!IsValid(Pawn) || Agents.ContainsByPredicate([Pawn](const FPantherJamAILODAgent& Agent) { return Agent.Pawn == Pawn; }))
+	{
+		return;
+	}
+
+	FPantherJamAILODAgent& Agent = Agents.AddDefaulted_GetRef();
+	Agent.Pawn = Pawn;
+
+	// start at full rate, the next update will pick the right bucket
+	Agent.Bucket = EPantherJamAILODBucket::Near;
+
+	// let the mesh skip animation updates. The rate itself is set per bucket
+	if (ACharacter* Character = Cast<ACharacter>(Pawn))
+	{
+		if (CVarAILODAnimUpdateRate.GetValueOnGameThread())
+		{
+			Character->GetMesh()->bEnableUpdateRateOptimizations = true;
+			ApplyAnimUpdateRate(Character->GetMesh(), Agent.Bucket);
+		}
+	}
+}
+
+void UPantherJamAILODSubsystem::UnregisterAgent(APawn* Pawn)
+{
+	const int32 Index = Agents.IndexOfByPredicate([Pawn](const FPantherJamAILODAgent& Agent) { return Agent.Pawn == Pawn; });
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	// restore the full tick rate so the pawn is left the way we found it
+	if (IsValid(Pawn) && Agents[Index].Bucket != EPantherJamAILODBucket::Near)
+	{
+		ApplyBucket(Pawn, EPantherJamAILODBucket::Near);
+	}
+
+	Agents.RemoveAtSwap(Index);
+}
+
+void UPantherJamAILODSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// is it time to reevaluate the buckets?
+	TimeUntilUpdate -= DeltaTime;
+
+	if (TimeUntilUpdate <= 0.0f)
+	{
+		TimeUntilUpdate = CVarAILODUpdateInterval.GetValueOnGameThread();
+
+		UpdateBuckets();
+	}
+
+	UpdateStats(DeltaTime);
+}
+
+TStatId UPantherJamAILODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPantherJamAILODSubsystem, STATGROUP_Tickables);
+}
+
+bool UPantherJamAILODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPantherJamAILODSubsystem::UpdateBuckets()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PantherJamAILODUpdate);
+
+	FMemory::Memzero(BucketCounts);
+
+	for (int32 Index = Agents.Num() - 1; Index >= 0; --Index)
+	{
+		FPantherJamAILODAgent& Agent = Agents[Index];
+		APawn* Pawn = Agent.Pawn.Get();
+
+		// drop agents that were destroyed without unregistering
+		if (!IsValid(Pawn))
+		{
+			Agents.RemoveAtSwap(Index);
+			continue;
+		}
+
+		const EPantherJamAILODBucket NewBucket = CVarAILODEnable.GetValueOnGameThread() ? ComputeBucket(Pawn) : EPantherJamAILODBucket::Near;
+
+		// only touch the tick functions when the bucket changes
+		if (NewBucket != Agent.Bucket)
+		{
+			ApplyBucket(Pawn, NewBucket);
+			Agent.Bucket = NewBucket;
+		}
+
+		++BucketCounts[(int32)NewBucket];
+	}
+}
+
+EPantherJamAILODBucket UPantherJamAILODSubsystem::ComputeBucket(const APawn* Pawn) const
+{
+	UPantherJamPlayerSnapshotSubsystem* PlayerSnapshots = GetWorld()->GetSubsystem<UPantherJamPlayerSnapshotSubsystem>();
+
+	const FVector Location = Pawn->GetActorLocation();
+	const FPantherJamPlayerSnapshot* ClosestPlayer = PlayerSnapshots ? PlayerSnapshots->FindClosestPlayer(Location) : nullptr;
+
+	// keep full rate if there's no player to measure against
+	if (!ClosestPlayer)
+	{
+		return EPantherJamAILODBucket::Near;
+	}
+
+	const double DistanceSquared = FVector::DistSquared(Location, ClosestPlayer->Location);
+
+	if (DistanceSquared < FMath::Square(CVarAILODMidDistance.GetValueOnGameThread()))
+	{
+		return EPantherJamAILODBucket::Near;
+	}
+
+	// visible pawns never drop below the Mid bucket so their animation and movement stay smooth
+	if (Pawn->WasRecentlyRendered(0.2f))
+	{
+		return EPantherJamAILODBucket::Mid;
+	}
+
+	if (DistanceSquared < FMath::Square(CVarAILODFarDistance.GetValueOnGameThread()))
+	{
+		return EPantherJamAILODBucket::Mid;
+	}
+
+	if (DistanceSquared < FMath::Square(CVarAILODDormantDistance.GetValueOnGameThread()))
+	{
+		return EPantherJamAILODBucket::Far;
+	}
+
+	return EPantherJamAILODBucket::Dormant;
+}
+
+void UPantherJamAILODSubsystem::ApplyBucket(APawn* Pawn, EPantherJamAILODBucket Bucket)
+{
+	const bool bAwake = Bucket != EPantherJamAILODBucket::Dormant;
+	const float TickInterval = GetBucketTickInterval(Bucket);
+
+	// actor tick
+	Pawn->SetActorTickEnabled(bAwake);
+	Pawn->SetActorTickInterval(TickInterval);
+
+	// character movement and animation
+	if (ACharacter* Character = Cast<ACharacter>(Pawn))
+	{
+		Character->GetCharacterMovement()->SetComponentTickEnabled(bAwake);
+		Character->GetCharacterMovement()->SetComponentTickInterval(TickInterval);
+
+		Character->GetMesh()->SetComponentTickEnabled(bAwake);
+
+		ApplyAnimUpdateRate(Character->GetMesh(), Bucket);
+	}
+
+	// StateTree
+	if (AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+	{
+		if (UBrainComponent* BrainComponent = AIController->GetBrainComponent())
+		{
+			BrainComponent->SetComponentTickEnabled(bAwake);
+			BrainComponent->SetComponentTickInterval(TickInterval);
+		}
+	}
+}
+
+float UPantherJamAILODSubsystem::GetBucketTickInterval(EPantherJamAILODBucket Bucket)
+{
+	switch (Bucket)
+	{
+	case EPantherJamAILODBucket::Mid:
+		return CVarAILODMidTickInterval.GetValueOnGameThread();
+
+	case EPantherJamAILODBucket::Far:
+		return CVarAILODFarTickInterval.GetValueOnGameThread();
+
+	default:
+		return 0.0f;
+	}
+}
+
+void UPantherJamAILODSubsystem::ApplyAnimUpdateRate(USkeletalMeshComponent* Mesh, EPantherJamAILODBucket Bucket)
+{
+	if (!Mesh->bEnableUpdateRateOptimizations)
+	{
+		return;
+	}
+
+	const int32 NumLODs = FMath::Max(Mesh->GetNumLODs(), 1);
+
+	// the parameters are created on the mesh's first update rate tick, so set them up from there if they don't exist yet
+	if (Mesh->AnimUpdateRateParams)
+	{
+		SetAnimUpdateRateParams(Mesh->AnimUpdateRateParams, NumLODs, Bucket);
+	}
+	else
+	{
+		Mesh->OnAnimUpdateRateParamsCreated.BindStatic(&UPantherJamAILODSubsystem::SetAnimUpdateRateParams, NumLODs, Bucket);
+	}
+}
+
+void UPantherJamAILODSubsystem::SetAnimUpdateRateParams(FAnimUpdateRateParameters* Params, int32 NumLODs, EPantherJamAILODBucket Bucket)
+{
+	const int32 UpdateRate = GetBucketAnimUpdateRate(Bucket);
+
+	// drive the visible update rate from the bucket rather than from the mesh LOD or screen size
+	Params->bShouldUseLodMap = true;
+	Params->LODToFrameSkipMap.Reset();
+
+	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
+	{
+		Params->LODToFrameSkipMap.Add(LODIndex, UpdateRate - 1);
+	}
+
+	// off screen meshes drop further, and only meshes updating often enough are interpolated
+	Params->BaseNonRenderedUpdateRate = FMath::Max(CVarAILODOffscreenAnimUpdateRate.GetValueOnGameThread(), 1);
+	Params->MaxEvalRateForInterpolation = CVarAILODMaxInterpolatedAnimUpdateRate.GetValueOnGameThread();
+}
+
+int32 UPantherJamAILODSubsystem::GetBucketAnimUpdateRate(EPantherJamAILODBucket Bucket)
+{
+	if (!CVarAILODAnimUpdateRate.GetValueOnGameThread())
+	{
+		return 1;
+	}
+
+	switch (Bucket)
+	{
+	case EPantherJamAILODBucket::Mid:
+		return FMath::Max(CVarAILODMidAnimUpdateRate.GetValueOnGameThread(), 1);
+
+	case EPantherJamAILODBucket::Far:
+	case EPantherJamAILODBucket::Dormant:
+		return FMath::Max(CVarAILODFarAnimUpdateRate.GetValueOnGameThread(), 1);
+
+	default:
+		return 1;
+	}
+}
+
+void UPantherJamAILODSubsystem::UpdateStats(float DeltaTime) const
+{
+	// estimate how many full rate agent ticks we skipped this frame
+	float SkippedTicks = BucketCounts[(int32)EPantherJamAILODBucket::Dormant];
+
+	for (const EPantherJamAILODBucket Bucket : { EPantherJamAILODBucket::Mid, EPantherJamAILODBucket::Far })
+	{
+		const float TickInterval = GetBucketTickInterval(Bucket);
+
+		if (TickInterval > DeltaTime)
+		{
+			SkippedTicks += BucketCounts[(int32)Bucket] * (1.0f - DeltaTime / TickInterval);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PantherJamAILODNear, BucketCounts[(int32)EPantherJamAILODBucket::Near]);
+	SET_DWORD_STAT(STAT_PantherJamAILODMid, BucketCounts[(int32)EPantherJamAILODBucket::Mid]);
+	SET_DWORD_STAT(STAT_PantherJamAILODFar, BucketCounts[(int32)EPantherJamAILODBucket::Far]);
+	SET_DWORD_STAT(STAT_PantherJamAILODDormant, BucketCounts[(int32)EPantherJamAILODBucket::Dormant]);
+	SET_FLOAT_STAT(STAT_PantherJamAILODSkippedTicks, SkippedTicks);
+	SET_FLOAT_STAT(STAT_PantherJamAILODTimeSaved, SkippedTicks * CVarAILODAgentTickCost.GetValueOnGameThread());
+}
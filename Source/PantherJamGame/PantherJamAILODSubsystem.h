@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PantherJamAILODSubsystem.generated.h"
+
+class APawn;
+class USkeletalMeshComponent;
+struct FAnimUpdateRateParameters;
+
+/**
+ *  Tick LOD buckets for AI agents, from full rate to fully dormant
+ */
+enum class EPantherJamAILODBucket : uint8
+{
+	Near,
+	Mid,
+	Far,
+	Dormant,
+	Num
+};
+
+/**
+ *  A single AI agent tracked by the LOD subsystem
+ */
+struct FPantherJamAILODAgent
+{
+	/** The AI pawn */
+	TWeakObjectPtr<APawn> Pawn;
+
+	/** Bucket currently applied to the pawn */
+	EPantherJamAILODBucket Bucket = EPantherJamAILODBucket::Near;
+};
+
+/**
+ *  Buckets registered AI pawns by distance to the closest player and by visibility,
+ *  then lowers the tick rate of the pawn, its CharacterMovement and its controller's StateTree for far buckets.
+ *  Character meshes also get an animation update rate per bucket through update rate optimizations,
+ *  with interpolation between updates only where the update rate is low enough to look smooth,
+ *  and a lower rate still while off screen.
+ *  Agents out of range and off screen go fully dormant until a player comes near.
+ *  Bucket counts and the estimated game thread time saved are reported under "stat PantherJamAILOD"
+ */
+UCLASS()
+class UPantherJamAILODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Registered agents */
+	TArray<FPantherJamAILODAgent> Agents;
+
+	/** Time left until the buckets are reevaluated */
+	float TimeUntilUpdate = 0.0f;
+
+	/** Number of agents in each bucket after the last update */
+	int32 BucketCounts[(int32)EPantherJamAILODBucket::Num] = {};
+
+public:
+
+	/** Starts managing the tick rate of the given AI pawn */
+	void RegisterAgent(APawn* Pawn);
+
+	/** Stops managing the given AI pawn and restores its full tick rate */
+	void UnregisterAgent(APawn* Pawn);
+
+	/** Returns the number of agents in the given bucket */
+	int32 GetBucketCount(EPantherJamAILODBucket Bucket) const { return BucketCounts[(int32)Bucket]; }
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Reevaluates the bucket for every agent */
+	void UpdateBuckets();
+
+	/** Picks the bucket for the given pawn */
+	EPantherJamAILODBucket ComputeBucket(const APawn* Pawn) const;
+
+	/** Applies the tick settings for a bucket to the pawn, its movement and its StateTree */
+	static void ApplyBucket(APawn* Pawn, EPantherJamAILODBucket Bucket);
+
+	/** Returns the tick interval for the given bucket */
+	static float GetBucketTickInterval(EPantherJamAILODBucket Bucket);
+
+	/** Applies the animation update rate for a bucket to the mesh, now or as soon as its update rate parameters are created */
+	static void ApplyAnimUpdateRate(USkeletalMeshComponent* Mesh, EPantherJamAILODBucket Bucket);
+
+	/** Writes the animation update rate for a bucket into a mesh's update rate parameters */
+	static void SetAnimUpdateRateParams(FAnimUpdateRateParameters* Params, int32 NumLODs, EPantherJamAILODBucket Bucket);
+
+	/** Returns the visible animation update rate for the given bucket, in frames */
+	static int32 GetBucketAnimUpdateRate(EPantherJamAILODBucket Bucket);
+
+	/** Updates the LOD stats */
+	void UpdateStats(float DeltaTime) const;
+};
@@ -0,0 +1,961 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamBenchmarkGameMode.h"
+#include "PantherJamMovementSimCommandlet.h"
+#include "PantherJamGameCharacter.h"
+#include "PantherJamWallProbeComponent.h"
+#include "CombatCharacter.h"
+#include "CombatLifeBarSubsystem.h"
+#include "PlatformingCharacter.h"
+#include "SideScrollingCharacter.h"
+#include "SideScrollingPickup.h"
+#include "SideScrollingPickupFieldSubsystem.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Framework/Application/SlateApplication.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPantherJamBenchmark, Log, All);
+
+/** Half extent of the square arena floor */
+static constexpr float BenchmarkArenaHalfSize = 4000.0f;
+
+/** Corridor dimensions, matching the headless movement simulation */
+static constexpr float BenchmarkCorridorLength = 3000.0f;
+static constexpr float BenchmarkCorridorHalfWidth = 150.0f;
+static constexpr float BenchmarkCorridorWallHeight = 600.0f;
+
+/** Length of one loop of the scripted input */
+static constexpr float BenchmarkScriptLoopTime = 8.0f;
+
+void FPantherJamBenchmarkTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->MarkTime(Marker);
+	}
+}
+
+FString FPantherJamBenchmarkTickFunction::DiagnosticMessage()
+{
+	switch (Marker)
+	{
+	case EPantherJamBenchmarkMarker::PhysicsStart:
+		return TEXT("PantherJamBenchmark[StartPhysics]");
+
+	case EPantherJamBenchmarkMarker::PhysicsEnd:
+		return TEXT("PantherJamBenchmark[EndPhysics]");
+
+	case EPantherJamBenchmarkMarker::AnimStart:
+		return TEXT("PantherJamBenchmark[StartAnim]");
+
+	default:
+		return TEXT("PantherJamBenchmark[EndAnim]");
+	}
+}
+
+APantherJamBenchmarkGameMode::APantherJamBenchmarkGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// point to the real gameplay classes from each variant
+	CombatCharacterClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/Variant_Combat/Blueprints/BP_CombatCharacter.BP_CombatCharacter_C")));
+	EnemySpawnerClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/Variant_Combat/Blueprints/AI/BP_CombatEnemySpawner.BP_CombatEnemySpawner_C")));
+	DamageableBoxClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/Variant_Combat/Blueprints/Interactables/BP_CombatDamageableBox.BP_CombatDamageableBox_C")));
+	WallRunCharacterClass = TSoftClassPtr<ACharacter>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C")));
+	PlatformingCharacterClass = TSoftClassPtr<ACharacter>(FSoftObjectPath(TEXT("/Game/Variant_Platforming/Blueprints/BP_PlatformingCharacter.BP_PlatformingCharacter_C")));
+	SideScrollingCharacterClass = TSoftClassPtr<ACharacter>(FSoftObjectPath(TEXT("/Game/Variant_SideScrolling/Blueprints/BP_SideScrollingCharacter.BP_SideScrollingCharacter_C")));
+	CombatEnemyClass = TSoftClassPtr<ACharacter>(FSoftObjectPath(TEXT("/Game/Variant_Combat/Blueprints/AI/BP_CombatEnemy.BP_CombatEnemy_C")));
+	SideScrollingPickupClass = TSoftClassPtr<ASideScrollingPickup>(FSoftObjectPath(TEXT("/Game/Variant_SideScrolling/Blueprints/Items/BP_SideScrollingPickup.BP_SideScrollingPickup_C")));
+
+	// the tick functions are registered in BeginPlay, and chained to the world's physics tick functions there
+	PhysicsStartTickFunction.bCanEverTick = true;
+	PhysicsStartTickFunction.TickGroup = TG_StartPhysics;
+	PhysicsStartTickFunction.Marker = EPantherJamBenchmarkMarker::PhysicsStart;
+
+	PhysicsEndTickFunction.bCanEverTick = true;
+	PhysicsEndTickFunction.TickGroup = TG_EndPhysics;
+	PhysicsEndTickFunction.Marker = EPantherJamBenchmarkMarker::PhysicsEnd;
+
+	// the crowd meshes update in the pre physics group, the animation markers are chained to them as they spawn
+	AnimStartTickFunction.bCanEverTick = true;
+	AnimStartTickFunction.TickGroup = TG_PrePhysics;
+	AnimStartTickFunction.Marker = EPantherJamBenchmarkMarker::AnimStart;
+
+	AnimEndTickFunction.bCanEverTick = true;
+	AnimEndTickFunction.TickGroup = TG_PrePhysics;
+	AnimEndTickFunction.Marker = EPantherJamBenchmarkMarker::AnimEnd;
+}
+
+void APantherJamBenchmarkGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	// the player fights the enemy waves with the combat character
+	if (UClass* PlayerClass = CombatCharacterClass.LoadSynchronous())
+	{
+		DefaultPawnClass = PlayerClass;
+	}
+
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// command line overrides
+	FParse::Value(FCommandLine::Get(), TEXT("PerfDuration="), RecordTime);
+	FParse::Value(FCommandLine::Get(), TEXT("PerfTolerance="), RegressionTolerance);
+	FParse::Value(FCommandLine::Get(), TEXT("PerfSoakBots="), SoakBotCount);
+	FParse::Value(FCommandLine::Get(), TEXT("PerfPickups="), PickupCount);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("PerfPickupActors")))
+	{
+		bPickupActors = true;
+	}
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("PerfAsyncWallProbe")))
+	{
+		bAsyncWallProbe = true;
+	}
+
+	FString AnimCrowdOption;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("PerfAnimCrowd="), AnimCrowdOption, false))
+	{
+		TArray<FString> Counts;
+		AnimCrowdOption.ParseIntoArray(Counts, TEXT(","));
+
+		AnimCrowdCounts.Reset();
+
+		for (const FString& Count : Counts)
+		{
+			AnimCrowdCounts.Add(FMath::Max(FCString::Atoi(*Count), 0));
+		}
+	}
+
+	BuildStressLevel();
+}
+
+AActor* APantherJamBenchmarkGameMode::ChoosePlayerStart_Implementation(AController* Player)
+{
+	return ArenaStart ? ArenaStart.Get() : Super::ChoosePlayerStart_Implementation(Player);
+}
+
+void APantherJamBenchmarkGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// corridor bots wall run along the corridors behind the arena
+	if (UClass* WallRunClass = WallRunCharacterClass.LoadSynchronous())
+	{
+		for (int32 Index = 0; Index < CorridorCount; ++Index)
+		{
+			const FVector Start(-BenchmarkArenaHalfSize + 100.0f, BenchmarkArenaHalfSize + 500.0f + Index * 600.0f, 100.0f);
+			SpawnBot(WallRunClass, FTransform(Start), Index * 0.5f);
+		}
+	}
+
+	// platforming bots run, jump and dash around one side of the arena
+	if (UClass* PlatformingClass = PlatformingCharacterClass.LoadSynchronous())
+	{
+		for (int32 Index = 0; Index < PlatformingBotCount; ++Index)
+		{
+			const FVector Start(-BenchmarkArenaHalfSize * 0.75f, -BenchmarkArenaHalfSize * 0.5f + Index * 400.0f, 100.0f);
+			SpawnBot(PlatformingClass, FTransform(Start), Index * 0.7f);
+		}
+	}
+
+	// side scrolling bots pace back and forth on the other side
+	if (UClass* SideScrollingClass = SideScrollingCharacterClass.LoadSynchronous())
+	{
+		for (int32 Index = 0; Index < SideScrollingBotCount; ++Index)
+		{
+			const FVector Start(BenchmarkArenaHalfSize * 0.75f, -BenchmarkArenaHalfSize * 0.5f + Index * 400.0f, 100.0f);
+			SpawnBot(SideScrollingClass, FTransform(Start), Index * 0.3f);
+		}
+	}
+
+	// soak bots fight in a ring around the arena center. They're server side only, with no net connections
+	MemoryBeforeSoak = FPlatformMemory::GetStats().UsedPhysical;
+
+	if (SoakBotCount > 0)
+	{
+		if (UClass* SoakClass = CombatCharacterClass.LoadSynchronous())
+		{
+			for (int32 Index = 0; Index < SoakBotCount; ++Index)
+			{
+				const float Angle = 2.0f * PI * Index / SoakBotCount;
+				const FVector Start(FMath::Cos(Angle) * EnemySpawnerRadius * 0.3f, FMath::Sin(Angle) * EnemySpawnerRadius * 0.3f, 100.0f);
+				SpawnBot(SoakClass, FTransform(Start), Index * 0.1f);
+			}
+		}
+	}
+
+	MemoryAfterSoak = FPlatformMemory::GetStats().UsedPhysical;
+
+	if (PickupCount > 0)
+	{
+		SpawnPickups();
+	}
+
+	// hook up the timers
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &APantherJamBenchmarkGameMode::OnWorldPreActorTick);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &APantherJamBenchmarkGameMode::OnWorldPostActorTick);
+
+	PhysicsStartTickFunction.Target = this;
+	PhysicsStartTickFunction.RegisterTickFunction(GetLevel());
+
+	PhysicsEndTickFunction.Target = this;
+	PhysicsEndTickFunction.RegisterTickFunction(GetLevel());
+
+	// sharing a tick group doesn't order us against the physics step, so bracket it with prerequisites
+	UWorld* World = GetWorld();
+	World->StartPhysicsTickFunction.AddPrerequisite(this, PhysicsStartTickFunction);
+	PhysicsEndTickFunction.AddPrerequisite(World, World->EndPhysicsTickFunction);
+
+	AnimStartTickFunction.Target = this;
+	AnimStartTickFunction.RegisterTickFunction(GetLevel());
+
+	AnimEndTickFunction.Target = this;
+	AnimEndTickFunction.RegisterTickFunction(GetLevel());
+
+	// time Slate too, since that's where the crowd's life bars are drawn
+	if (FSlateApplication::IsInitialized())
+	{
+		SlatePreTickHandle = FSlateApplication::Get().OnPreTick().AddUObject(this, &APantherJamBenchmarkGameMode::OnSlatePreTick);
+		SlatePostTickHandle = FSlateApplication::Get().OnPostTick().AddUObject(this, &APantherJamBenchmarkGameMode::OnSlatePostTick);
+	}
+
+	AnimCrowdTimes.SetNum(AnimCrowdCounts.Num());
+	AnimCrowdSlateTimes.SetNum(AnimCrowdCounts.Num());
+	AnimCrowdLifeBarWidgets.SetNumZeroed(AnimCrowdCounts.Num());
+	AnimCrowdMemoryPerEnemyKB.SetNumZeroed(AnimCrowdCounts.Num());
+
+	// reserve for a 60 fps run so we don't reallocate while recording
+	const int32 ExpectedFrames = FMath::CeilToInt32(RecordTime * 60.0f);
+	FrameTimes.Reserve(ExpectedFrames);
+	GameThreadTimes.Reserve(ExpectedFrames);
+	PhysicsTimes.Reserve(ExpectedFrames);
+
+	LastFrameStartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogPantherJamBenchmark, Display, TEXT("Benchmark started: %d bots, %.0fs warmup, %.0fs recording"), Bots.Num(), WarmupTime, RecordTime);
+}
+
+void APantherJamBenchmarkGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	GetWorld()->StartPhysicsTickFunction.RemovePrerequisite(this, PhysicsStartTickFunction);
+
+	PhysicsStartTickFunction.UnRegisterTickFunction();
+	PhysicsEndTickFunction.UnRegisterTickFunction();
+	AnimStartTickFunction.UnRegisterTickFunction();
+	AnimEndTickFunction.UnRegisterTickFunction();
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPreTick().Remove(SlatePreTickHandle);
+		FSlateApplication::Get().OnPostTick().Remove(SlatePostTickHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APantherJamBenchmarkGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (bFinished)
+	{
+		return;
+	}
+
+	const bool bWasWarmingUp = ElapsedTime <= WarmupTime;
+
+	ElapsedTime += DeltaSeconds;
+
+	// only count wall probes made while recording
+	if (bWasWarmingUp && ElapsedTime > WarmupTime)
+	{
+		ResetWallProbeCounters();
+	}
+
+	UpdateAnimCrowd();
+
+	DrivePlayer();
+
+	for (FPantherJamBenchmarkBot& Bot : Bots)
+	{
+		DriveBot(Bot);
+	}
+
+	// record the wall clock time between game mode ticks as the frame time
+	const double Now = FPlatformTime::Seconds();
+
+	if (ElapsedTime > WarmupTime)
+	{
+		FrameTimes.Add(float((Now - LastFrameStartTime) * 1000.0));
+	}
+
+	LastFrameStartTime = Now;
+
+	// are we done?
+	if (ElapsedTime > WarmupTime + RecordTime)
+	{
+		FinishBenchmark();
+	}
+}
+
+void APantherJamBenchmarkGameMode::MarkTime(EPantherJamBenchmarkMarker Marker)
+{
+	switch (Marker)
+	{
+	case EPantherJamBenchmarkMarker::PhysicsStart:
+
+		PhysicsStartTime = FPlatformTime::Seconds();
+		break;
+
+	case EPantherJamBenchmarkMarker::PhysicsEnd:
+
+		if (PhysicsStartTime > 0.0 && ElapsedTime > WarmupTime && !bFinished)
+		{
+			PhysicsTimes.Add(float((FPlatformTime::Seconds() - PhysicsStartTime) * 1000.0));
+		}
+		break;
+
+	case EPantherJamBenchmarkMarker::AnimStart:
+
+		AnimStartTime = FPlatformTime::Seconds();
+		break;
+
+	case EPantherJamBenchmarkMarker::AnimEnd:
+
+		// only record once the current crowd step has settled
+		if (AnimStartTime > 0.0 && IsAnimCrowdSettled())
+		{
+			AnimCrowdTimes[AnimCrowdStep].Add(float((FPlatformTime::Seconds() - AnimStartTime) * 1000.0));
+		}
+
+		AnimStartTime = 0.0;
+		break;
+	}
+}
+
+void APantherJamBenchmarkGameMode::BuildStressLevel()
+{
+	UWorld* World = GetWorld();
+
+	// floor, with its top surface at Z = 0, extended to fit the corridors
+	const float CorridorAreaDepth = CorridorCount * 600.0f + 500.0f;
+	SpawnBlock(FVector(0.0f, CorridorAreaDepth * 0.5f, -50.0f), FVector(BenchmarkArenaHalfSize * 2.0f, BenchmarkArenaHalfSize * 2.0f + CorridorAreaDepth, 100.0f));
+
+	// player start at the arena center
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ArenaStart = World->SpawnActor<APlayerStart>(FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator, SpawnParams);
+
+	// ring of enemy spawners around the player, so the waves converge on them
+	if (UClass* SpawnerClass = EnemySpawnerClass.LoadSynchronous())
+	{
+		for (int32 Index = 0; Index < EnemySpawnerCount; ++Index)
+		{
+			const float Angle = 2.0f * PI * Index / FMath::Max(EnemySpawnerCount, 1);
+			const FVector Location(FMath::Cos(Angle) * EnemySpawnerRadius, FMath::Sin(Angle) * EnemySpawnerRadius, 100.0f);
+			const FRotator Rotation = (-Location).Rotation();
+
+			World->SpawnActor<AActor>(SpawnerClass, Location, FRotator(0.0f, Rotation.Yaw, 0.0f), SpawnParams);
+		}
+	}
+
+	// stacked piles of physics boxes between the spawners and the player
+	if (UClass* BoxClass = DamageableBoxClass.LoadSynchronous())
+	{
+		const float BoxSpacing = 110.0f;
+
+		for (int32 PileIndex = 0; PileIndex < BoxPileCount; ++PileIndex)
+		{
+			const float Angle = 2.0f * PI * (PileIndex + 0.5f) / FMath::Max(BoxPileCount, 1);
+			const FVector PileCenter(FMath::Cos(Angle) * EnemySpawnerRadius * 0.5f, FMath::Sin(Angle) * EnemySpawnerRadius * 0.5f, 0.0f);
+
+			for (int32 X = 0; X < BoxPileSize; ++X)
+			{
+				for (int32 Y = 0; Y < BoxPileSize; ++Y)
+				{
+					for (int32 Z = 0; Z < BoxPileSize; ++Z)
+					{
+						const FVector Offset((X - BoxPileSize * 0.5f) * BoxSpacing, (Y - BoxPileSize * 0.5f) * BoxSpacing, 60.0f + Z * BoxSpacing);
+						World->SpawnActor<AActor>(BoxClass, PileCenter + Offset, FRotator::ZeroRotator, SpawnParams);
+					}
+				}
+			}
+		}
+	}
+
+	// wall run corridors behind the arena
+	for (int32 Index = 0; Index < CorridorCount; ++Index)
+	{
+		const float CorridorY = BenchmarkArenaHalfSize + 500.0f + Index * 600.0f;
+		const float CorridorX = -BenchmarkArenaHalfSize + BenchmarkCorridorLength * 0.5f;
+
+		SpawnBlock(FVector(CorridorX, CorridorY - BenchmarkCorridorHalfWidth - 50.0f, BenchmarkCorridorWallHeight * 0.5f), FVector(BenchmarkCorridorLength, 100.0f, BenchmarkCorridorWallHeight));
+		SpawnBlock(FVector(CorridorX, CorridorY + BenchmarkCorridorHalfWidth + 50.0f, BenchmarkCorridorWallHeight * 0.5f), FVector(BenchmarkCorridorLength, 100.0f, BenchmarkCorridorWallHeight));
+	}
+}
+
+void APantherJamBenchmarkGameMode::SpawnBlock(const FVector& Center, const FVector& Size)
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	check(CubeMesh);
+
+	// the basic cube is 100 units to a side, centered on its origin
+	AStaticMeshActor* Block = GetWorld()->SpawnActor<AStaticMeshActor>(Center, FRotator::ZeroRotator);
+	Block->SetMobility(EComponentMobility::Movable);
+	Block->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Block->SetActorScale3D(Size / 100.0f);
+}
+
+void APantherJamBenchmarkGameMode::SpawnPickups()
+{
+	UClass* PickupClass = SideScrollingPickupClass.LoadSynchronous();
+
+	if (!PickupClass)
+	{
+		return;
+	}
+
+	MemoryBeforePickups = FPlatformMemory::GetStats().UsedPhysical;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// lay the pickups out in a grid over the arena floor
+	const int32 GridSize = FMath::CeilToInt32(FMath::Sqrt(float(PickupCount)));
+	const float Spacing = BenchmarkArenaHalfSize * 2.0f / GridSize;
+
+	for (int32 Index = 0; Index < PickupCount; ++Index)
+	{
+		const FVector Location(
+			-BenchmarkArenaHalfSize + (Index % GridSize + 0.5f) * Spacing,
+			-BenchmarkArenaHalfSize + (Index / GridSize + 0.5f) * Spacing,
+			100.0f);
+
+		const FTransform Transform(Location);
+
+		// spawned during our BeginPlay, so the pickups move into the field as they finish spawning
+		if (ASideScrollingPickup* Pickup = GetWorld()->SpawnActorDeferred<ASideScrollingPickup>(PickupClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
+		{
+			Pickup->SetAddToPickupField(!bPickupActors);
+			Pickup->FinishSpawning(Transform);
+		}
+	}
+
+	PickupSetupTime = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	MemoryAfterPickups = FPlatformMemory::GetStats().UsedPhysical;
+
+	if (const USideScrollingPickupFieldSubsystem* PickupField = GetWorld()->GetSubsystem<USideScrollingPickupFieldSubsystem>())
+	{
+		PickupFieldCount = PickupField->GetNumRemaining();
+	}
+}
+
+void APantherJamBenchmarkGameMode::SpawnBot(TSubclassOf<ACharacter> CharacterClass, const FTransform& Transform, float TimeOffset)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	ACharacter* Character = GetWorld()->SpawnActor<ACharacter>(CharacterClass, Transform, SpawnParams);
+	APantherJamSimController* Controller = GetWorld()->SpawnActor<APantherJamSimController>();
+
+	if (!Character || !Controller)
+	{
+		return;
+	}
+
+	Controller->Possess(Character);
+
+	if (APantherJamGameCharacter* WallRunner = Cast<APantherJamGameCharacter>(Character))
+	{
+		WallRunner->GetWallProbe()->SetUseAsyncProbe(bAsyncWallProbe);
+	}
+
+	FPantherJamBenchmarkBot& Bot = Bots.AddDefaulted_GetRef();
+	Bot.Character = Character;
+	Bot.TimeOffset = TimeOffset;
+}
+
+void APantherJamBenchmarkGameMode::UpdateAnimCrowd()
+{
+	if (AnimCrowdCounts.IsEmpty() || ElapsedTime <= WarmupTime)
+	{
+		return;
+	}
+
+	// steps are spread evenly over the record time
+	const float StepTime = RecordTime / AnimCrowdCounts.Num();
+	const int32 Step = FMath::Min(FMath::FloorToInt32((ElapsedTime - WarmupTime) / StepTime), AnimCrowdCounts.Num() - 1);
+
+	if (Step == AnimCrowdStep)
+	{
+		return;
+	}
+
+	AnimCrowdStep = Step;
+	AnimCrowdStepStartTime = ElapsedTime;
+
+	if (AnimCrowd.IsEmpty())
+	{
+		MemoryBeforeAnimCrowd = FPlatformMemory::GetStats().UsedPhysical;
+	}
+
+	// grow the crowd to this step's count
+	while (AnimCrowd.Num() < AnimCrowdCounts[Step])
+	{
+		SpawnAnimCrowdEnemy(AnimCrowd.Num());
+	}
+
+	// measure the crowd's footprint, life bar widgets included
+	if (!AnimCrowd.IsEmpty())
+	{
+		AnimCrowdMemoryPerEnemyKB[Step] = float(double(int64(FPlatformMemory::GetStats().UsedPhysical) - int64(MemoryBeforeAnimCrowd)) / 1024.0 / AnimCrowd.Num());
+	}
+
+	UE_LOG(LogPantherJamBenchmark, Display, TEXT("Animation crowd step %d: %d enemies"), Step, AnimCrowdCounts[Step]);
+}
+
+void APantherJamBenchmarkGameMode::SpawnAnimCrowdEnemy(int32 Index)
+{
+	UClass* EnemyClass = CombatEnemyClass.LoadSynchronous();
+
+	if (!EnemyClass)
+	{
+		// count the slot anyway so we don't retry every frame
+		AnimCrowd.Add(nullptr);
+		return;
+	}
+
+	// spiral out from near the player to past the AI LOD dormant distance, so every LOD bucket is covered
+	const float Angle = Index * 2.39996f;
+	const float Distance = 800.0f + (Index % 8) * 700.0f;
+	const FVector Location(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 100.0f);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	ACharacter* Enemy = GetWorld()->SpawnActor<ACharacter>(EnemyClass, Location, FRotator(0.0f, FMath::RadiansToDegrees(Angle) + 180.0f, 0.0f), SpawnParams);
+	AnimCrowd.Add(Enemy);
+
+	if (!Enemy)
+	{
+		return;
+	}
+
+	// bracket the mesh update with the animation markers. The start waits for the movement so it isn't counted
+	USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	UCharacterMovementComponent* Movement = Enemy->GetCharacterMovement();
+
+	AnimStartTickFunction.AddPrerequisite(Movement, Movement->PrimaryComponentTick);
+	Mesh->PrimaryComponentTick.AddPrerequisite(this, AnimStartTickFunction);
+	AnimEndTickFunction.AddPrerequisite(Mesh, Mesh->PrimaryComponentTick);
+}
+
+void APantherJamBenchmarkGameMode::ResetWallProbeCounters()
+{
+	for (const FPantherJamBenchmarkBot& Bot : Bots)
+	{
+		if (APantherJamGameCharacter* WallRunner = Cast<APantherJamGameCharacter>(Bot.Character.Get()))
+		{
+			WallRunner->GetWallProbe()->ResetCounters();
+		}
+	}
+}
+
+void APantherJamBenchmarkGameMode::DrivePlayer()
+{
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	// restart the player if the enemy waves got them
+	ACombatCharacter* Player = Cast<ACombatCharacter>(PlayerController->GetPawn());
+
+	if (!Player)
+	{
+		if (!PlayerController->GetPawn())
+		{
+			RestartPlayer(PlayerController);
+		}
+
+		return;
+	}
+
+	const float ScriptTime = FMath::Fmod(ElapsedTime, BenchmarkScriptLoopTime);
+
+	// feed the input through the same handlers as the input bindings
+	IPantherJamInputReplayable* Input = Player;
+
+	// strafe in a slow circle while turning the camera
+	Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(FMath::Sin(ScriptTime), 0.5f));
+	Input->ReplayInput(EPantherJamInputAction::Look, FVector2f(0.5f, 0.0f));
+
+	// mash the combo attack for most of the loop, then hold a charged attack until the loop restarts
+	const bool bComboPhase = ScriptTime < BenchmarkScriptLoopTime * 0.75f;
+	const bool bComboHeld = bComboPhase && FMath::Fmod(ScriptTime, 0.4f) < 0.2f;
+	const bool bChargedHeld = !bComboPhase;
+
+	if (bComboHeld != bPlayerComboHeld)
+	{
+		Input->ReplayInput(bComboHeld ? EPantherJamInputAction::ComboAttackStart : EPantherJamInputAction::ComboAttackEnd, FVector2f::ZeroVector);
+		bPlayerComboHeld = bComboHeld;
+	}
+
+	if (bChargedHeld != bPlayerChargedHeld)
+	{
+		Input->ReplayInput(bChargedHeld ? EPantherJamInputAction::ChargedAttackStart : EPantherJamInputAction::ChargedAttackEnd, FVector2f::ZeroVector);
+		bPlayerChargedHeld = bChargedHeld;
+	}
+}
+
+void APantherJamBenchmarkGameMode::DriveBot(FPantherJamBenchmarkBot& Bot)
+{
+	ACharacter* Character = Bot.Character.Get();
+
+	// feed the input through the same handlers as the input bindings
+	IPantherJamInputReplayable* Input = Cast<IPantherJamInputReplayable>(Character);
+
+	if (!Character || !Input)
+	{
+		return;
+	}
+
+	const float ScriptTime = FMath::Fmod(ElapsedTime + Bot.TimeOffset, BenchmarkScriptLoopTime);
+	const bool bFirstHalf = ScriptTime < BenchmarkScriptLoopTime * 0.5f;
+
+	// jump once a second, holding it for a moment to reach full height
+	const bool bJumpHeld = FMath::Fmod(ScriptTime, 1.0f) < 0.3f;
+
+	if (Character->IsA<ACombatCharacter>())
+	{
+		// wander in a circle, attacking every other second
+		Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(FMath::Sin(ScriptTime), 0.5f));
+		Input->ReplayInput(EPantherJamInputAction::Look, FVector2f(0.5f, 0.0f));
+
+		const bool bAttackHeld = FMath::Fmod(ScriptTime, 2.0f) < 0.2f;
+
+		if (bAttackHeld != Bot.bActionHeld)
+		{
+			Input->ReplayInput(bAttackHeld ? EPantherJamInputAction::ComboAttackStart : EPantherJamInputAction::ComboAttackEnd, FVector2f::ZeroVector);
+		}
+
+		Bot.bActionHeld = bAttackHeld;
+		return;
+	}
+
+	if (Character->IsA<APantherJamGameCharacter>())
+	{
+		// run down the corridor and back, jumping into the walls to start wall runs
+		if (AController* Controller = Character->GetController())
+		{
+			Controller->SetControlRotation(FRotator(0.0f, bFirstHalf ? 0.0f : 180.0f, 0.0f));
+		}
+
+		Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(FMath::Sin(ScriptTime * 2.0f), 1.0f));
+
+		if (bJumpHeld != Bot.bActionHeld)
+		{
+			Input->ReplayInput(bJumpHeld ? EPantherJamInputAction::JumpStart : EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+		}
+	}
+	else if (Character->IsA<APlatformingCharacter>())
+	{
+		// run in circles, jumping and dashing
+		if (AController* Controller = Character->GetController())
+		{
+			Controller->SetControlRotation(FRotator(0.0f, ScriptTime * 45.0f, 0.0f));
+		}
+
+		Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(0.0f, 1.0f));
+
+		if (bJumpHeld != Bot.bActionHeld)
+		{
+			Input->ReplayInput(bJumpHeld ? EPantherJamInputAction::JumpStart : EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+
+			// dash on the way up every other second
+			if (bJumpHeld && FMath::Fmod(ScriptTime, 2.0f) < 1.0f)
+			{
+				Input->ReplayInput(EPantherJamInputAction::Dash, FVector2f::ZeroVector);
+			}
+		}
+	}
+	else if (Character->IsA<ASideScrollingCharacter>())
+	{
+		// pace back and forth, jumping and interacting
+		Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(bFirstHalf ? 1.0f : -1.0f, 0.0f));
+
+		if (bJumpHeld != Bot.bActionHeld)
+		{
+			Input->ReplayInput(bJumpHeld ? EPantherJamInputAction::JumpStart : EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+
+			if (bJumpHeld)
+			{
+				Input->ReplayInput(EPantherJamInputAction::Interact, FVector2f::ZeroVector);
+			}
+		}
+	}
+
+	Bot.bActionHeld = bJumpHeld;
+}
+
+bool APantherJamBenchmarkGameMode::IsAnimCrowdSettled() const
+{
+	return AnimCrowdTimes.IsValidIndex(AnimCrowdStep) && ElapsedTime - AnimCrowdStepStartTime > AnimCrowdSettleTime && !bFinished;
+}
+
+void APantherJamBenchmarkGameMode::OnSlatePreTick(float DeltaTime)
+{
+	SlateStartTime = FPlatformTime::Seconds();
+}
+
+void APantherJamBenchmarkGameMode::OnSlatePostTick(float DeltaTime)
+{
+	if (SlateStartTime <= 0.0 || !IsAnimCrowdSettled())
+	{
+		return;
+	}
+
+	AnimCrowdSlateTimes[AnimCrowdStep].Add(float((FPlatformTime::Seconds() - SlateStartTime) * 1000.0));
+
+	// the shared life bar layer is only created once there's something to draw
+	if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+	{
+		AnimCrowdLifeBarWidgets[AnimCrowdStep] = FMath::Max(AnimCrowdLifeBarWidgets[AnimCrowdStep], LifeBars->GetNumWidgets());
+	}
+}
+
+void APantherJamBenchmarkGameMode::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		WorldTickStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void APantherJamBenchmarkGameMode::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && ElapsedTime > WarmupTime && !bFinished)
+	{
+		GameThreadTimes.Add(float((FPlatformTime::Seconds() - WorldTickStartTime) * 1000.0));
+	}
+}
+
+void APantherJamBenchmarkGameMode::FinishBenchmark()
+{
+	bFinished = true;
+
+	struct FMetric
+	{
+		const TCHAR* Name;
+		const TArray<float>* Samples;
+	};
+
+	const FMetric Metrics[] = {
+		{ TEXT("frame_ms"), &FrameTimes },
+		{ TEXT("game_thread_ms"), &GameThreadTimes },
+		{ TEXT("physics_ms"), &PhysicsTimes }
+	};
+
+	const float Percentiles[] = { 0.5f, 0.95f, 0.99f };
+	const TCHAR* PercentileNames[] = { TEXT("p50"), TEXT("p95"), TEXT("p99") };
+
+	// compute the results and write them out as JSON
+	TMap<FString, float> Results;
+
+	FString Json = FString::Printf(TEXT("{\n\t\"map\": \"%s\",\n\t\"duration_s\": %.1f,\n\t\"frames\": %d,\n\t\"bots\": %d"),
+		*GetWorld()->GetMapName(), RecordTime, FrameTimes.Num(), Bots.Num());
+
+	// memory cost of the soak bots, measured from their spawn
+	if (SoakBotCount > 0)
+	{
+		const double MemoryPerBotKB = double(int64(MemoryAfterSoak) - int64(MemoryBeforeSoak)) / 1024.0 / SoakBotCount;
+
+		Json += FString::Printf(TEXT(",\n\t\"soak_bots\": %d,\n\t\"used_physical_mb\": %.1f,\n\t\"memory_per_soak_bot_kb\": %.1f"),
+			SoakBotCount, FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0), MemoryPerBotKB);
+	}
+
+	// wall probe cache use by the wall run bots, to compare against -PerfAsyncWallProbe runs
+	int32 WallProbeHits = 0;
+	int32 WallProbeMisses = 0;
+	int32 WallProbeAsyncResults = 0;
+
+	for (const FPantherJamBenchmarkBot& Bot : Bots)
+	{
+		if (const APantherJamGameCharacter* WallRunner = Cast<APantherJamGameCharacter>(Bot.Character.Get()))
+		{
+			WallProbeHits += WallRunner->GetWallProbe()->GetCacheHits();
+			WallProbeMisses += WallRunner->GetWallProbe()->GetCacheMisses();
+			WallProbeAsyncResults += WallRunner->GetWallProbe()->GetAsyncResults();
+		}
+	}
+
+	Json += FString::Printf(TEXT(",\n\t\"wall_probe\": { \"async\": %s, \"cache_hits\": %d, \"cache_misses\": %d, \"async_results\": %d }"),
+		bAsyncWallProbe ? TEXT("true") : TEXT("false"), WallProbeHits, WallProbeMisses, WallProbeAsyncResults);
+
+	UE_LOG(LogPantherJamBenchmark, Display, TEXT("Wall probes: %d cache hits, %d cache misses, %d async results"), WallProbeHits, WallProbeMisses, WallProbeAsyncResults);
+
+	// pickup setup and memory cost, to compare against -PerfPickupActors runs
+	if (PickupCount > 0)
+	{
+		const double MemoryPerPickupKB = double(int64(MemoryAfterPickups) - int64(MemoryBeforePickups)) / 1024.0 / PickupCount;
+
+		Json += FString::Printf(TEXT(",\n\t\"pickups\": %d,\n\t\"pickups_in_field\": %d,\n\t\"pickup_setup_ms\": %.2f,\n\t\"memory_per_pickup_kb\": %.2f"),
+			PickupCount, PickupFieldCount, PickupSetupTime, MemoryPerPickupKB);
+	}
+
+	// crowd mesh update time at each animation crowd step
+	if (!AnimCrowdCounts.IsEmpty())
+	{
+		Json += TEXT(",\n\t\"anim_crowd\": [");
+
+		for (int32 Step = 0; Step < AnimCrowdCounts.Num(); ++Step)
+		{
+			const TArray<float>& Samples = AnimCrowdTimes[Step];
+			const TArray<float>& SlateSamples = AnimCrowdSlateTimes[Step];
+
+			Json += FString::Printf(TEXT("%s\n\t\t{ \"enemies\": %d, \"frames\": %d, \"anim_ms\": { \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f }"),
+				Step > 0 ? TEXT(",") : TEXT(""), AnimCrowdCounts[Step], Samples.Num(),
+				GetPercentile(Samples, 0.5f), GetPercentile(Samples, 0.95f), GetPercentile(Samples, 0.99f));
+
+			// life bar cost, to compare Combat.LifeBars.Batched runs
+			Json += FString::Printf(TEXT(", \"life_bar_widgets\": %d, \"memory_per_enemy_kb\": %.1f, \"slate_ms\": { \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f } }"),
+				AnimCrowdLifeBarWidgets[Step], AnimCrowdMemoryPerEnemyKB[Step],
+				GetPercentile(SlateSamples, 0.5f), GetPercentile(SlateSamples, 0.95f), GetPercentile(SlateSamples, 0.99f));
+		}
+
+		Json += TEXT("\n\t]");
+	}
+
+	for (const FMetric& Metric : Metrics)
+	{
+		Json += FString::Printf(TEXT(",\n\t\"%s\": {"), Metric.Name);
+
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(Percentiles); ++Index)
+		{
+			const float Value = GetPercentile(*Metric.Samples, Percentiles[Index]);
+			Results.Add(FString::Printf(TEXT("%s.%s"), Metric.Name, PercentileNames[Index]), Value);
+
+			Json += FString::Printf(TEXT("%s \"%s\": %.4f"), Index > 0 ? TEXT(",") : TEXT(""), PercentileNames[Index], Value);
+		}
+
+		Json += TEXT(" }");
+	}
+
+	Json += TEXT("\n}\n");
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmark"), TEXT("PerfResults.json"));
+	FParse::Value(FCommandLine::Get(), TEXT("PerfOutput="), OutputPath);
+
+	FFileHelper::SaveStringToFile(Json, *OutputPath);
+
+	UE_LOG(LogPantherJamBenchmark, Display, TEXT("Benchmark results written to %s"), *OutputPath);
+
+	// compare against the committed baseline
+	FString BaselinePath = FPaths::Combine(FPaths::ProjectDir(), TEXT("Build"), TEXT("Benchmark"), TEXT("PerfBaseline.json"));
+	FParse::Value(FCommandLine::Get(), TEXT("PerfBaseline="), BaselinePath);
+
+	FString Baseline;
+	TSharedPtr<FJsonObject> BaselineObject;
+	int32 Failures = 0;
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("PerfWriteBaseline")))
+	{
+		// record this run as the new baseline instead of comparing against the old one
+		FFileHelper::SaveStringToFile(Json, *BaselinePath);
+
+		UE_LOG(LogPantherJamBenchmark, Display, TEXT("Wrote a new baseline to %s"), *BaselinePath);
+	}
+	else if (!FFileHelper::LoadFileToString(Baseline, *BaselinePath))
+	{
+		// a missing baseline would let every regression through, so fail until one is written on purpose
+		UE_LOG(LogPantherJamBenchmark, Error, TEXT("No baseline found at %s. Run with -PerfWriteBaseline to record one"), *BaselinePath);
+		++Failures;
+	}
+	else if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Baseline), BaselineObject) || !BaselineObject.IsValid())
+	{
+		UE_LOG(LogPantherJamBenchmark, Error, TEXT("Couldn't parse the baseline at %s"), *BaselinePath);
+		++Failures;
+	}
+	else
+	{
+		for (const FMetric& Metric : Metrics)
+		{
+			// find this metric's percentiles in the baseline
+			const TSharedPtr<FJsonObject>* MetricObject = nullptr;
+
+			if (!BaselineObject->TryGetObjectField(Metric.Name, MetricObject))
+			{
+				UE_LOG(LogPantherJamBenchmark, Warning, TEXT("The baseline has no %s, skipping it"), Metric.Name);
+				continue;
+			}
+
+			for (const TCHAR* PercentileName : PercentileNames)
+			{
+				const FString Key = FString::Printf(TEXT("%s.%s"), Metric.Name, PercentileName);
+
+				double BaselineValue = 0.0;
+
+				if (!(*MetricObject)->TryGetNumberField(PercentileName, BaselineValue) || BaselineValue <= 0.0)
+				{
+					continue;
+				}
+
+				const float Value = Results.FindRef(Key);
+				const float Limit = float(BaselineValue) * (1.0f + RegressionTolerance);
+
+				if (Value > Limit)
+				{
+					UE_LOG(LogPantherJamBenchmark, Error, TEXT("Regression: %s is %.3fms, baseline %.3fms, limit %.3fms"), *Key, Value, BaselineValue, Limit);
+					++Failures;
+				}
+				else
+				{
+					UE_LOG(LogPantherJamBenchmark, Display, TEXT("%s is %.3fms, baseline %.3fms"), *Key, Value, BaselineValue);
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogPantherJamBenchmark, Display, TEXT("Benchmark %s with %d failures"), Failures > 0 ? TEXT("failed") : TEXT("passed"), Failures);
+
+	// don't take the editor down with us when running in PIE
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, Failures > 0 ? 1 : 0);
+	}
+}
+
+float APantherJamBenchmarkGameMode::GetPercentile(TArray<float> Samples, float Percentile)
+{
+	if (Samples.IsEmpty())
+	{
+		return 0.0f;
+	}
+
+	// nearest rank percentile
+	Samples.Sort();
+
+	const int32 Rank = FMath::Clamp(FMath::CeilToInt32(Percentile * Samples.Num()) - 1, 0, Samples.Num() - 1);
+
+	return Samples[Rank];
+}
@@ -0,0 +1,389 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "Engine/EngineBaseTypes.h"
+#include "PantherJamBenchmarkGameMode.generated.h"
+
+class APantherJamBenchmarkGameMode;
+class APlayerStart;
+class ACharacter;
+class ASideScrollingPickup;
+
+/**
+ *  Points in the frame the benchmark takes timestamps at
+ */
+enum class EPantherJamBenchmarkMarker : uint8
+{
+	PhysicsStart,
+	PhysicsEnd,
+	AnimStart,
+	AnimEnd
+};
+
+/**
+ *  Marks a point in the frame, such as the start or end of the physics tick groups, so the benchmark can time it
+ */
+USTRUCT()
+struct FPantherJamBenchmarkTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Benchmark game mode to report to */
+	APantherJamBenchmarkGameMode* Target = nullptr;
+
+	/** Point in the frame this tick function marks */
+	EPantherJamBenchmarkMarker Marker = EPantherJamBenchmarkMarker::PhysicsStart;
+
+	/** Reports the current time to the game mode */
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/** Debug name for the tick function */
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FPantherJamBenchmarkTickFunction> : public TStructOpsTypeTraitsBase2<FPantherJamBenchmarkTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ *  A scripted bot driven by the benchmark
+ */
+struct FPantherJamBenchmarkBot
+{
+	/** Character driven by this bot */
+	TWeakObjectPtr<ACharacter> Character;
+
+	/** Offset into the input script, so bots don't all act on the same frame */
+	float TimeOffset = 0.0f;
+
+	/** If true, the bot is holding its action button */
+	bool bActionHeld = false;
+};
+
+/**
+ *  Headless performance benchmark.
+ *  Generates a stress level out of the real Combat, Platforming and SideScrolling classes:
+ *  enemy spawner waves, damageable box physics piles and wall run corridors.
+ *  It then drives the player and a set of bots with scripted input for a fixed duration, records
+ *  frame, game thread and physics times, writes their percentiles to JSON and compares them against a baseline.
+ *
+ *  Usage:
+ *  PantherJam /Engine/Maps/Entry?game=/Script/PantherJamGame.PantherJamBenchmarkGameMode -nullrhi -unattended [-PerfDuration=60] [-PerfOutput=<file>]
+ *      [-PerfBaseline=<file>] [-PerfTolerance=0.1] [-PerfWriteBaseline]
+ *
+ *  The process exits with a non-zero code if any percentile regresses past the baseline by more than the tolerance,
+ *  or if the baseline is missing. -PerfWriteBaseline saves the run as the new baseline instead of comparing against it.
+ *  The results also count the wall run bots' wall probe cache hits, misses and async results.
+ *  Add -PerfAsyncWallProbe to switch the bots to async wall probes.
+ *
+ *  Server soak:
+ *  PantherJamGameServer /Engine/Maps/Entry?game=/Script/PantherJamGame.PantherJamBenchmarkGameMode -PerfSoakBots=64
+ *
+ *  Adds server side combat character bots, and reports the memory cost per bot alongside the server tick times.
+ *  The bots have no net connections, so this covers the simulation cost of each character, not the replication
+ *  and net driver cost a connected player would add. For the server tick and memory per connected player,
+ *  run the PantherJam.Server.Soak automation test, which connects real PIE clients to a dedicated server.
+ *
+ *  Animation crowd:
+ *  PantherJam /Engine/Maps/Entry?game=/Script/PantherJamGame.PantherJamBenchmarkGameMode -PerfAnimCrowd=16,32,64,128
+ *
+ *  Grows a crowd of combat enemies spread from near the player to past the AI LOD dormant distance, one step per count,
+ *  and reports the time the crowd's meshes take to update, including parallel animation evaluation, at each step.
+ *  Each step also reports the life bar widget count, the Slate tick time and the memory used per enemy.
+ *  Add -ExecCmds="Combat.LifeBars.Batched 0" to compare against a widget component per enemy.
+ *
+ *  Pickup field:
+ *  PantherJam /Engine/Maps/Entry?game=/Script/PantherJamGame.PantherJamBenchmarkGameMode -PerfPickups=10000 [-PerfPickupActors]
+ *
+ *  Scatters side scrolling pickups over the arena and moves them into the pickup field, and reports their setup time
+ *  and memory cost alongside the frame times. Add -PerfPickupActors to keep them as actors for comparison.
+ */
+UCLASS()
+class APantherJamBenchmarkGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Player character class, used to attract and fight the enemy waves */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<APawn> CombatCharacterClass;
+
+	/** Enemy spawner class for the enemy waves */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<AActor> EnemySpawnerClass;
+
+	/** Damageable box class for the physics piles */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<AActor> DamageableBoxClass;
+
+	/** Wall running character class for the corridor bots */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<ACharacter> WallRunCharacterClass;
+
+	/** Platforming character class for the platforming bots */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<ACharacter> PlatformingCharacterClass;
+
+	/** Side scrolling character class for the side scrolling bots */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<ACharacter> SideScrollingCharacterClass;
+
+	/** Enemy class for the animation crowd */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<ACharacter> CombatEnemyClass;
+
+	/** Pickup class for the pickup field */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Classes")
+	TSoftClassPtr<ASideScrollingPickup> SideScrollingPickupClass;
+
+	/** Number of enemy spawners placed around the arena */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=0, ClampMax=256))
+	int32 EnemySpawnerCount = 24;
+
+	/** Distance from the arena center to the enemy spawners */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=0, Units="cm"))
+	float EnemySpawnerRadius = 1500.0f;
+
+	/** Number of damageable box piles */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=0, ClampMax=64))
+	int32 BoxPileCount = 8;
+
+	/** Number of boxes along each side of a pile. Piles are cubes */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=1, ClampMax=8))
+	int32 BoxPileSize = 3;
+
+	/** Number of wall run corridors, with one bot each */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=0, ClampMax=32))
+	int32 CorridorCount = 4;
+
+	/** If true, the wall run bots probe for walls asynchronously. Can be enabled with -PerfAsyncWallProbe */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level")
+	bool bAsyncWallProbe = false;
+
+	/** Number of platforming bots */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=0, ClampMax=32))
+	int32 PlatformingBotCount = 4;
+
+	/** Number of side scrolling bots */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Level", meta=(ClampMin=0, ClampMax=32))
+	int32 SideScrollingBotCount = 4;
+
+	/** Number of server side combat character bots to soak the server with. They have no net connections. Can be overridden with -PerfSoakBots */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Soak", meta=(ClampMin=0, ClampMax=256))
+	int32 SoakBotCount = 0;
+
+	/** Enemy counts the animation crowd steps through, spread evenly over the record time. Can be overridden with -PerfAnimCrowd */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Animation")
+	TArray<int32> AnimCrowdCounts;
+
+	/** Time to let each animation crowd step settle before recording it */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Animation", meta=(ClampMin=0, Units="s"))
+	float AnimCrowdSettleTime = 2.0f;
+
+	/** Number of pickups scattered over the arena. Can be overridden with -PerfPickups */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Pickups", meta=(ClampMin=0))
+	int32 PickupCount = 0;
+
+	/** If true, the pickups stay actors instead of moving into the pickup field. Can be enabled with -PerfPickupActors */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Pickups")
+	bool bPickupActors = false;
+
+	/** Time to let the level settle before recording */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Timing", meta=(ClampMin=0, Units="s"))
+	float WarmupTime = 5.0f;
+
+	/** Time to record for. Can be overridden with -PerfDuration */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Timing", meta=(ClampMin=1, Units="s"))
+	float RecordTime = 60.0f;
+
+	/** Allowed regression over the baseline before failing, as a fraction. Can be overridden with -PerfTolerance */
+	UPROPERTY(EditAnywhere, Category="Benchmark|Timing", meta=(ClampMin=0, ClampMax=10))
+	float RegressionTolerance = 0.1f;
+
+	/** Player start at the arena center */
+	UPROPERTY(Transient)
+	TObjectPtr<APlayerStart> ArenaStart;
+
+	/** Scripted bots */
+	TArray<FPantherJamBenchmarkBot> Bots;
+
+	/** Marks the start of the physics step. The world's start physics tick function waits for it */
+	FPantherJamBenchmarkTickFunction PhysicsStartTickFunction;
+
+	/** Marks the end of the physics step. Waits for the world's end physics tick function */
+	FPantherJamBenchmarkTickFunction PhysicsEndTickFunction;
+
+	/** Marks the start of the animation crowd's mesh updates, after their movement */
+	FPantherJamBenchmarkTickFunction AnimStartTickFunction;
+
+	/** Marks the end of the animation crowd's mesh updates, including parallel evaluation */
+	FPantherJamBenchmarkTickFunction AnimEndTickFunction;
+
+	/** Enemies spawned for the animation crowd */
+	TArray<TWeakObjectPtr<ACharacter>> AnimCrowd;
+
+	/** Animation crowd step being recorded */
+	int32 AnimCrowdStep = INDEX_NONE;
+
+	/** Time the current animation crowd step started */
+	float AnimCrowdStepStartTime = 0.0f;
+
+	/** Time since the benchmark started */
+	float ElapsedTime = 0.0f;
+
+	/** If true, the player is holding the combo attack button */
+	bool bPlayerComboHeld = false;
+
+	/** If true, the player is holding the charged attack button */
+	bool bPlayerChargedHeld = false;
+
+	/** Platform time at the start of the last frame */
+	double LastFrameStartTime = 0.0;
+
+	/** Platform time at the start of this frame's world tick */
+	double WorldTickStartTime = 0.0;
+
+	/** Platform time at the start of this frame's physics */
+	double PhysicsStartTime = 0.0;
+
+	/** Platform time at the start of this frame's animation crowd update */
+	double AnimStartTime = 0.0;
+
+	/** Platform time at the start of this frame's Slate tick */
+	double SlateStartTime = 0.0;
+
+	/** Recorded frame times, in milliseconds */
+	TArray<float> FrameTimes;
+
+	/** Recorded game thread world tick times, in milliseconds */
+	TArray<float> GameThreadTimes;
+
+	/** Recorded physics times, in milliseconds */
+	TArray<float> PhysicsTimes;
+
+	/** Recorded animation crowd update times for each step, in milliseconds */
+	TArray<TArray<float>> AnimCrowdTimes;
+
+	/** Recorded Slate tick times for each animation crowd step, in milliseconds */
+	TArray<TArray<float>> AnimCrowdSlateTimes;
+
+	/** Number of user widgets drawing life bars at each animation crowd step */
+	TArray<int32> AnimCrowdLifeBarWidgets;
+
+	/** Physical memory used by each animation crowd enemy at each step, in KB */
+	TArray<float> AnimCrowdMemoryPerEnemyKB;
+
+	/** Handles for the world tick delegates */
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle PostActorTickHandle;
+
+	/** Physical memory in use before the soak bots were spawned */
+	uint64 MemoryBeforeSoak = 0;
+
+	/** Physical memory in use after the soak bots were spawned */
+	uint64 MemoryAfterSoak = 0;
+
+	/** Physical memory in use before the animation crowd was spawned */
+	uint64 MemoryBeforeAnimCrowd = 0;
+
+	/** Physical memory in use before the pickups were spawned */
+	uint64 MemoryBeforePickups = 0;
+
+	/** Physical memory in use after the pickups were spawned */
+	uint64 MemoryAfterPickups = 0;
+
+	/** Time taken to spawn the pickups and move them into the field, in milliseconds */
+	double PickupSetupTime = 0.0;
+
+	/** Number of pickups that ended up in the pickup field */
+	int32 PickupFieldCount = 0;
+
+	/** Handles for the Slate tick delegates */
+	FDelegateHandle SlatePreTickHandle;
+	FDelegateHandle SlatePostTickHandle;
+
+	/** If true, results have been written and we're waiting to exit */
+	bool bFinished = false;
+
+public:
+
+	/** Constructor */
+	APantherJamBenchmarkGameMode();
+
+	/** Builds the stress level */
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/** Always spawn players at the arena center */
+	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
+
+	/** Drives the scripted input and records the frame time */
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Called by the marker tick functions */
+	void MarkTime(EPantherJamBenchmarkMarker Marker);
+
+protected:
+
+	/** Spawns the bots and hooks up the timers */
+	virtual void BeginPlay() override;
+
+	/** Unhooks the timers */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Spawns the floor, the enemy spawners, the box piles and the corridors */
+	void BuildStressLevel();
+
+	/** Spawns a scaled cube with collision */
+	void SpawnBlock(const FVector& Center, const FVector& Size);
+
+	/** Scatters the pickups over the arena */
+	void SpawnPickups();
+
+	/** Spawns a character possessed by a bot controller */
+	void SpawnBot(TSubclassOf<ACharacter> CharacterClass, const FTransform& Transform, float TimeOffset);
+
+	/** Grows the animation crowd when it's time for the next step */
+	void UpdateAnimCrowd();
+
+	/** Spawns an animation crowd enemy and brackets its mesh update with the animation markers */
+	void SpawnAnimCrowdEnemy(int32 Index);
+
+	/** Returns true if the current animation crowd step has settled and should be recorded */
+	bool IsAnimCrowdSettled() const;
+
+	/** Resets the wall probe counters on all bots, so they only count the recorded frames */
+	void ResetWallProbeCounters();
+
+	/** Feeds the scripted input to the player */
+	void DrivePlayer();
+
+	/** Feeds the scripted input to a bot */
+	void DriveBot(FPantherJamBenchmarkBot& Bot);
+
+	/** Called before actors tick */
+	void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Called after actors tick */
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Called before Slate ticks and paints */
+	void OnSlatePreTick(float DeltaTime);
+
+	/** Called after Slate ticks and paints */
+	void OnSlatePostTick(float DeltaTime);
+
+	/** Writes the results, compares them to the baseline and exits */
+	void FinishBenchmark();
+
+	/** Returns the given percentile of the samples */
+	static float GetPercentile(TArray<float> Samples, float Percentile);
+};
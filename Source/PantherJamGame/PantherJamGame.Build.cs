@@ -17,7 +17,8 @@ public class PantherJamGame : ModuleRules
 			"AIModule",
 			"StateTreeModule",
 			"GameplayStateTreeModule",
-			"UMG"
+			"UMG",
+			"Json"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[] { });
@@ -32,8 +33,14 @@ public class PantherJamGame : ModuleRules
 			"PantherJamGame/Variant_SideScrolling/AI"
 		});
 
-		// Uncomment if you are using Slate UI
-		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+		// Slate is used to draw the combat life bars and to time Slate in the benchmark
+		PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+
+		// the automation tests drive play in editor sessions
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
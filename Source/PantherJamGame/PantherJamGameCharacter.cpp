@@ -10,10 +10,16 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "PantherJamWallProbeComponent.h"
+#include "PantherJamMovementComponent.h"
+#include "PantherJamInputRecordingSubsystem.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
-APantherJamGameCharacter::APantherJamGameCharacter()
+APantherJamGameCharacter::APantherJamGameCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UPantherJamMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	GetCharacterMovement()->bUseControllerDesiredRotation = false;
 
@@ -48,10 +54,25 @@ APantherJamGameCharacter::APantherJamGameCharacter()
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
 	FollowCamera->bUsePawnControlRotation = false;
 
+	// Create the wall probe shared by wall running and wall jumping
+	WallProbe = CreateDefaultSubobject<UPantherJamWallProbeComponent>(TEXT("WallProbe"));
+
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 }
 
+void APantherJamGameCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// nobody is watching on a dedicated server, so switch off the camera
+	if (!FPantherJamPresentation::IsEnabled(this))
+	{
+		FPantherJamPresentation::DisableComponent(CameraBoom);
+		FPantherJamPresentation::DisableComponent(FollowCamera);
+	}
+}
+
 void APantherJamGameCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent)) {
@@ -79,9 +100,7 @@ void APantherJamGameCharacter::Move(const FInputActionValue& Value)
 	// route the input
 	DoMove(MovementVector.X, MovementVector.Y);
 
-	//Get Direction for double jump
 	FVector2D Input = Value.Get<FVector2D>();
-	LastInputVector2D = Input;
 
 	if (Controller && (Input != FVector2D::ZeroVector))
 	{
@@ -105,6 +124,8 @@ void APantherJamGameCharacter::Look(const FInputActionValue& Value)
 
 void APantherJamGameCharacter::DoMove(float Right, float Forward)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Move, FVector2f(Right, Forward));
+
 	if (GetController() != nullptr)
 	{
 		// find out which way is forward
@@ -125,6 +146,8 @@ void APantherJamGameCharacter::DoMove(float Right, float Forward)
 
 void APantherJamGameCharacter::DoLook(float Yaw, float Pitch)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Look, FVector2f(Yaw, Pitch));
+
 	if (GetController() != nullptr)
 	{
 		// add yaw and pitch input to controller
@@ -133,6 +156,18 @@ void APantherJamGameCharacter::DoLook(float Yaw, float Pitch)
 	}
 }
 
+void APantherJamGameCharacter::DoJumpStart()
+{
+	// route the input
+	HandleJump();
+}
+
+void APantherJamGameCharacter::DoJumpEnd()
+{
+	// route the input
+	OnJumpReleased();
+}
+
 
 //void APantherJamGameCharacter::EndSlide()
 //{
@@ -158,113 +193,37 @@ void APantherJamGameCharacter::DoLook(float Yaw, float Pitch)
 
 void APantherJamGameCharacter::OnJumpReleased()
 {
-	bWallRunning = false;
-	bHoldingJump = false;
-	WallRunTime = 0.f;
+	// the jump binding comes straight here, so record it here instead of in DoJumpEnd
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::JumpEnd);
 
-	// This function is called when the jump input is released
-	//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, TEXT("space released"));
-	if (GetCharacterMovement()->IsFalling() && bCanWallJump)
-	{
-        // Cast ray on both sides to check for walls
-        FVector Start = GetActorLocation();
-        FVector RightVector = GetActorRightVector();
-        FVector LeftEnd = Start - RightVector * 100.f;
-        FVector RightEnd = Start + RightVector * 100.f;
-
-        FCollisionQueryParams QueryParams;
-        QueryParams.AddIgnoredActor(this);
-
-        FHitResult LeftHit, RightHit;
-        bool bLeftWall = GetWorld()->LineTraceSingleByChannel(LeftHit, Start, LeftEnd, ECC_Visibility, QueryParams);
-        bool bRightWall = GetWorld()->LineTraceSingleByChannel(RightHit, Start, RightEnd, ECC_Visibility, QueryParams);
-
-        FVector WallNormal = FVector::ZeroVector;
-        if (bLeftWall)
-        {
-			WallNormal = LeftHit.ImpactNormal;
-        }
-        else if (bRightWall)
-        {
-			WallNormal = RightHit.ImpactNormal;
-        }
-		//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, TEXT("try Wall Jump"));
-        if (!WallNormal.IsNearlyZero())
-        {
-			UCharacterMovementComponent* MoveComp = GetCharacterMovement();
-			FVector Velocity = MoveComp->Velocity;
-
-			// Reflect velocity against wall normal
-			FVector ReflectedVelocity = FVector::VectorPlaneProject(Velocity, WallNormal) - Velocity.ProjectOnTo(WallNormal);
-			ReflectedVelocity += WallNormal * 600.f; // Add some force away from wall
-
-			ReflectedVelocity.Z = 800.f; // Give upward boost for wall jump
-
-			LaunchCharacter(ReflectedVelocity, true, true);
-
-			//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, TEXT("Wall Jump!"));
-        }
+	UPantherJamMovementComponent* MoveComp = GetPantherJamMovement();
+
+	// let go of the wall. The movement component drops the wall run on its next update
+	MoveComp->SetWantsToWallRun(false);
 
+	// releasing jump in the air jumps off any wall next to us. The movement component resolves it so it can be predicted
+	if (MoveComp->IsFalling())
+	{
+		MoveComp->RequestWallJump();
 	}
 }
 
 void APantherJamGameCharacter::HandleJump()
 {
-	bHoldingJump = true;
+	// the jump binding comes straight here, so record it here instead of in DoJumpStart
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::JumpStart);
 
-	if (GetCharacterMovement()->IsFalling() && bCanDoubleJump)
-	{
+	UPantherJamMovementComponent* MoveComp = GetPantherJamMovement();
 
-		UCharacterMovementComponent* MoveComp = GetCharacterMovement();
-		
-		// Input direction
-		if (LastInputVector2D.IsNearlyZero())
-			return;
-
-		// Desired direction based on input and control rotation
-		FVector Input = FVector(LastInputVector2D.Y, LastInputVector2D.X, 0.f);
-		FRotator YawRot(0.f, Controller->GetControlRotation().Yaw, 0.f);
-		FVector DesiredDir = FRotationMatrix(YawRot).TransformVector(Input).GetSafeNormal();
-
-		bCanDoubleJump = false;
-
-		// Current horizontal velocity
-		FVector CurrentVel = MoveComp->Velocity;
-		FVector CurrentVel2D = FVector(CurrentVel.X, CurrentVel.Y, 0.f);
-		float CurrentSpeed = CurrentVel2D.Size();
-
-		// Angle between current velocity and desired direction
-		float Dot = FVector::DotProduct(CurrentVel2D.GetSafeNormal(), DesiredDir);
-		float AngleDeg = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(Dot, -1.f, 1.f)));
-
-		if (AngleDeg > 135.f)
-		{
-			//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Red, TEXT("Double jump angle too sharp"));
-			return;
-		}
-
-		// Apply speed loss based on angle (0degree = 15% loss, 90degree = 50% loss)
-		float SpeedLoss = 0.f;
-		if (AngleDeg <= 45.f)
-		{
-			SpeedLoss = FMath::GetMappedRangeValueClamped(FVector2D(0.f, 45.f), FVector2D(0.f, 0.15f), AngleDeg);
-		}
-		else
-		{
-			SpeedLoss = FMath::GetMappedRangeValueClamped(FVector2D(45.f, 135.f), FVector2D(0.15f, 0.8f), AngleDeg);
-		}
-		float NewSpeed = CurrentSpeed * (1.f - SpeedLoss);
-
-		FVector FinalVelocity = DesiredDir * NewSpeed;
-		FinalVelocity.Z = 1000;
-
-		LaunchCharacter(FinalVelocity, true, true);
-
-		//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green,
-			//FString::Printf(TEXT("Double jump %.0fdegree loss: %.0f%%"), AngleDeg, SpeedLoss * 100.f));
-		
+	// holding jump in the air next to a wall starts a wall run
+	MoveComp->SetWantsToWallRun(true);
+
+	if (MoveComp->IsFalling())
+	{
+		// double jump towards the input direction. The movement component resolves it so it can be predicted
+		MoveComp->RequestDoubleJump();
 	}
-	else if (GetCharacterMovement()->IsMovingOnGround())
+	else if (MoveComp->IsMovingOnGround())
 	{
 		Jump();
 		//GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green, TEXT("Ground Jump"));
@@ -272,148 +231,56 @@ void APantherJamGameCharacter::HandleJump()
 }
 
 
-void APantherJamGameCharacter::Landed(const FHitResult& Hit)
-{
-	Super::Landed(Hit);
-
-	bCanDoubleJump = true;
-
-	//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green, TEXT("Landed"));
-}
-
-
 void APantherJamGameCharacter::Tick(float DeltaSeconds)  
 {  
-    Super::Tick(DeltaSeconds);
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(CharacterTick);
 
+    Super::Tick(DeltaSeconds);
 
-	// Get current XY Speed, ignoring Z
-	float CurrentSpeed = GetVelocity().Size2D();
 
-	if (bWallRunning)
-	{
-		// immediately cancel if jump is no longer held
-		if (!bHoldingJump)
-		{
-			bWallRunning = false;
-			WallRunTime = 0.f;
-			return;
-		}
-
-		// Wall detection code
-		FVector Start = GetActorLocation();
-		FVector RightVector = GetActorRightVector();
-		FVector LeftEnd = Start - RightVector * 100.f;
-		FVector RightEnd = Start + RightVector * 100.f;
-
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this);
-
-		FHitResult LeftHit, RightHit;
-		bool bLeftWall = GetWorld()->LineTraceSingleByChannel(LeftHit, Start, LeftEnd, ECC_Visibility, QueryParams);
-		bool bRightWall = GetWorld()->LineTraceSingleByChannel(RightHit, Start, RightEnd, ECC_Visibility, QueryParams);
-
-		if (bLeftWall || bRightWall)
-		{
-			WallRunTime += DeltaSeconds;
-
-			// Maintain or reduce vertical velocity
-			FVector Velocity = GetCharacterMovement()->Velocity;
-
-			const float predropLength = 1.f; // Time before Z falloff
-			const float dropLength = 1.f; // Duration of Z falloff (0% Gravity -> 100% Gravity)
-			const float dropExponent = .5f; // Drop falloff easing exponent
-
-			float dropTime = FMath::Clamp((WallRunTime - predropLength) / dropLength, 0.f, 1.f);
-			float drop = FMath::InterpEaseIn(0.f, 1.f, dropTime, dropExponent);
-
-			Velocity.Z = FMath::Max(Velocity.Z,  Velocity.Z * drop);
-			GetCharacterMovement()->Velocity = Velocity;
-
-			// Align velocity along wall
-			FVector WallNormal = bLeftWall ? LeftHit.ImpactNormal : RightHit.ImpactNormal;
-			FVector Forward = FVector::CrossProduct(WallNormal, FVector::UpVector);
-			if (FVector::DotProduct(Forward, GetActorForwardVector()) < 0)
-			{
-				Forward *= -1.f;
-			}
-			FVector NewVel = Forward * CurrentSpeed;
-			NewVel.Z = GetCharacterMovement()->Velocity.Z;
-			GetCharacterMovement()->Velocity = NewVel;
-
-			// Maintain 50 units from wall
-			FVector ImpactPoint = bLeftWall ? LeftHit.ImpactPoint : RightHit.ImpactPoint;
-			FVector DesiredOffset = ImpactPoint + (WallNormal * 50.f);
-			FVector CurrentLocation = GetActorLocation();
-			FVector NewLocation = FMath::VInterpTo(CurrentLocation, DesiredOffset, DeltaSeconds, 20.f); // smooth slide
-			SetActorLocation(NewLocation, true);
-		}
-		else
-		{
-			bWallRunning = false;
-			WallRunTime = 0.f;
-		}
-	}
-	else if (bHoldingJump)
+	// Custom rotation logic based on direction speed
+	if (!GetVelocity().IsNearlyZero())
 	{
-		// Check for wall on left or right to start wall run
-		FVector Start = GetActorLocation();
-		FVector RightVector = GetActorRightVector();
-		FVector LeftEnd = Start - RightVector * 100.f;
-		FVector RightEnd = Start + RightVector * 100.f;
-
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this);
-
-		FHitResult LeftHit, RightHit;
-		bool bLeftWall = GetWorld()->LineTraceSingleByChannel(LeftHit, Start, LeftEnd, ECC_Visibility, QueryParams);
-		bool bRightWall = GetWorld()->LineTraceSingleByChannel(RightHit, Start, RightEnd, ECC_Visibility, QueryParams);
-
-		if (bLeftWall || bRightWall)
-		{
-			bWallRunning = true;
-			WallRunTime = 0.f;
-
-			// Align velocity along wall
-			FVector WallNormal = bLeftWall ? LeftHit.ImpactNormal : RightHit.ImpactNormal;
-			FVector Forward = FVector::CrossProduct(WallNormal, FVector::UpVector);
-			if (FVector::DotProduct(Forward, GetActorForwardVector()) < 0)
-			{
-				Forward *= -1.f;
-			}
-			FVector NewVel = Forward * CurrentSpeed;
-
-			NewVel.Z = FMath::Max(GetCharacterMovement()->Velocity.Z, 0.f);
-			GetCharacterMovement()->Velocity = NewVel;
-		}
+		FRotator NewRotation = GetVelocity().Rotation();
+		NewRotation.Pitch = 0.0f; // Keep pitch zero to avoid tilting
+		NewRotation.Roll = 0.0f; // Keep roll zero to avoid tilting
+		SetActorRotation(NewRotation);
 	}
 
+}
 
-
-	float NewAcceleration = 10000.f;
-	
-	// GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green, FString::Printf(TEXT("Speed: %.2f"), CurrentSpeed));
-
-	// Increase movement speed up to a cap
-	if (CurrentSpeed >= 300.f)
+void APantherJamGameCharacter::ReplayInput(EPantherJamInputAction Action, const FVector2f& Value)
+{
+	switch (Action)
 	{
-		NewAcceleration = FMath::GetMappedRangeValueClamped(
-			FVector2D(300.f, 500.f),
-			FVector2D(1500.f, 250.f),
-			CurrentSpeed
-		);
-	}
+	case EPantherJamInputAction::Move:
+		// the move binding adds its own movement input on top of DoMove's, so go through it
+		Move(FInputActionValue(FVector2D(Value)));
+		break;
 
-	GetCharacterMovement()->MaxAcceleration = NewAcceleration;
+	case EPantherJamInputAction::Look:
+		DoLook(Value.X, Value.Y);
+		break;
 
+	case EPantherJamInputAction::JumpStart:
+		HandleJump();
+		break;
 
-	// Custom rotation logic based on direction speed
-	if (!GetVelocity().IsNearlyZero())
-	{
-		FRotator NewRotation = GetVelocity().Rotation();
-		NewRotation.Pitch = 0.0f; // Keep pitch zero to avoid tilting
-		NewRotation.Roll = 0.0f; // Keep roll zero to avoid tilting
-		SetActorRotation(NewRotation);
+	case EPantherJamInputAction::JumpEnd:
+		OnJumpReleased();
+		break;
+
+	default:
+		break;
 	}
+}
 
+bool APantherJamGameCharacter::IsWallRunning() const
+{
+	return GetPantherJamMovement()->IsWallRunning();
+}
+
+UPantherJamMovementComponent* APantherJamGameCharacter::GetPantherJamMovement() const
+{
+	return CastChecked<UPantherJamMovementComponent>(GetCharacterMovement());
 }
@@ -5,10 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
+#include "PantherJamInputReplayable.h"
 #include "PantherJamGameCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
+class UPantherJamWallProbeComponent;
+class UPantherJamMovementComponent;
 class UInputAction;
 struct FInputActionValue;
 
@@ -19,7 +22,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
  *  Implements a controllable orbiting camera
  */
 UCLASS(abstract)
-class APantherJamGameCharacter : public ACharacter
+class APantherJamGameCharacter : public ACharacter, public IPantherJamInputReplayable
 {
 	GENERATED_BODY()
 
@@ -30,6 +33,10 @@ class APantherJamGameCharacter : public ACharacter
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FollowCamera;
+
+	/** Shared wall probe for wall running and wall jumping */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wall Run", meta = (AllowPrivateAccess = "true"))
+	UPantherJamWallProbeComponent* WallProbe;
 	
 protected:
 
@@ -49,16 +56,6 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Input")
 	UInputAction* MouseLookAction;
 
-	FVector2D LastInputVector2D;
-
-	bool bCanDoubleJump = true;
-
-	bool bCanWallJump = true;
-
-	bool bHoldingJump = false;
-	bool bWallRunning = false;
-	float WallRunTime = 0.0f;
-
 	/*bool bIsSliding = false;*/
 
 	
@@ -67,10 +64,13 @@ protected:
 public:
 
 	/** Constructor */
-	APantherJamGameCharacter();	
+	APantherJamGameCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** Initialize input action bindings */
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -93,7 +93,6 @@ protected:
 
 
 public:
-	virtual void Landed(const FHitResult& Hit) override;
 
 	/** Handles move inputs from either controls or UI interfaces */
 	UFUNCTION(BlueprintCallable, Category="Input")
@@ -103,8 +102,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Input")
 	virtual void DoLook(float Yaw, float Pitch);
 
+	/** Handles jump pressed inputs from either controls or UI interfaces */
+	UFUNCTION(BlueprintCallable, Category="Input")
+	virtual void DoJumpStart();
+
+	/** Handles jump released inputs from either controls or UI interfaces */
+	UFUNCTION(BlueprintCallable, Category="Input")
+	virtual void DoJumpEnd();
+
 	virtual void Tick(float DeltaSeconds) override;
 
+	// ~begin IPantherJamInputReplayable interface
+
+	/** Performs a recorded input through the same path as the input bindings */
+	virtual void ReplayInput(EPantherJamInputAction Action, const FVector2f& Value) override;
+
+	// ~end IPantherJamInputReplayable interface
+
 public:
 
 	/** Returns CameraBoom subobject **/
@@ -112,5 +126,15 @@ public:
 
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+
+	/** Returns true if the character is currently wall running */
+	UFUNCTION(BlueprintPure, Category="Wall Run")
+	bool IsWallRunning() const;
+
+	/** Returns the wall running character movement component */
+	UPantherJamMovementComponent* GetPantherJamMovement() const;
+
+	/** Returns WallProbe subobject **/
+	FORCEINLINE class UPantherJamWallProbeComponent* GetWallProbe() const { return WallProbe; }
 };
 
@@ -0,0 +1,602 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamInputRecordingSubsystem.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPantherJamInputRecording, Log, All);
+
+/** Marks the start of an input recording */
+static constexpr uint32 RecordingMagic = 0x52494A50;
+
+/** Axis values are stored as multiples of 1 / AxisScale */
+static constexpr float AxisScale = 4096.0f;
+
+static TAutoConsoleVariable<float> CVarInputRecordingStep(
+	TEXT("InputRecording.Step"),
+	1.0f / 60.0f,
+	TEXT("Fixed step new input recordings are stamped with, and played back at, in seconds."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdInputRecordingStart(
+	TEXT("InputRecording.Start"),
+	TEXT("Starts recording the local player's inputs. Takes the recording name, Session by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UPantherJamInputRecordingSubsystem* Subsystem = World->GetSubsystem<UPantherJamInputRecordingSubsystem>())
+		{
+			Subsystem->StartRecording(Args.Num() > 0 ? Args[0] : TEXT("Session"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld CCmdInputRecordingStop(
+	TEXT("InputRecording.Stop"),
+	TEXT("Stops recording inputs and writes the recording to Saved/InputRecordings."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UPantherJamInputRecordingSubsystem* Subsystem = World->GetSubsystem<UPantherJamInputRecordingSubsystem>())
+		{
+			Subsystem->StopRecording();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdInputRecordingReplay(
+	TEXT("InputRecording.Replay"),
+	TEXT("Plays back an input recording at its fixed step. Takes the recording name, Session by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UPantherJamInputRecordingSubsystem* Subsystem = World->GetSubsystem<UPantherJamInputRecordingSubsystem>())
+		{
+			Subsystem->StartReplay(Args.Num() > 0 ? Args[0] : TEXT("Session"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld CCmdInputRecordingStopReplay(
+	TEXT("InputRecording.StopReplay"),
+	TEXT("Stops playing back inputs and gives control back to the player."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UPantherJamInputRecordingSubsystem* Subsystem = World->GetSubsystem<UPantherJamInputRecordingSubsystem>())
+		{
+			Subsystem->StopReplay();
+		}
+	}));
+
+/** Returns the number of axis values stored with the action */
+static int32 GetNumAxes(EPantherJamInputAction Action)
+{
+	switch (Action)
+	{
+	case EPantherJamInputAction::Move:
+	case EPantherJamInputAction::Look:
+		return 2;
+
+	case EPantherJamInputAction::Drop:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/** Appends an unsigned integer, 7 bits per byte */
+static void WriteVarUInt(TArray<uint8>& Out, uint32 Value)
+{
+	while (Value >= 0x80)
+	{
+		Out.Add((uint8)(Value | 0x80));
+		Value >>= 7;
+	}
+
+	Out.Add((uint8)Value);
+}
+
+/** Decodes an unsigned integer written by WriteVarUInt. Returns false if it runs past the end */
+static bool ReadVarUInt(const uint8*& Cursor, const uint8* End, uint32& OutValue)
+{
+	OutValue = 0;
+
+	for (int32 Shift = 0; Shift < 35 && Cursor < End; Shift += 7)
+	{
+		const uint8 Byte = *Cursor++;
+		OutValue |= (uint32)(Byte & 0x7F) << Shift;
+
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Returns true if the action is sampled once per step and held, instead of recorded as it happens */
+static bool IsSampledAxis(EPantherJamInputAction Action)
+{
+	return Action == EPantherJamInputAction::Move || Action == EPantherJamInputAction::Look;
+}
+
+/** Maps signed deltas to unsigned ones so small negative changes stay small */
+static uint32 ZigZagEncode(int32 Value)
+{
+	return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+}
+
+static int32 ZigZagDecode(uint32 Value)
+{
+	return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+}
+
+void UPantherJamInputRecordingSubsystem::RecordInput(const APawn* Pawn, EPantherJamInputAction Action, const FVector2f& Value)
+{
+	if (!Pawn || !Pawn->IsLocallyControlled() || !Pawn->IsPlayerControlled())
+	{
+		return;
+	}
+
+	UPantherJamInputRecordingSubsystem* Subsystem = Pawn->GetWorld()->GetSubsystem<UPantherJamInputRecordingSubsystem>();
+
+	if (Subsystem && Subsystem->bRecording)
+	{
+		Subsystem->GatherInput(Action, Value);
+	}
+}
+
+void UPantherJamInputRecordingSubsystem::StartRecording(const FString& Name)
+{
+	// replayed inputs come back through the same entry points, so don't record them again
+	if (bReplaying)
+	{
+		UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Can't record inputs during playback"));
+		return;
+	}
+
+	StopRecording();
+
+	RecordName = Name;
+	RecordStep = FMath::Max(CVarInputRecordingStep.GetValueOnGameThread(), UE_KINDA_SMALL_NUMBER);
+	RecordStartTime = GetWorld()->GetTimeSeconds();
+	LastRecordFrame = 0;
+	LastWrittenStep = INDEX_NONE;
+	PendingInputs.Reset();
+	FMemory::Memzero(LastValues);
+
+	for (int32 Index = 0; Index < (int32)EPantherJamInputAction::Num; ++Index)
+	{
+		StepAxisValues[Index] = FVector2f::ZeroVector;
+		bStepHasAxisInput[Index] = false;
+	}
+
+	// write the header
+	RecordBuffer.Reset();
+
+	FMemoryWriter Writer(RecordBuffer);
+
+	uint32 Magic = RecordingMagic;
+	int32 Version = RecordingVersion;
+	float Step = RecordStep;
+	FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+
+	Writer << Magic << Version << Step << MapName;
+
+	bRecording = true;
+
+	UE_LOG(LogPantherJamInputRecording, Log, TEXT("Recording inputs to %s"), *GetRecordingPath(RecordName));
+}
+
+void UPantherJamInputRecordingSubsystem::StopRecording()
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	// write out whatever the current step gathered so far
+	WriteStepInputs(true);
+
+	// release any held move or look on the last step, so playback runs for the whole recording
+	for (int32 Index = 0; Index < (int32)EPantherJamInputAction::Num; ++Index)
+	{
+		if (IsSampledAxis((EPantherJamInputAction)Index) && (LastValues[Index][0] != 0 || LastValues[Index][1] != 0))
+		{
+			AppendEvent(LastWrittenStep + 1, (EPantherJamInputAction)Index, FVector2f::ZeroVector);
+		}
+	}
+
+	bRecording = false;
+
+	const FString Path = GetRecordingPath(RecordName);
+
+	if (FFileHelper::SaveArrayToFile(RecordBuffer, *Path))
+	{
+		UE_LOG(LogPantherJamInputRecording, Log, TEXT("Wrote %d frames of inputs in %d bytes to %s"), LastRecordFrame, RecordBuffer.Num(), *Path);
+
+	} else {
+
+		UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Couldn't write input recording %s"), *Path);
+	}
+
+	RecordBuffer.Empty();
+}
+
+bool UPantherJamInputRecordingSubsystem::StartReplay(const FString& Name)
+{
+	StopReplay();
+	StopRecording();
+
+	const FString Path = GetRecordingPath(Name);
+
+	// map the recording so playback decodes it in place
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	FOpenMappedResult Mapped = FPlatformFileManager::Get().GetPlatformFile().OpenMappedEx(*Path);
+
+	if (Mapped.HasValue())
+	{
+		ReplayHandle = Mapped.StealValue();
+		ReplayRegion.Reset(ReplayHandle->MapRegion(0, ReplayHandle->GetFileSize()));
+	}
+
+	if (ReplayRegion)
+	{
+		Data = ReplayRegion->GetMappedPtr();
+		Size = ReplayRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(ReplayFallback, *Path, FILEREAD_Silent))
+	{
+		// not every platform can map files
+		Data = ReplayFallback.GetData();
+		Size = ReplayFallback.Num();
+	}
+	else
+	{
+		UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Couldn't open input recording %s"), *Path);
+		StopReplay();
+		return false;
+	}
+
+	// read the header
+	FMemoryReaderView Reader(TArrayView<const uint8>(Data, (int32)Size));
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	float Step = 0.0f;
+	FString MapName;
+
+	Reader << Magic << Version;
+
+	if (Reader.IsError() || Magic != RecordingMagic || Version != RecordingVersion)
+	{
+		UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Ignoring input recording %s with unknown format or version"), *Path);
+		StopReplay();
+		return false;
+	}
+
+	Reader << Step << MapName;
+
+	if (Reader.IsError() || Step <= 0.0f || MapName != UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName()))
+	{
+		UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Ignoring input recording %s of %s"), *Path, *MapName);
+		StopReplay();
+		return false;
+	}
+
+	ReplayCursor = Data + Reader.Tell();
+	ReplayEnd = Data + Size;
+	ReplayFrame = 0;
+	NextEventFrame = 0;
+	FMemory::Memzero(LastValues);
+
+	for (FVector2f& HeldValue : HeldValues)
+	{
+		HeldValue = FVector2f::ZeroVector;
+	}
+
+	if (!ReadNextEventFrame())
+	{
+		UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Input recording %s is empty"), *Path);
+		StopReplay();
+		return false;
+	}
+
+	// play back one recorded frame per engine frame
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(Step);
+
+	bReplaying = true;
+
+	UE_LOG(LogPantherJamInputRecording, Log, TEXT("Playing back %s at %.4fs per frame"), *Path, Step);
+
+	return true;
+}
+
+void UPantherJamInputRecordingSubsystem::StopReplay()
+{
+	if (bReplaying)
+	{
+		bReplaying = false;
+
+		FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+		FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+		// give control back to the player
+		APawn* Pawn = ReplayPawn.Get();
+
+		if (APlayerController* PC = Pawn ? Cast<APlayerController>(Pawn->GetController()) : nullptr)
+		{
+			Pawn->EnableInput(PC);
+		}
+	}
+
+	ReplayPawn = nullptr;
+	ReplayCursor = nullptr;
+	ReplayEnd = nullptr;
+
+	// the region must go before the file it maps
+	ReplayRegion.Reset();
+	ReplayHandle.Reset();
+	ReplayFallback.Empty();
+}
+
+FString UPantherJamInputRecordingSubsystem::GetRecordingPath(const FString& Name)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputRecordings"), FPaths::GetBaseFilename(Name) + TEXT(".pjinput"));
+}
+
+void UPantherJamInputRecordingSubsystem::Tick(float DeltaTime)
+{
+	// the pawn has reported this frame's inputs by now
+	if (bRecording)
+	{
+		WriteStepInputs(false);
+	}
+
+	if (!bReplaying)
+	{
+		return;
+	}
+
+	APlayerController* PC = GetWorld()->GetFirstPlayerController();
+	APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+
+	// keep the player's own bindings out of the way, including after respawns
+	if (Pawn != ReplayPawn.Get())
+	{
+		if (Pawn)
+		{
+			Pawn->DisableInput(PC);
+		}
+
+		ReplayPawn = Pawn;
+	}
+
+	// inputs recorded while there was no pawn to take them are dropped, like they were when recording
+	IPantherJamInputReplayable* Target = Cast<IPantherJamInputReplayable>(Pawn);
+
+	while (NextEventFrame <= ReplayFrame)
+	{
+		if (!PlayNextEvent(Target))
+		{
+			UE_LOG(LogPantherJamInputRecording, Warning, TEXT("Input recording is corrupt at frame %d, stopping playback"), ReplayFrame);
+			StopReplay();
+			return;
+		}
+
+		if (!ReadNextEventFrame())
+		{
+			UE_LOG(LogPantherJamInputRecording, Log, TEXT("Finished playing back %d frames of inputs"), ReplayFrame + 1);
+			StopReplay();
+			return;
+		}
+	}
+
+	// move and look were sampled every step, so feed them every frame until they change
+	if (Target)
+	{
+		for (int32 Index = 0; Index < (int32)EPantherJamInputAction::Num; ++Index)
+		{
+			if (IsSampledAxis((EPantherJamInputAction)Index) && !HeldValues[Index].IsZero())
+			{
+				Target->ReplayInput((EPantherJamInputAction)Index, HeldValues[Index]);
+			}
+		}
+	}
+
+	++ReplayFrame;
+}
+
+TStatId UPantherJamInputRecordingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPantherJamInputRecordingSubsystem, STATGROUP_Tickables);
+}
+
+void UPantherJamInputRecordingSubsystem::Deinitialize()
+{
+	StopRecording();
+	StopReplay();
+
+	Super::Deinitialize();
+}
+
+bool UPantherJamInputRecordingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPantherJamInputRecordingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// only start once per run, so traveling to another map doesn't restart it
+	static bool bHandledCommandLine = false;
+
+	if (bHandledCommandLine)
+	{
+		return;
+	}
+
+	bHandledCommandLine = true;
+
+	FString Name;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("InputReplay="), Name))
+	{
+		StartReplay(Name);
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("InputRecord="), Name))
+	{
+		StartRecording(Name);
+	}
+}
+
+void UPantherJamInputRecordingSubsystem::GatherInput(EPantherJamInputAction Action, const FVector2f& Value)
+{
+	const int32 Index = (int32)Action;
+
+	if (!IsSampledAxis(Action))
+	{
+		PendingInputs.Emplace(Action, Value);
+		return;
+	}
+
+	// look values are per frame deltas, so every frame in the step counts. Move values are held, so the last one wins
+	StepAxisValues[Index] = Action == EPantherJamInputAction::Look ? StepAxisValues[Index] + Value : Value;
+	bStepHasAxisInput[Index] = true;
+}
+
+void UPantherJamInputRecordingSubsystem::WriteStepInputs(bool bFlush)
+{
+	// keep gathering while frames are shorter than the step
+	const int32 CurrentStep = FMath::RoundToInt32((GetWorld()->GetTimeSeconds() - RecordStartTime) / RecordStep);
+
+	if (CurrentStep <= LastWrittenStep && !bFlush)
+	{
+		return;
+	}
+
+	// the frame's inputs go on the first step it covered
+	const int32 Step = LastWrittenStep + 1;
+	LastWrittenStep = FMath::Max(CurrentStep, Step);
+
+	for (const TPair<EPantherJamInputAction, FVector2f>& Input : PendingInputs)
+	{
+		AppendEvent(Step, Input.Key, Input.Value);
+	}
+
+	PendingInputs.Reset();
+
+	for (int32 Index = 0; Index < (int32)EPantherJamInputAction::Num; ++Index)
+	{
+		const EPantherJamInputAction Action = (EPantherJamInputAction)Index;
+
+		if (!IsSampledAxis(Action))
+		{
+			continue;
+		}
+
+		// no report means the input was released
+		const FVector2f Value = bStepHasAxisInput[Index] ? StepAxisValues[Index] : FVector2f::ZeroVector;
+
+		// playback holds the value, so only write changes
+		if (FMath::RoundToInt32(Value.X * AxisScale) != LastValues[Index][0] || FMath::RoundToInt32(Value.Y * AxisScale) != LastValues[Index][1])
+		{
+			AppendEvent(Step, Action, Value);
+		}
+
+		// a look delta happened once, so don't hold it over the rest of a hitch
+		if (Action == EPantherJamInputAction::Look && LastWrittenStep > Step && (LastValues[Index][0] != 0 || LastValues[Index][1] != 0))
+		{
+			AppendEvent(Step + 1, Action, FVector2f::ZeroVector);
+		}
+
+		StepAxisValues[Index] = FVector2f::ZeroVector;
+		bStepHasAxisInput[Index] = false;
+	}
+}
+
+void UPantherJamInputRecordingSubsystem::AppendEvent(int32 Frame, EPantherJamInputAction Action, const FVector2f& Value)
+{
+	WriteVarUInt(RecordBuffer, (uint32)(Frame - LastRecordFrame));
+	RecordBuffer.Add((uint8)Action);
+
+	LastRecordFrame = Frame;
+
+	// store how much each axis changed since the last time
+	int32* LastActionValues = LastValues[(int32)Action];
+
+	for (int32 Axis = 0; Axis < GetNumAxes(Action); ++Axis)
+	{
+		const int32 Quantized = FMath::RoundToInt32(Value[Axis] * AxisScale);
+
+		WriteVarUInt(RecordBuffer, ZigZagEncode(Quantized - LastActionValues[Axis]));
+		LastActionValues[Axis] = Quantized;
+	}
+}
+
+bool UPantherJamInputRecordingSubsystem::ReadNextEventFrame()
+{
+	uint32 FrameDelta = 0;
+
+	if (ReplayCursor >= ReplayEnd || !ReadVarUInt(ReplayCursor, ReplayEnd, FrameDelta))
+	{
+		return false;
+	}
+
+	NextEventFrame += (int32)FrameDelta;
+
+	return true;
+}
+
+bool UPantherJamInputRecordingSubsystem::PlayNextEvent(IPantherJamInputReplayable* Target)
+{
+	if (ReplayCursor >= ReplayEnd || *ReplayCursor >= (uint8)EPantherJamInputAction::Num)
+	{
+		return false;
+	}
+
+	const EPantherJamInputAction Action = (EPantherJamInputAction)*ReplayCursor++;
+
+	// rebuild the axis values from their changes
+	int32* LastActionValues = LastValues[(int32)Action];
+	FVector2f Value = FVector2f::ZeroVector;
+
+	for (int32 Axis = 0; Axis < GetNumAxes(Action); ++Axis)
+	{
+		uint32 Delta = 0;
+
+		if (!ReadVarUInt(ReplayCursor, ReplayEnd, Delta))
+		{
+			return false;
+		}
+
+		LastActionValues[Axis] += ZigZagDecode(Delta);
+		Value[Axis] = LastActionValues[Axis] / AxisScale;
+	}
+
+	// move and look are fed every frame from their held values
+	if (IsSampledAxis(Action))
+	{
+		HeldValues[(int32)Action] = Value;
+	}
+	else if (Target)
+	{
+		Target->ReplayInput(Action, Value);
+	}
+
+	return true;
+}
@@ -0,0 +1,164 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Async/MappedFileHandle.h"
+#include "PantherJamInputReplayable.h"
+#include "PantherJamInputRecordingSubsystem.generated.h"
+
+class APawn;
+
+/**
+ *  Records what the local player did, and plays it back without a human to reproduce perf spikes or drive benchmarks.
+ *  Characters report their inputs from their Do* entry points, and the recorder writes them out once per fixed step.
+ *  Button inputs are stamped with the step they happened in. Move and look are sampled once per step, so a hitch
+ *  or a frame rate above the step rate still replays one input per step: move values are held over every step the
+ *  frame covered, and look deltas are added up over the step and applied once.
+ *  Playback memory-maps the recording, switches the engine to a fixed timestep of the recorded step,
+ *  and feeds each frame's inputs back to the player's pawn through IPantherJamInputReplayable.
+ *  Move and look values are fed again every frame until the recording changes them.
+ *
+ *  File layout: magic, version, fixed step, map name, then one event per input or axis change holding the frame delta
+ *  since the previous event, the action, and for axis inputs each component's change from the previous value of that action.
+ *  Integers are variable length, and axis values are quantized, so held inputs cost nothing until they change.
+ *
+ *  Usage:
+ *  InputRecording.Start <Name> / InputRecording.Stop / InputRecording.Replay <Name> / InputRecording.StopReplay from the console,
+ *  or -InputRecord=<Name> / -InputReplay=<Name> on the command line. Recordings live in Saved/InputRecordings.
+ */
+UCLASS()
+class UPantherJamInputRecordingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Version of the recording format. Recordings from other versions are rejected */
+	static constexpr int32 RecordingVersion = 2;
+
+protected:
+
+	/** Encoded recording in progress */
+	TArray<uint8> RecordBuffer;
+
+	/** Name of the recording in progress */
+	FString RecordName;
+
+	/** World time the recording started at */
+	double RecordStartTime = 0.0;
+
+	/** Frame of the last recorded event */
+	int32 LastRecordFrame = 0;
+
+	/** Fixed step the recording is stamped with */
+	float RecordStep = 0.0f;
+
+	/** Last fixed step the gathered inputs were written for */
+	int32 LastWrittenStep = INDEX_NONE;
+
+	/** Button inputs gathered since the last written step */
+	TArray<TPair<EPantherJamInputAction, FVector2f>> PendingInputs;
+
+	/** Move and look values gathered since the last written step */
+	FVector2f StepAxisValues[(int32)EPantherJamInputAction::Num];
+
+	/** If true, the action's axis value was reported since the last written step */
+	bool bStepHasAxisInput[(int32)EPantherJamInputAction::Num] = {};
+
+	/** Last quantized value of each axis input, recorded or replayed */
+	int32 LastValues[(int32)EPantherJamInputAction::Num][2] = {};
+
+	/** If true, inputs are being recorded */
+	bool bRecording = false;
+
+	/** Memory-mapped recording being played back */
+	TUniquePtr<IMappedFileHandle> ReplayHandle;
+
+	/** Mapped view of the whole recording */
+	TUniquePtr<IMappedFileRegion> ReplayRegion;
+
+	/** Recording contents, only used if the file can't be memory-mapped */
+	TArray<uint8> ReplayFallback;
+
+	/** Next byte to decode */
+	const uint8* ReplayCursor = nullptr;
+
+	/** End of the recording */
+	const uint8* ReplayEnd = nullptr;
+
+	/** Current playback frame */
+	int32 ReplayFrame = 0;
+
+	/** Frame of the next event to play */
+	int32 NextEventFrame = 0;
+
+	/** Move and look values fed to the pawn every playback frame until the recording changes them */
+	FVector2f HeldValues[(int32)EPantherJamInputAction::Num];
+
+	/** Pawn receiving the inputs. Its own input bindings are disabled during playback */
+	TWeakObjectPtr<APawn> ReplayPawn;
+
+	/** If true, a recording is being played back */
+	bool bReplaying = false;
+
+	/** Fixed timestep state to restore when playback ends */
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+public:
+
+	/** Records an input performed by the pawn, if it's the local player and a recording is in progress */
+	static void RecordInput(const APawn* Pawn, EPantherJamInputAction Action, const FVector2f& Value = FVector2f::ZeroVector);
+
+	/** Starts recording the local player's inputs under the given name */
+	void StartRecording(const FString& Name);
+
+	/** Stops recording and writes the recording to disk */
+	void StopRecording();
+
+	/** Plays back the recording with the given name. Returns false if it can't be loaded */
+	bool StartReplay(const FString& Name);
+
+	/** Stops playback and restores the timestep and the player's input */
+	void StopReplay();
+
+	/** Returns true if a recording is being played back */
+	bool IsReplaying() const { return bReplaying; }
+
+	/** Returns the file a recording with the given name is stored in */
+	static FString GetRecordingPath(const FString& Name);
+
+	/** Writes the inputs of each finished step while recording, and plays back the inputs of the current frame */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for this subsystem */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Starts recording or playback if requested on the command line */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Gathers an input reported by the pawn for the current step */
+	void GatherInput(EPantherJamInputAction Action, const FVector2f& Value);
+
+	/** Writes the gathered inputs once the world has moved on to a new step, or right away if flushing */
+	void WriteStepInputs(bool bFlush);
+
+	/** Appends an input to the recording on the given step */
+	void AppendEvent(int32 Frame, EPantherJamInputAction Action, const FVector2f& Value);
+
+	/** Decodes the frame of the next event. Returns false at the end of the recording */
+	bool ReadNextEventFrame();
+
+	/** Decodes the next event and sends it to the pawn, or holds it if it's a move or look value. Returns false if the recording is corrupt */
+	bool PlayNextEvent(IPantherJamInputReplayable* Target);
+};
@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PantherJamInputReplayable.generated.h"
+
+/**
+ *  Player inputs captured by the input recorder. Values are stored in the recording file, so only append to this list
+ */
+enum class EPantherJamInputAction : uint8
+{
+	Move,
+	Look,
+	JumpStart,
+	JumpEnd,
+	ComboAttackStart,
+	ComboAttackEnd,
+	ChargedAttackStart,
+	ChargedAttackEnd,
+	Dash,
+	Drop,
+	Interact,
+	Num
+};
+
+/**
+ *  Input Replayable Interface
+ *  Lets player characters take recorded inputs back through the same entry points their input bindings use
+ */
+UINTERFACE(MinimalAPI, NotBlueprintable)
+class UPantherJamInputReplayable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class IPantherJamInputReplayable
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 *  Performs a recorded input.
+	 *  Axis inputs pass their value, two dimensional ones as (X, Y) in the order the Do* entry point takes them.
+	 *  Inputs the character doesn't have are ignored.
+	 */
+	virtual void ReplayInput(EPantherJamInputAction Action, const FVector2f& Value) = 0;
+};
@@ -0,0 +1,192 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamLoadBenchmarkSubsystem.h"
+#include "CombatPreloadSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPantherJamLoadBenchmark, Log, All);
+
+bool UPantherJamLoadBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString Map;
+
+	return FParse::Value(FCommandLine::Get(), TEXT("PerfLoadMap="), Map);
+}
+
+void UPantherJamLoadBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("PerfLoadMap="), MapName);
+	FParse::Value(FCommandLine::Get(), TEXT("PerfLoadRuns="), RunsPerMode);
+	FParse::Value(FCommandLine::Get(), TEXT("PerfLoadPlayTime="), PlayTime);
+
+	// alternate the modes so neither one always gets the warm file cache
+	Runs.SetNum(FMath::Max(RunsPerMode, 1) * 2);
+
+	for (int32 RunIndex = 0; RunIndex < Runs.Num(); ++RunIndex)
+	{
+		Runs[RunIndex].bAsyncPreload = (RunIndex % 2) == 1;
+	}
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UPantherJamLoadBenchmarkSubsystem::OnPreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UPantherJamLoadBenchmarkSubsystem::OnPostLoadMap);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UPantherJamLoadBenchmarkSubsystem::Tick));
+}
+
+void UPantherJamLoadBenchmarkSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+	Super::Deinitialize();
+}
+
+bool UPantherJamLoadBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	// wait for the startup map before loading ours
+	if (CurrentRun == INDEX_NONE)
+	{
+		if (World && World->HasBegunPlay())
+		{
+			StartRun(0);
+		}
+
+		return true;
+	}
+
+	// still loading
+	if (TimePlayed < 0.0f || !Runs.IsValidIndex(CurrentRun))
+	{
+		return true;
+	}
+
+	// track the hitches while the level starts up
+	FPantherJamLoadRun& Run = Runs[CurrentRun];
+	Run.MaxFrameMs = FMath::Max(Run.MaxFrameMs, DeltaTime * 1000.0);
+
+	TimePlayed += DeltaTime;
+
+	if (TimePlayed >= PlayTime)
+	{
+		FinishRun();
+
+		if (Runs.IsValidIndex(CurrentRun + 1))
+		{
+			StartRun(CurrentRun + 1);
+		}
+		else
+		{
+			FinishBenchmark();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UPantherJamLoadBenchmarkSubsystem::OnPreLoadMap(const FString& LoadingMapName)
+{
+	LoadStartTime = FPlatformTime::Seconds();
+}
+
+void UPantherJamLoadBenchmarkSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (!Runs.IsValidIndex(CurrentRun) || LoadStartTime <= 0.0)
+	{
+		return;
+	}
+
+	Runs[CurrentRun].LoadMs = (FPlatformTime::Seconds() - LoadStartTime) * 1000.0;
+
+	// the first frame after the load is where up front loading pays for BeginPlay, so start counting right away
+	TimePlayed = 0.0f;
+}
+
+void UPantherJamLoadBenchmarkSubsystem::StartRun(int32 RunIndex)
+{
+	CurrentRun = RunIndex;
+	TimePlayed = -1.0f;
+	LoadStartTime = 0.0;
+
+	const bool bAsyncPreload = Runs[RunIndex].bAsyncPreload;
+
+	if (IConsoleVariable* PreloadAsync = IConsoleManager::Get().FindConsoleVariable(TEXT("Combat.Preload.Async")))
+	{
+		PreloadAsync->Set(bAsyncPreload, ECVF_SetByCode);
+	}
+
+	UE_LOG(LogPantherJamLoadBenchmark, Display, TEXT("Load run %d: %s with %s preloading"), RunIndex, *MapName, bAsyncPreload ? TEXT("async") : TEXT("up front"));
+
+	// the previous map's assets are collected as part of the travel
+	UGameplayStatics::OpenLevel(GetGameInstance(), FName(*MapName));
+}
+
+void UPantherJamLoadBenchmarkSubsystem::FinishRun()
+{
+	FPantherJamLoadRun& Run = Runs[CurrentRun];
+
+	if (UWorld* World = GetGameInstance()->GetWorld())
+	{
+		if (UCombatPreloadSubsystem* Preload = World->GetSubsystem<UCombatPreloadSubsystem>())
+		{
+			Run.BlockingLoads = Preload->GetBlockingLoads();
+			Run.BlockingLoadMs = Preload->GetBlockingLoadTimeMs();
+		}
+	}
+
+	UE_LOG(LogPantherJamLoadBenchmark, Display, TEXT("Load run %d: load %.1fms, max frame %.1fms, %d blocking loads for %.1fms"),
+		CurrentRun, Run.LoadMs, Run.MaxFrameMs, Run.BlockingLoads, Run.BlockingLoadMs);
+}
+
+void UPantherJamLoadBenchmarkSubsystem::FinishBenchmark()
+{
+	FString Json = FString::Printf(TEXT("{\n\t\"map\": \"%s\",\n\t\"runs_per_mode\": %d,\n\t\"play_time_s\": %.1f"), *MapName, RunsPerMode, PlayTime);
+
+	// report the best run of each mode
+	for (const bool bAsyncPreload : { false, true })
+	{
+		const FPantherJamLoadRun* BestRun = nullptr;
+
+		for (const FPantherJamLoadRun& Run : Runs)
+		{
+			if (Run.bAsyncPreload == bAsyncPreload && (!BestRun || Run.LoadMs + Run.MaxFrameMs < BestRun->LoadMs + BestRun->MaxFrameMs))
+			{
+				BestRun = &Run;
+			}
+		}
+
+		if (BestRun)
+		{
+			Json += FString::Printf(TEXT(",\n\t\"%s\": { \"load_ms\": %.1f, \"max_frame_ms\": %.1f, \"blocking_loads\": %d, \"blocking_load_ms\": %.1f }"),
+				bAsyncPreload ? TEXT("async_preload") : TEXT("up_front"), BestRun->LoadMs, BestRun->MaxFrameMs, BestRun->BlockingLoads, BestRun->BlockingLoadMs);
+		}
+	}
+
+	Json += TEXT("\n}\n");
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmark"), TEXT("LoadResults.json"));
+	FParse::Value(FCommandLine::Get(), TEXT("PerfOutput="), OutputPath);
+
+	FFileHelper::SaveStringToFile(Json, *OutputPath);
+
+	UE_LOG(LogPantherJamLoadBenchmark, Display, TEXT("Load benchmark results written to %s"), *OutputPath);
+
+	// don't take the editor down with us when running in PIE
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "PantherJamLoadBenchmarkSubsystem.generated.h"
+
+/**
+ *  Results of loading the benchmark map once
+ */
+struct FPantherJamLoadRun
+{
+	/** If true, combat assets were preloaded asynchronously. Otherwise they were loaded up front */
+	bool bAsyncPreload = false;
+
+	/** Time from the start of the map load until the world was ready, in milliseconds */
+	double LoadMs = 0.0;
+
+	/** Longest frame during the play time after the load, in milliseconds */
+	double MaxFrameMs = 0.0;
+
+	/** Number of loads that blocked the game thread during play */
+	int32 BlockingLoads = 0;
+
+	/** Time spent blocking on loads during play, in milliseconds */
+	double BlockingLoadMs = 0.0;
+};
+
+/**
+ *  Map load time benchmark for the combat asset preloading.
+ *  Loads a map several times, alternating between async preloading and up front loading of the soft referenced combat assets,
+ *  and measures the map load time and the hitches and blocking loads during the first seconds of play.
+ *  Writes the best run of each mode to JSON and exits.
+ *
+ *  Usage:
+ *  PantherJam -PerfLoadMap=/Game/Variant_Combat/Lvl_Combat -nullrhi -unattended [-PerfLoadRuns=2] [-PerfLoadPlayTime=10] [-PerfOutput=<file>]
+ */
+UCLASS()
+class UPantherJamLoadBenchmarkSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Map to load */
+	FString MapName;
+
+	/** Number of loads for each mode */
+	int32 RunsPerMode = 2;
+
+	/** Time to play after each load, in seconds */
+	float PlayTime = 10.0f;
+
+	/** Results of each load, alternating between modes */
+	TArray<FPantherJamLoadRun> Runs;
+
+	/** Load currently running */
+	int32 CurrentRun = INDEX_NONE;
+
+	/** Platform time the current map load started at */
+	double LoadStartTime = 0.0;
+
+	/** Time played since the current map finished loading, or a negative value while loading */
+	float TimePlayed = -1.0f;
+
+	/** Ticker handle */
+	FTSTicker::FDelegateHandle TickHandle;
+
+	/** Map load delegate handles */
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+
+public:
+
+	/** Only create the benchmark when asked to on the command line */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Sets up the runs */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Steps the benchmark */
+	bool Tick(float DeltaTime);
+
+	/** Called when a map starts loading */
+	void OnPreLoadMap(const FString& LoadingMapName);
+
+	/** Called when a map has finished loading */
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	/** Switches the preload mode and loads the map for the given run */
+	void StartRun(int32 RunIndex);
+
+	/** Records the play results of the current run */
+	void FinishRun();
+
+	/** Writes the results out and exits */
+	void FinishBenchmark();
+};
@@ -0,0 +1,435 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamMovementComponent.h"
+#include "PantherJamWallProbeComponent.h"
+#include "PantherJamMovementModel.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "PantherJamStats.h"
+
+void UPantherJamMovementComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	// find the wall probe shared with the owner's wall jumps
+	WallProbe = GetOwner() ? GetOwner()->FindComponentByClass<UPantherJamWallProbeComponent>() : nullptr;
+}
+
+bool UPantherJamMovementComponent::IsWallRunning() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == (uint8)EPantherJamMovementMode::WallRun;
+}
+
+bool UPantherJamMovementComponent::IsFalling() const
+{
+	// wall running is an airborne state, so double jumps, wall jumps and animation treat it as falling
+	return Super::IsFalling() || IsWallRunning();
+}
+
+float UPantherJamMovementComponent::GetMaxAcceleration() const
+{
+	// acceleration falls off with speed. Evaluated inside the move so replays accelerate the same way
+	return FPantherJamMovementModel::ComputeMaxAcceleration(Velocity.Size2D());
+}
+
+float UPantherJamMovementComponent::GetCorrectionRate() const
+{
+	return NetStats.MovesSent > 0 ? float(NetStats.Corrections) / float(NetStats.MovesSent) : 0.0f;
+}
+
+float UPantherJamMovementComponent::GetMoveBandwidth() const
+{
+	const double Elapsed = GetWorld() ? GetWorld()->GetTimeSeconds() - NetStats.StartTime : 0.0;
+
+	return Elapsed > 0.0 ? float((NetStats.BitsSent + NetStats.BitsReceived) / 8.0 / Elapsed) : 0.0f;
+}
+
+void UPantherJamMovementComponent::ResetNetStats()
+{
+	NetStats = FPantherJamNetMoveStats();
+	NetStats.StartTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+}
+
+void UPantherJamMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// remember where the input last pointed, so double jumps still have a direction after the stick is released
+	if (!Acceleration.IsNearlyZero())
+	{
+		LastInputDirection = Acceleration.GetSafeNormal2D();
+	}
+
+	// jump requests are one shot, so consume them on the move they were sent with
+	if (bWantsToWallJump)
+	{
+		bWantsToWallJump = false;
+		PerformWallJump();
+	}
+
+	if (bWantsToDoubleJump)
+	{
+		bWantsToDoubleJump = false;
+		PerformDoubleJump();
+	}
+
+	if (IsWallRunning())
+	{
+		// drop off the wall as soon as the input is released
+		if (!bWantsToWallRun)
+		{
+			SetMovementMode(MOVE_Falling);
+		}
+	}
+	else if (bWantsToWallRun && MovementMode == MOVE_Falling)
+	{
+		TryStartWallRun();
+	}
+}
+
+void UPantherJamMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToWallRun = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	bWantsToDoubleJump = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+	bWantsToWallJump = (Flags & FSavedMove_Character::FLAG_Custom_2) != 0;
+}
+
+FNetworkPredictionData_Client* UPantherJamMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UPantherJamMovementComponent* MutableThis = const_cast<UPantherJamMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FPantherJamNetworkPredictionData_Client(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+bool UPantherJamMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	// the client only needs to update its position after a server correction
+	const FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+
+	if (ClientData && ClientData->bUpdatePosition)
+	{
+		++NetStats.Corrections;
+		PANTHERJAM_INC_COUNTER(NetCorrections, 1);
+	}
+
+	return Super::ClientUpdatePositionAfterServerUpdate();
+}
+
+void UPantherJamMovementComponent::ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits)
+{
+	++NetStats.MovesSent;
+	NetStats.BitsSent += PackedBits.DataBits.Num();
+	PANTHERJAM_INC_COUNTER(NetMoveBits, PackedBits.DataBits.Num());
+
+	Super::ServerMovePacked_ClientSend(PackedBits);
+}
+
+void UPantherJamMovementComponent::MoveResponsePacked_ClientReceive(const FCharacterMoveResponsePackedBits& PackedBits)
+{
+	NetStats.BitsReceived += PackedBits.DataBits.Num();
+	PANTHERJAM_INC_COUNTER(NetMoveBits, PackedBits.DataBits.Num());
+
+	Super::MoveResponsePacked_ClientReceive(PackedBits);
+}
+
+void UPantherJamMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == (uint8)EPantherJamMovementMode::WallRun)
+	{
+		PhysWallRun(DeltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysCustom(DeltaTime, Iterations);
+}
+
+void UPantherJamMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	// clear the wall run state once we leave the wall
+	if (!IsWallRunning())
+	{
+		WallRunTime = 0.0f;
+		WallRunNormal = FVector::ZeroVector;
+	}
+}
+
+void UPantherJamMovementComponent::ProcessLanded(const FHitResult& Hit, float RemainingTime, int32 Iterations)
+{
+	bCanDoubleJump = true;
+
+	Super::ProcessLanded(Hit, RemainingTime, Iterations);
+}
+
+void UPantherJamMovementComponent::PerformDoubleJump()
+{
+	if (!IsFalling() || !bCanDoubleJump)
+	{
+		return;
+	}
+
+	// the input direction is built from the acceleration of this and earlier moves
+	const FVector DesiredDir = LastInputDirection;
+
+	if (DesiredDir.IsNearlyZero())
+	{
+		return;
+	}
+
+	bCanDoubleJump = false;
+
+	// apply speed loss based on the angle between current velocity and desired direction
+	FVector LaunchVelocity;
+
+	if (!FPantherJamMovementModel::ComputeDoubleJumpVelocity(Velocity, DesiredDir, LaunchVelocity))
+	{
+		return;
+	}
+
+	Velocity = LaunchVelocity;
+	SetMovementMode(MOVE_Falling);
+}
+
+void UPantherJamMovementComponent::PerformWallJump()
+{
+	if (!IsFalling() || !bCanWallJump || !WallProbe)
+	{
+		return;
+	}
+
+	// check both sides for walls
+	const FPantherJamWallProbeResult Probe = ProbeWalls();
+
+	if (!Probe.HasWall())
+	{
+		return;
+	}
+
+	// reflect velocity against the wall and push away from it
+	Velocity = FPantherJamMovementModel::ComputeWallJumpVelocity(Velocity, Probe.WallNormal);
+	SetMovementMode(MOVE_Falling);
+}
+
+bool UPantherJamMovementComponent::TryStartWallRun()
+{
+	if (!WallProbe || !CharacterOwner)
+	{
+		return false;
+	}
+
+	const FPantherJamWallProbeResult Probe = ProbeWalls();
+
+	if (!Probe.HasWall())
+	{
+		return false;
+	}
+
+	SetMovementMode(MOVE_Custom, (uint8)EPantherJamMovementMode::WallRun);
+
+	WallRunTime = 0.0f;
+	WallRunNormal = Probe.WallNormal;
+
+	// carry our horizontal speed along the wall, and don't start the run moving down
+	const FVector RunDirection = FPantherJamMovementModel::ComputeWallRunDirection(WallRunNormal, UpdatedComponent->GetForwardVector());
+
+	const float Speed = Velocity.Size2D();
+	const float VerticalSpeed = FMath::Max(Velocity.Z, 0.0f);
+
+	Velocity = RunDirection * Speed;
+	Velocity.Z = VerticalSpeed;
+
+	return true;
+}
+
+void UPantherJamMovementComponent::PhysWallRun(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	float RemainingTime = DeltaTime;
+
+	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations && CharacterOwner && UpdatedComponent)
+	{
+		++Iterations;
+
+		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+		RemainingTime -= TimeTick;
+
+		// are we still next to a wall? Each sub-step has moved since the last probe, so don't use the cache
+		const FPantherJamWallProbeResult Probe = ProbeWallsExact();
+
+		if (!Probe.HasWall())
+		{
+			SetMovementMode(MOVE_Falling);
+			StartNewPhysics(RemainingTime + TimeTick, Iterations - 1);
+			return;
+		}
+
+		WallRunTime += TimeTick;
+		WallRunNormal = Probe.WallNormal;
+
+		// run along the wall at our current horizontal speed
+		const FVector RunDirection = FPantherJamMovementModel::ComputeWallRunDirection(WallRunNormal, Velocity.IsNearlyZero() ? UpdatedComponent->GetForwardVector() : Velocity);
+		const float VerticalSpeed = Velocity.Z + GetGravityZ() * FPantherJamMovementModel::ComputeWallRunDrop(WallRunTime) * TimeTick;
+
+		Velocity = RunDirection * Velocity.Size2D();
+		Velocity.Z = VerticalSpeed;
+
+		// ease towards the wall run distance along the wall normal, as part of the same sweep
+		const FVector DesiredLocation = Probe.ImpactPoint + WallRunNormal * FPantherJamMovementModel::WallRunWallDistance;
+		const FVector ToDesired = (DesiredLocation - UpdatedComponent->GetComponentLocation()).ProjectOnToNormal(WallRunNormal);
+		const FVector DistanceCorrection = ToDesired * FMath::Clamp(TimeTick * FPantherJamMovementModel::WallRunDistanceInterpSpeed, 0.0f, 1.0f);
+
+		const FVector Delta = Velocity * TimeTick + DistanceCorrection;
+
+		FHitResult Hit(1.0f);
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+		if (Hit.IsValidBlockingHit())
+		{
+			// land if we ran down onto a floor
+			if (IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), Hit))
+			{
+				RemainingTime += TimeTick * (1.0f - Hit.Time);
+				ProcessLanded(Hit, RemainingTime, Iterations);
+				return;
+			}
+
+			// otherwise slide along whatever we ran into
+			HandleImpact(Hit, TimeTick, Delta);
+			SlideAlongSurface(Delta, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+		}
+	}
+}
+
+FPantherJamWallProbeResult UPantherJamMovementComponent::ProbeWalls()
+{
+	if (!WallProbe || !UpdatedComponent)
+	{
+		return FPantherJamWallProbeResult();
+	}
+
+	// replayed moves happen at past locations within a single frame, so they need their own probes
+	if (CharacterOwner && CharacterOwner->bClientUpdating)
+	{
+		return ProbeWallsExact();
+	}
+
+	return WallProbe->ProbeWalls();
+}
+
+FPantherJamWallProbeResult UPantherJamMovementComponent::ProbeWallsExact() const
+{
+	if (!WallProbe || !UpdatedComponent)
+	{
+		return FPantherJamWallProbeResult();
+	}
+
+	return WallProbe->ProbeWallsAt(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetRightVector());
+}
+
+void FPantherJamSavedMove::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToWallRun = false;
+	bSavedWantsToDoubleJump = false;
+	bSavedWantsToWallJump = false;
+	bSavedCanDoubleJump = true;
+	SavedWallRunTime = 0.0f;
+	SavedWallRunNormal = FVector::ZeroVector;
+	SavedLastInputDirection = FVector::ZeroVector;
+}
+
+uint8 FPantherJamSavedMove::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bSavedWantsToWallRun)
+	{
+		Result |= FLAG_Custom_0;
+	}
+
+	if (bSavedWantsToDoubleJump)
+	{
+		Result |= FLAG_Custom_1;
+	}
+
+	if (bSavedWantsToWallJump)
+	{
+		Result |= FLAG_Custom_2;
+	}
+
+	return Result;
+}
+
+bool FPantherJamSavedMove::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FPantherJamSavedMove* NewPantherJamMove = static_cast<const FPantherJamSavedMove*>(NewMove.Get());
+
+	// don't combine moves across wall run input changes
+	if (bSavedWantsToWallRun != NewPantherJamMove->bSavedWantsToWallRun)
+	{
+		return false;
+	}
+
+	// jump requests must reach the server on their own move
+	if (bSavedWantsToDoubleJump || bSavedWantsToWallJump || NewPantherJamMove->bSavedWantsToDoubleJump || NewPantherJamMove->bSavedWantsToWallJump)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FPantherJamSavedMove::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const UPantherJamMovementComponent* MoveComp = Cast<UPantherJamMovementComponent>(C->GetCharacterMovement()))
+	{
+		bSavedWantsToWallRun = MoveComp->bWantsToWallRun;
+		bSavedWantsToDoubleJump = MoveComp->bWantsToDoubleJump;
+		bSavedWantsToWallJump = MoveComp->bWantsToWallJump;
+		bSavedCanDoubleJump = MoveComp->bCanDoubleJump;
+		SavedWallRunTime = MoveComp->WallRunTime;
+		SavedWallRunNormal = MoveComp->WallRunNormal;
+		SavedLastInputDirection = MoveComp->LastInputDirection;
+	}
+}
+
+void FPantherJamSavedMove::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// restore the wall run and jump state so replayed moves play out the same way. The requests come back through the compressed flags
+	if (UPantherJamMovementComponent* MoveComp = Cast<UPantherJamMovementComponent>(C->GetCharacterMovement()))
+	{
+		MoveComp->bCanDoubleJump = bSavedCanDoubleJump;
+		MoveComp->bWantsToWallRun = bSavedWantsToWallRun;
+		MoveComp->WallRunTime = SavedWallRunTime;
+		MoveComp->WallRunNormal = SavedWallRunNormal;
+		MoveComp->LastInputDirection = SavedLastInputDirection;
+	}
+}
+
+FPantherJamNetworkPredictionData_Client::FPantherJamNetworkPredictionData_Client(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FPantherJamNetworkPredictionData_Client::AllocateNewMove()
+{
+	return FSavedMovePtr(new FPantherJamSavedMove());
+}
@@ -0,0 +1,236 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "PantherJamMovementComponent.generated.h"
+
+class UPantherJamWallProbeComponent;
+struct FPantherJamWallProbeResult;
+
+/**
+ *  Custom movement modes used with MOVE_Custom
+ */
+UENUM(BlueprintType)
+enum class EPantherJamMovementMode : uint8
+{
+	None		UMETA(Hidden),
+	WallRun		UMETA(DisplayName = "Wall Run")
+};
+
+/**
+ *  Movement prediction counters for the owning client, used to measure correction rate and bandwidth
+ */
+USTRUCT(BlueprintType)
+struct FPantherJamNetMoveStats
+{
+	GENERATED_BODY()
+
+	/** Number of moves sent to the server */
+	UPROPERTY(BlueprintReadOnly, Category="Net")
+	int32 MovesSent = 0;
+
+	/** Number of corrections received from the server */
+	UPROPERTY(BlueprintReadOnly, Category="Net")
+	int32 Corrections = 0;
+
+	/** Bits of move data sent to the server */
+	UPROPERTY(BlueprintReadOnly, Category="Net")
+	int64 BitsSent = 0;
+
+	/** Bits of move responses received from the server */
+	UPROPERTY(BlueprintReadOnly, Category="Net")
+	int64 BitsReceived = 0;
+
+	/** World time the counters were last reset */
+	UPROPERTY(BlueprintReadOnly, Category="Net")
+	double StartTime = 0.0;
+};
+
+/**
+ *  Character movement with a native wall run mode and predicted air abilities.
+ *  While the owner holds jump in the air next to a wall, the character switches to MOVE_Custom / WallRun.
+ *  Wall adhesion, gravity falloff and keeping a fixed distance from the wall are all resolved inside
+ *  the wall run physics, in a single movement sweep per step.
+ *  Double jumps and wall jumps are requested by the owner and performed inside the movement update,
+ *  so the wall run input, the jump requests and the jump state are all carried in saved moves.
+ *  Autonomous proxies predict and replay them, and the server runs the same math.
+ */
+UCLASS()
+class UPantherJamMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	friend class FPantherJamSavedMove;
+
+protected:
+
+	/** If true, the owner is holding the wall run input */
+	bool bWantsToWallRun = false;
+
+	/** Time spent in the current wall run */
+	float WallRunTime = 0.0f;
+
+	/** Normal of the wall we're running on */
+	FVector WallRunNormal = FVector::ZeroVector;
+
+	/** If true, the owner requested a double jump for the next move */
+	bool bWantsToDoubleJump = false;
+
+	/** If true, the owner requested a wall jump for the next move */
+	bool bWantsToWallJump = false;
+
+	/** If true, we haven't used up our double jump since we last landed */
+	bool bCanDoubleJump = true;
+
+	/** Direction of the last non-zero input acceleration. Double jumps go this way even after the stick is released */
+	FVector LastInputDirection = FVector::ZeroVector;
+
+	/** If true, wall jumps are allowed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Wall Run")
+	bool bCanWallJump = true;
+
+	/** Movement prediction counters */
+	FPantherJamNetMoveStats NetStats;
+
+	/** Wall probe on the owner, shared with wall jumps */
+	UPROPERTY(Transient)
+	TObjectPtr<UPantherJamWallProbeComponent> WallProbe;
+
+public:
+
+	/** Sets whether the owner is holding the wall run input */
+	void SetWantsToWallRun(bool bWants) { bWantsToWallRun = bWants; }
+
+	/** Requests a double jump towards the last input direction on the next move */
+	void RequestDoubleJump() { bWantsToDoubleJump = true; }
+
+	/** Requests a wall jump off the closest wall on the next move */
+	void RequestWallJump() { bWantsToWallJump = true; }
+
+	/** Returns the movement prediction counters */
+	UFUNCTION(BlueprintPure, Category="Net")
+	const FPantherJamNetMoveStats& GetNetStats() const { return NetStats; }
+
+	/** Returns the fraction of sent moves that were corrected by the server */
+	UFUNCTION(BlueprintPure, Category="Net")
+	float GetCorrectionRate() const;
+
+	/** Returns the movement bandwidth in both directions, in bytes per second */
+	UFUNCTION(BlueprintPure, Category="Net")
+	float GetMoveBandwidth() const;
+
+	/** Resets the movement prediction counters */
+	UFUNCTION(BlueprintCallable, Category="Net")
+	void ResetNetStats();
+
+	/** Returns true if the character is currently wall running */
+	UFUNCTION(BlueprintPure, Category="Wall Run")
+	bool IsWallRunning() const;
+
+	/** Returns the time spent in the current wall run */
+	UFUNCTION(BlueprintPure, Category="Wall Run")
+	float GetWallRunTime() const { return WallRunTime; }
+
+	/** Returns the normal of the wall we're running on */
+	const FVector& GetWallRunNormal() const { return WallRunNormal; }
+
+	// ~begin UCharacterMovementComponent interface
+	virtual void InitializeComponent() override;
+	virtual bool IsFalling() const override;
+	virtual float GetMaxAcceleration() const override;
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+	virtual void ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits) override;
+	virtual void MoveResponsePacked_ClientReceive(const FCharacterMoveResponsePackedBits& PackedBits) override;
+	// ~end UCharacterMovementComponent interface
+
+protected:
+
+	/** Runs the wall run physics */
+	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+
+	/** Resets the wall run state when leaving the wall run mode */
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+
+	/** Restores the double jump on landing */
+	virtual void ProcessLanded(const FHitResult& Hit, float RemainingTime, int32 Iterations) override;
+
+	/** Double jumps towards the last input direction, if we're in the air and still have a double jump */
+	void PerformDoubleJump();
+
+	/** Jumps off the closest wall, if we're in the air next to one */
+	void PerformWallJump();
+
+	/** Starts a wall run if we're in the air next to a wall and the owner wants to wall run. Returns true if we started */
+	bool TryStartWallRun();
+
+	/** Wall run physics: run along the wall, fall with reduced gravity and hold the wall distance */
+	void PhysWallRun(float DeltaTime, int32 Iterations);
+
+	/**
+	 *  Probes for walls through the wall probe's shared, cached and optionally async result.
+	 *  Client replays of saved moves probe synchronously instead, since the cache holds where we are now, not where the move was
+	 */
+	FPantherJamWallProbeResult ProbeWalls();
+
+	/**
+	 *  Probes for walls at the updated component's current location and orientation, never cached or async.
+	 *  Used by the wall run sub-steps, which move between probes and must match the server exactly
+	 */
+	FPantherJamWallProbeResult ProbeWallsExact() const;
+};
+
+/**
+ *  Saved move carrying the wall run input and state
+ */
+class FPantherJamSavedMove : public FSavedMove_Character
+{
+	using Super = FSavedMove_Character;
+
+public:
+
+	/** Wall run input at the time of the move */
+	uint8 bSavedWantsToWallRun : 1;
+
+	/** Double jump request at the time of the move */
+	uint8 bSavedWantsToDoubleJump : 1;
+
+	/** Wall jump request at the time of the move */
+	uint8 bSavedWantsToWallJump : 1;
+
+	/** Double jump availability at the start of the move */
+	uint8 bSavedCanDoubleJump : 1;
+
+	/** Wall run time at the start of the move */
+	float SavedWallRunTime = 0.0f;
+
+	/** Wall run normal at the start of the move */
+	FVector SavedWallRunNormal = FVector::ZeroVector;
+
+	/** Last input direction at the start of the move */
+	FVector SavedLastInputDirection = FVector::ZeroVector;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+/**
+ *  Client prediction data that allocates wall run saved moves
+ */
+class FPantherJamNetworkPredictionData_Client : public FNetworkPredictionData_Client_Character
+{
+	using Super = FNetworkPredictionData_Client_Character;
+
+public:
+
+	FPantherJamNetworkPredictionData_Client(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
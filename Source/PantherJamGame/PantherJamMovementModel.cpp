@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamMovementModel.h"
+
+bool FPantherJamMovementModel::ComputeDoubleJumpVelocity(const FVector& CurrentVelocity, const FVector& DesiredDir, FVector& OutLaunchVelocity)
+{
+	// Current horizontal velocity
+	FVector CurrentVel2D = FVector(CurrentVelocity.X, CurrentVelocity.Y, 0.f);
+	float CurrentSpeed = CurrentVel2D.Size();
+
+	// Angle between current velocity and desired direction
+	float Dot = FVector::DotProduct(CurrentVel2D.GetSafeNormal(), DesiredDir);
+	float AngleDeg = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(Dot, -1.f, 1.f)));
+
+	if (AngleDeg > DoubleJumpMaxAngle)
+	{
+		return false;
+	}
+
+	// Apply speed loss based on angle (0degree = 0% loss, 45degree = 15% loss, 135degree = 80% loss)
+	float SpeedLoss = 0.f;
+	if (AngleDeg <= 45.f)
+	{
+		SpeedLoss = FMath::GetMappedRangeValueClamped(FVector2D(0.f, 45.f), FVector2D(0.f, 0.15f), AngleDeg);
+	}
+	else
+	{
+		SpeedLoss = FMath::GetMappedRangeValueClamped(FVector2D(45.f, DoubleJumpMaxAngle), FVector2D(0.15f, 0.8f), AngleDeg);
+	}
+	float NewSpeed = CurrentSpeed * (1.f - SpeedLoss);
+
+	OutLaunchVelocity = DesiredDir * NewSpeed;
+	OutLaunchVelocity.Z = DoubleJumpZVelocity;
+
+	return true;
+}
+
+float FPantherJamMovementModel::ComputeWallRunDrop(float WallRunTime)
+{
+	float DropTime = FMath::Clamp((WallRunTime - WallRunPredropLength) / WallRunDropLength, 0.f, 1.f);
+	return FMath::InterpEaseIn(0.f, 1.f, DropTime, WallRunDropExponent);
+}
+
+FVector FPantherJamMovementModel::ComputeWallRunDirection(const FVector& WallNormal, const FVector& Facing)
+{
+	// Align along the wall, in the direction we're facing
+	FVector Direction = FVector::CrossProduct(WallNormal, FVector::UpVector);
+	if (FVector::DotProduct(Direction, Facing) < 0)
+	{
+		Direction *= -1.f;
+	}
+
+	return Direction;
+}
+
+FVector FPantherJamMovementModel::ComputeWallJumpVelocity(const FVector& CurrentVelocity, const FVector& WallNormal)
+{
+	// Reflect velocity against wall normal
+	FVector ReflectedVelocity = FVector::VectorPlaneProject(CurrentVelocity, WallNormal) - CurrentVelocity.ProjectOnTo(WallNormal);
+	ReflectedVelocity += WallNormal * WallJumpPushVelocity; // Add some force away from wall
+
+	ReflectedVelocity.Z = WallJumpZVelocity; // Give upward boost for wall jump
+
+	return ReflectedVelocity;
+}
+
+float FPantherJamMovementModel::ComputeMaxAcceleration(float Speed)
+{
+	// Increase movement speed up to a cap
+	if (Speed >= 300.f)
+	{
+		return FMath::GetMappedRangeValueClamped(
+			FVector2D(300.f, 500.f),
+			FVector2D(1500.f, 250.f),
+			Speed
+		);
+	}
+
+	return 10000.f;
+}
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Pure momentum rules for the wall run / double jump character.
+ *  Kept free of any world or actor state so they can be evaluated deterministically
+ *  by the character and by headless movement simulations alike.
+ */
+struct FPantherJamMovementModel
+{
+	/** Double jumps towards a direction sharper than this angle from the current velocity are rejected */
+	static constexpr float DoubleJumpMaxAngle = 135.f;
+
+	/** Vertical launch velocity for double jumps */
+	static constexpr float DoubleJumpZVelocity = 1000.f;
+
+	/** Time before Z falloff while wall running */
+	static constexpr float WallRunPredropLength = 1.f;
+
+	/** Duration of Z falloff while wall running (0% Gravity -> 100% Gravity) */
+	static constexpr float WallRunDropLength = 1.f;
+
+	/** Wall run drop falloff easing exponent */
+	static constexpr float WallRunDropExponent = .5f;
+
+	/** Distance kept between the character and the wall while wall running */
+	static constexpr float WallRunWallDistance = 50.f;
+
+	/** Interpolation speed towards the wall run distance */
+	static constexpr float WallRunDistanceInterpSpeed = 20.f;
+
+	/** Force applied away from the wall on wall jumps */
+	static constexpr float WallJumpPushVelocity = 600.f;
+
+	/** Vertical launch velocity for wall jumps */
+	static constexpr float WallJumpZVelocity = 800.f;
+
+	/**
+	 *  Computes the launch velocity for an air double jump.
+	 *  Returns false if the desired direction is too sharp a turn from the current velocity.
+	 */
+	static bool ComputeDoubleJumpVelocity(const FVector& CurrentVelocity, const FVector& DesiredDir, FVector& OutLaunchVelocity);
+
+	/** Computes the 0-1 scale applied to vertical velocity after WallRunTime seconds of wall running */
+	static float ComputeWallRunDrop(float WallRunTime);
+
+	/** Computes the horizontal direction to run along a wall with the given normal, picking the side closest to the facing direction */
+	static FVector ComputeWallRunDirection(const FVector& WallNormal, const FVector& Facing);
+
+	/** Computes the launch velocity for a wall jump off a wall with the given normal */
+	static FVector ComputeWallJumpVelocity(const FVector& CurrentVelocity, const FVector& WallNormal);
+
+	/** Computes the character's max acceleration for the given horizontal speed */
+	static float ComputeMaxAcceleration(float Speed);
+};
@@ -0,0 +1,415 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamMovementSimCommandlet.h"
+#include "PantherJamGameCharacter.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY(LogPantherJamMovementSim);
+
+UPantherJamMovementSimCommandlet::UPantherJamMovementSimCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UPantherJamMovementSimCommandlet::Main(const FString& Params)
+{
+	int32 WorkerCount = 1;
+	FParse::Value(*Params, TEXT("Workers="), WorkerCount);
+
+	int32 WorkerIndex = INDEX_NONE;
+	FParse::Value(*Params, TEXT("WorkerIndex="), WorkerIndex);
+
+	// the parent process only farms out the sessions to the workers
+	if (WorkerCount > 1 && WorkerIndex == INDEX_NONE)
+	{
+		return RunWorkerProcesses(Params, WorkerCount);
+	}
+
+	FParse::Value(*Params, TEXT("WorkerCount="), WorkerCount);
+
+	return RunSessions(Params, FMath::Max(WorkerIndex, 0), FMath::Max(WorkerCount, 1));
+}
+
+int32 UPantherJamMovementSimCommandlet::RunWorkerProcesses(const FString& Params, int32 WorkerCount) const
+{
+	const FString Executable = FPlatformProcess::ExecutablePath();
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+
+	TArray<FProcHandle> Workers;
+
+	for (int32 WorkerIndex = 0; WorkerIndex < WorkerCount; ++WorkerIndex)
+	{
+		const FString WorkerParams = FString::Printf(TEXT("\"%s\" -run=PantherJamMovementSim %s -WorkerIndex=%d -WorkerCount=%d -nullrhi -unattended -nopause -nosplash"),
+			*ProjectPath, *Params, WorkerIndex, WorkerCount);
+
+		FProcHandle Worker = FPlatformProcess::CreateProc(*Executable, *WorkerParams, false, true, true, nullptr, 0, nullptr, nullptr);
+
+		if (!Worker.IsValid())
+		{
+			UE_LOG(LogPantherJamMovementSim, Error, TEXT("Failed to launch worker %d"), WorkerIndex);
+			continue;
+		}
+
+		Workers.Add(Worker);
+	}
+
+	// wait for all workers and collect their results
+	int32 Result = Workers.Num() == WorkerCount ? 0 : 1;
+
+	for (FProcHandle& Worker : Workers)
+	{
+		FPlatformProcess::WaitForProc(Worker);
+
+		int32 ReturnCode = 0;
+		FPlatformProcess::GetProcReturnCode(Worker, &ReturnCode);
+		FPlatformProcess::CloseProc(Worker);
+
+		if (ReturnCode != 0)
+		{
+			Result = ReturnCode;
+		}
+	}
+
+	UE_LOG(LogPantherJamMovementSim, Display, TEXT("%d workers finished with result %d"), Workers.Num(), Result);
+
+	return Result;
+}
+
+int32 UPantherJamMovementSimCommandlet::RunSessions(const FString& Params, int32 WorkerIndex, int32 WorkerCount)
+{
+	// gather the input streams
+	FString InputPath;
+	if (!FParse::Value(*Params, TEXT("Inputs="), InputPath))
+	{
+		UE_LOG(LogPantherJamMovementSim, Error, TEXT("No input streams given. Use -Inputs=<dir or .csv>"));
+		return 1;
+	}
+
+	TArray<FString> InputFiles;
+
+	if (IFileManager::Get().DirectoryExists(*InputPath))
+	{
+		IFileManager::Get().FindFiles(InputFiles, *FPaths::Combine(InputPath, TEXT("*.csv")), true, false);
+
+		for (FString& InputFile : InputFiles)
+		{
+			InputFile = FPaths::Combine(InputPath, InputFile);
+		}
+	}
+	else
+	{
+		InputFiles.Add(InputPath);
+	}
+
+	// sort the inputs so every worker agrees on the session order
+	InputFiles.Sort();
+
+	FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MovementSim"));
+	FParse::Value(*Params, TEXT("Output="), OutputDir);
+
+	FString CharacterClassPath = DefaultCharacterClass;
+	FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+
+	FString MapName;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+
+	float TickRate = 60.0f;
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+
+	int32 Repeat = 1;
+	FParse::Value(*Params, TEXT("Repeat="), Repeat);
+
+	UClass* CharacterClass = LoadClass<APantherJamGameCharacter>(nullptr, *CharacterClassPath);
+	if (!CharacterClass)
+	{
+		UE_LOG(LogPantherJamMovementSim, Error, TEXT("Could not load character class %s"), *CharacterClassPath);
+		return 1;
+	}
+
+	// lock the engine to a fixed timestep so runs are reproducible
+	const float DeltaTime = 1.0f / FMath::Max(TickRate, 1.0f);
+
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(DeltaTime);
+	FApp::SetDeltaTime(DeltaTime);
+
+	UWorld* World = CreateSimulationWorld(MapName);
+	if (!World)
+	{
+		UE_LOG(LogPantherJamMovementSim, Error, TEXT("Could not create the simulation world"));
+		return 1;
+	}
+
+	FString Summary = TEXT("[\n");
+	int32 SessionIndex = 0;
+	int32 SessionsRun = 0;
+	int32 Result = 0;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (const FString& InputFile : InputFiles)
+	{
+		TArray<FPantherJamSimInputFrame> Frames;
+		const bool bLoaded = LoadInputStream(InputFile, Frames);
+
+		for (int32 Run = 0; Run < Repeat; ++Run, ++SessionIndex)
+		{
+			// skip sessions that belong to other workers
+			if (SessionIndex % WorkerCount != WorkerIndex)
+			{
+				continue;
+			}
+
+			if (!bLoaded)
+			{
+				UE_LOG(LogPantherJamMovementSim, Error, TEXT("Could not read input stream %s"), *InputFile);
+				Result = 1;
+				continue;
+			}
+
+			FString Trajectory;
+			FPantherJamSimTiming Timing;
+
+			if (!RunSession(World, CharacterClass, Frames, DeltaTime, Trajectory, Timing))
+			{
+				UE_LOG(LogPantherJamMovementSim, Error, TEXT("Session %s #%d failed"), *InputFile, Run);
+				Result = 1;
+				continue;
+			}
+
+			const FString SessionName = FString::Printf(TEXT("%s_%d"), *FPaths::GetBaseFilename(InputFile), Run);
+			FFileHelper::SaveStringToFile(Trajectory, *FPaths::Combine(OutputDir, SessionName + TEXT(".csv")));
+
+			Summary += FString::Printf(TEXT("%s\t{ \"session\": \"%s\", \"frames\": %d, \"total_tick_ms\": %.4f, \"mean_tick_ms\": %.4f, \"max_tick_ms\": %.4f, \"final_location\": [%.3f, %.3f, %.3f] }"),
+				SessionsRun > 0 ? TEXT(",\n") : TEXT(""),
+				*SessionName,
+				Timing.Frames,
+				Timing.TotalTickMs,
+				Timing.Frames > 0 ? Timing.TotalTickMs / Timing.Frames : 0.0,
+				Timing.MaxTickMs,
+				Timing.FinalLocation.X, Timing.FinalLocation.Y, Timing.FinalLocation.Z);
+
+			++SessionsRun;
+		}
+	}
+
+	Summary += TEXT("\n]\n");
+	FFileHelper::SaveStringToFile(Summary, *FPaths::Combine(OutputDir, FString::Printf(TEXT("Summary_%d.json"), WorkerIndex)));
+
+	DestroySimulationWorld(World);
+
+	UE_LOG(LogPantherJamMovementSim, Display, TEXT("Worker %d ran %d sessions in %.2fs"), WorkerIndex, SessionsRun, FPlatformTime::Seconds() - StartTime);
+
+	return Result;
+}
+
+UWorld* UPantherJamMovementSimCommandlet::CreateSimulationWorld(const FString& MapName) const
+{
+	const UWorld::InitializationValues InitValues = UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.RequiresHitProxies(false)
+		.CreatePhysicsScene(true)
+		.CreateNavigation(false)
+		.CreateAISystem(false)
+		.ShouldSimulatePhysics(true)
+		.SetTransactional(false);
+
+	UWorld* World = nullptr;
+
+	if (MapName.IsEmpty())
+	{
+		// build an empty world and fill it with the corridor
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("PantherJamMovementSim"), nullptr, true, ERHIFeatureLevel::Num, &InitValues);
+	}
+	else
+	{
+		UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+		World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		World->AddToRoot();
+		World->WorldType = EWorldType::Game;
+		World->InitWorld(InitValues);
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->UpdateWorldComponents(true, false);
+
+	if (MapName.IsEmpty())
+	{
+		BuildCorridor(World);
+	}
+
+	World->InitializeActorsForPlay(FURL());
+
+	// there's no game mode to start play, so begin play directly through the world settings
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	return World;
+}
+
+void UPantherJamMovementSimCommandlet::BuildCorridor(UWorld* World) const
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	check(CubeMesh);
+
+	// the basic cube is 100 units to a side, centered on its origin
+	auto SpawnBlock = [World, CubeMesh](const FVector& Center, const FVector& Size)
+	{
+		AStaticMeshActor* Block = World->SpawnActor<AStaticMeshActor>(Center, FRotator::ZeroRotator);
+		Block->SetMobility(EComponentMobility::Movable);
+		Block->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+		Block->SetActorScale3D(Size / 100.0f);
+	};
+
+	// floor, with its top surface at Z = 0
+	SpawnBlock(FVector(CorridorLength * 0.5f, 0.0f, -50.0f), FVector(CorridorLength, CorridorHalfWidth * 2.0f + 200.0f, 100.0f));
+
+	// walls on either side of the corridor
+	SpawnBlock(FVector(CorridorLength * 0.5f, -CorridorHalfWidth - 50.0f, CorridorWallHeight * 0.5f), FVector(CorridorLength, 100.0f, CorridorWallHeight));
+	SpawnBlock(FVector(CorridorLength * 0.5f, CorridorHalfWidth + 50.0f, CorridorWallHeight * 0.5f), FVector(CorridorLength, 100.0f, CorridorWallHeight));
+}
+
+void UPantherJamMovementSimCommandlet::DestroySimulationWorld(UWorld* World) const
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+bool UPantherJamMovementSimCommandlet::LoadInputStream(const FString& Path, TArray<FPantherJamSimInputFrame>& OutFrames) const
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		return false;
+	}
+
+	OutFrames.Reserve(Lines.Num());
+
+	for (const FString& Line : Lines)
+	{
+		// skip empty lines, comments and headers
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")) || FChar::IsAlpha(Line[0]))
+		{
+			continue;
+		}
+
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT(","));
+
+		if (Fields.Num() < 4)
+		{
+			continue;
+		}
+
+		FPantherJamSimInputFrame& Frame = OutFrames.AddDefaulted_GetRef();
+		Frame.Move.X = FCString::Atof(*Fields[0]);
+		Frame.Move.Y = FCString::Atof(*Fields[1]);
+		Frame.ControlYaw = FCString::Atof(*Fields[2]);
+		Frame.bJump = FCString::Atoi(*Fields[3]) != 0;
+	}
+
+	return true;
+}
+
+bool UPantherJamMovementSimCommandlet::RunSession(UWorld* World, UClass* CharacterClass, const TArray<FPantherJamSimInputFrame>& Frames, float DeltaTime, FString& OutTrajectory, FPantherJamSimTiming& OutTiming) const
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	// start at the beginning of the corridor, facing down it
+	const FVector StartLocation(100.0f, 0.0f, 100.0f);
+
+	APantherJamGameCharacter* Character = World->SpawnActor<APantherJamGameCharacter>(CharacterClass, StartLocation, FRotator::ZeroRotator, SpawnParams);
+	APantherJamSimController* Controller = World->SpawnActor<APantherJamSimController>();
+
+	if (!Character || !Controller)
+	{
+		return false;
+	}
+
+	Controller->Possess(Character);
+
+	OutTrajectory = TEXT("Frame,X,Y,Z,VelocityX,VelocityY,VelocityZ,WallRunning,Falling\n");
+	OutTrajectory.Reserve(Frames.Num() * 96);
+
+	bool bJumpHeld = false;
+
+	for (int32 FrameIndex = 0; FrameIndex < Frames.Num(); ++FrameIndex)
+	{
+		const FPantherJamSimInputFrame& Frame = Frames[FrameIndex];
+
+		Controller->SetControlRotation(FRotator(0.0f, Frame.ControlYaw, 0.0f));
+
+		// enhanced input only triggers move actions for non-zero input.
+		// Go through the same handlers as the input bindings, since the move binding adds its own movement input
+		if (!Frame.Move.IsNearlyZero())
+		{
+			Character->ReplayInput(EPantherJamInputAction::Move, FVector2f(Frame.Move));
+		}
+
+		// only press or release jump on input edges
+		if (Frame.bJump != bJumpHeld)
+		{
+			Character->ReplayInput(Frame.bJump ? EPantherJamInputAction::JumpStart : EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+
+			bJumpHeld = Frame.bJump;
+		}
+
+		// tick the world and time it
+		const double TickStart = FPlatformTime::Seconds();
+
+		World->Tick(LEVELTICK_All, DeltaTime);
+
+		const double TickMs = (FPlatformTime::Seconds() - TickStart) * 1000.0;
+		OutTiming.TotalTickMs += TickMs;
+		OutTiming.MaxTickMs = FMath::Max(OutTiming.MaxTickMs, TickMs);
+
+		// the engine loop normally advances the frame counter, which per-frame caches rely on
+		++GFrameCounter;
+
+		const FVector Location = Character->GetActorLocation();
+		const FVector Velocity = Character->GetVelocity();
+
+		OutTrajectory += FString::Printf(TEXT("%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d\n"),
+			FrameIndex,
+			Location.X, Location.Y, Location.Z,
+			Velocity.X, Velocity.Y, Velocity.Z,
+			Character->IsWallRunning() ? 1 : 0,
+			Character->GetCharacterMovement()->IsFalling() ? 1 : 0);
+	}
+
+	OutTiming.Frames = Frames.Num();
+	OutTiming.FinalLocation = Character->GetActorLocation();
+
+	// clean up so the next session starts from the same world state
+	Controller->UnPossess();
+	Character->Destroy();
+	Controller->Destroy();
+
+	return true;
+}
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GameFramework/Controller.h"
+#include "PantherJamMovementSimCommandlet.generated.h"
+
+class APantherJamGameCharacter;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogPantherJamMovementSim, Log, All);
+
+/**
+ *  A single frame of recorded movement input
+ */
+struct FPantherJamSimInputFrame
+{
+	/** Move input, as passed to the move binding (X = right, Y = forward) */
+	FVector2D Move = FVector2D::ZeroVector;
+
+	/** Control rotation yaw for this frame */
+	float ControlYaw = 0.0f;
+
+	/** If true, the jump button is held on this frame */
+	bool bJump = false;
+};
+
+/**
+ *  Timing results for a single simulation session
+ */
+struct FPantherJamSimTiming
+{
+	/** Number of simulated frames */
+	int32 Frames = 0;
+
+	/** Total world tick time, in milliseconds */
+	double TotalTickMs = 0.0;
+
+	/** Slowest world tick, in milliseconds */
+	double MaxTickMs = 0.0;
+
+	/** Character location at the end of the session */
+	FVector FinalLocation = FVector::ZeroVector;
+};
+
+/**
+ *  Minimal controller used to possess simulated characters and hold their control rotation
+ */
+UCLASS(NotBlueprintable, Transient)
+class APantherJamSimController : public AController
+{
+	GENERATED_BODY()
+};
+
+/**
+ *  Headless, fixed timestep movement simulation.
+ *  Drives the wall run / double jump character with recorded input streams and writes
+ *  a trajectory per run, plus a timing summary per worker.
+ *
+ *  Usage:
+ *  UnrealEditor-Cmd PantherJam.uproject -run=PantherJamMovementSim -nullrhi -unattended
+ *      -Inputs=<dir or .csv> [-Output=<dir>] [-Character=<class path>] [-Map=<map>]
+ *      [-TickRate=60] [-Repeat=1] [-Workers=1]
+ *
+ *  Input files are CSVs with one frame per line: MoveX,MoveY,ControlYaw,Jump
+ *  When no map is given, the simulation runs in a generated corridor with a wall on each side.
+ */
+UCLASS()
+class UPantherJamMovementSimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Character class to simulate, if none is passed on the command line */
+	UPROPERTY()
+	FString DefaultCharacterClass = TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C");
+
+	/** Half width of the generated corridor */
+	UPROPERTY()
+	float CorridorHalfWidth = 150.0f;
+
+	/** Length of the generated corridor */
+	UPROPERTY()
+	float CorridorLength = 20000.0f;
+
+	/** Height of the generated corridor walls */
+	UPROPERTY()
+	float CorridorWallHeight = 1000.0f;
+
+public:
+
+	/** Constructor */
+	UPantherJamMovementSimCommandlet();
+
+	/** Commandlet entry point */
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	/** Launches child processes to run each worker's share of the sessions and waits for them to finish */
+	int32 RunWorkerProcesses(const FString& Params, int32 WorkerCount) const;
+
+	/** Runs every session assigned to the given worker */
+	int32 RunSessions(const FString& Params, int32 WorkerIndex, int32 WorkerCount);
+
+	/** Loads the given map, or builds a corridor if no map is given, and prepares it for play */
+	UWorld* CreateSimulationWorld(const FString& MapName) const;
+
+	/** Spawns the floor and walls of the generated corridor */
+	void BuildCorridor(UWorld* World) const;
+
+	/** Tears down the simulation world */
+	void DestroySimulationWorld(UWorld* World) const;
+
+	/** Parses a recorded input stream. Returns false if the file can't be read */
+	bool LoadInputStream(const FString& Path, TArray<FPantherJamSimInputFrame>& OutFrames) const;
+
+	/** Runs a single session, appending the trajectory as CSV */
+	bool RunSession(UWorld* World, UClass* CharacterClass, const TArray<FPantherJamSimInputFrame>& Frames, float DeltaTime, FString& OutTrajectory, FPantherJamSimTiming& OutTiming) const;
+};
@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamPlayerSnapshotSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+UPantherJamPlayerSnapshotSubsystem* UPantherJamPlayerSnapshotSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+
+	return World ? World->GetSubsystem<UPantherJamPlayerSnapshotSubsystem>() : nullptr;
+}
+
+const TArray<FPantherJamPlayerSnapshot>& UPantherJamPlayerSnapshotSubsystem::GetPlayers()
+{
+	RefreshIfStale();
+
+	return Players;
+}
+
+const FPantherJamPlayerSnapshot* UPantherJamPlayerSnapshotSubsystem::GetPlayer(int32 PlayerIndex)
+{
+	RefreshIfStale();
+
+	if (!Players.IsValidIndex(PlayerIndex) || !Players[PlayerIndex].GetPawn())
+	{
+		return nullptr;
+	}
+
+	return &Players[PlayerIndex];
+}
+
+const FPantherJamPlayerSnapshot* UPantherJamPlayerSnapshotSubsystem::FindClosestPlayer(const FVector& Location)
+{
+	RefreshIfStale();
+
+	const FPantherJamPlayerSnapshot* ClosestPlayer = nullptr;
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+
+	for (const FPantherJamPlayerSnapshot& Player : Players)
+	{
+		// skip players without a pawn
+		if (!Player.GetPawn())
+		{
+			continue;
+		}
+
+		const double DistanceSquared = FVector::DistSquared(Location, Player.Location);
+
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestPlayer = &Player;
+		}
+	}
+
+	return ClosestPlayer;
+}
+
+void UPantherJamPlayerSnapshotSubsystem::RefreshIfStale()
+{
+	// only refresh once per frame
+	if (bHasRefreshed && LastRefreshFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	LastRefreshFrame = GFrameCounter;
+	bHasRefreshed = true;
+
+	Players.Reset();
+
+	// walk the player controllers in the same order GetPlayerPawn uses, so the player indices match
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		FPantherJamPlayerSnapshot& Player = Players.AddDefaulted_GetRef();
+
+		const APlayerController* PlayerController = Iterator->Get();
+		APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+		if (PlayerPawn)
+		{
+			Player.Pawn = PlayerPawn;
+			Player.Location = PlayerPawn->GetActorLocation();
+			Player.Velocity = PlayerPawn->GetVelocity();
+		}
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PantherJamPlayerSnapshotSubsystem.generated.h"
+
+class APawn;
+
+/**
+ *  Cached state of a single player's pawn
+ */
+struct FPantherJamPlayerSnapshot
+{
+	/** Pawn possessed by the player. May be null if the player isn't possessing anything */
+	TWeakObjectPtr<APawn> Pawn;
+
+	/** Pawn location at the time of the snapshot */
+	FVector Location = FVector::ZeroVector;
+
+	/** Pawn velocity at the time of the snapshot */
+	FVector Velocity = FVector::ZeroVector;
+
+	/** Returns the pawn if it's still valid */
+	APawn* GetPawn() const { return Pawn.Get(); }
+};
+
+/**
+ *  Publishes a snapshot of every player's pawn, location and velocity once per frame,
+ *  so AI tasks and queries don't need to look up the player pawns and their transforms individually.
+ *  Snapshots are indexed by player index, same as UGameplayStatics::GetPlayerPawn.
+ */
+UCLASS()
+class UPantherJamPlayerSnapshotSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Player snapshots, indexed by player index */
+	TArray<FPantherJamPlayerSnapshot> Players;
+
+	/** Frame number the snapshots were last refreshed on */
+	uint64 LastRefreshFrame = 0;
+
+	/** If true, the snapshots have been refreshed at least once */
+	bool bHasRefreshed = false;
+
+public:
+
+	/** Returns the subsystem for the given world context object's world */
+	static UPantherJamPlayerSnapshotSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Returns the snapshots for all players this frame, indexed by player index */
+	const TArray<FPantherJamPlayerSnapshot>& GetPlayers();
+
+	/** Returns the snapshot for the given player index this frame, or nullptr if there's no pawn for that player */
+	const FPantherJamPlayerSnapshot* GetPlayer(int32 PlayerIndex);
+
+	/** Returns the snapshot for the player pawn closest to the given location this frame, or nullptr if there are no player pawns */
+	const FPantherJamPlayerSnapshot* FindClosestPlayer(const FVector& Location);
+
+protected:
+
+	/** Refreshes the snapshots if they're from a previous frame */
+	void RefreshIfStale();
+};
@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+
+/**
+ *  Switch for presentation-only work such as life bars, cameras and cosmetic Blueprint events.
+ *  Presentation is compiled out of server targets, and skipped at runtime on dedicated servers run from other targets.
+ */
+struct FPantherJamPresentation
+{
+	/** Returns true if the world the object lives in presents anything to a player */
+	static bool IsEnabled(const UObject* WorldContextObject)
+	{
+#if UE_SERVER
+		return false;
+#else
+		const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+
+		return !World || World->GetNetMode() != NM_DedicatedServer;
+#endif
+	}
+
+	/** Stops a presentation-only component from ticking or rendering. The component is kept so Blueprint defaults still resolve */
+	static void DisableComponent(UActorComponent* Component)
+	{
+		if (!Component)
+		{
+			return;
+		}
+
+		Component->SetComponentTickEnabled(false);
+		Component->Deactivate();
+
+		if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+		{
+			SceneComponent->SetVisibility(false);
+		}
+	}
+};
@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamStats.h"
+
+DEFINE_STAT(STAT_PantherJamCharacterTick);
+DEFINE_STAT(STAT_PantherJamWallProbe);
+DEFINE_STAT(STAT_PantherJamAttackTrace);
+DEFINE_STAT(STAT_PantherJamAttackTraceFlush);
+DEFINE_STAT(STAT_PantherJamDamageFlush);
+DEFINE_STAT(STAT_PantherJamMultiJump);
+DEFINE_STAT(STAT_PantherJamCameraUpdate);
+DEFINE_STAT(STAT_PantherJamStateTreeTask);
+DEFINE_STAT(STAT_PantherJamMontageSchedule);
+DEFINE_STAT(STAT_PantherJamSpawnQueue);
+DEFINE_STAT(STAT_PantherJamRespawnInPlace);
+DEFINE_STAT(STAT_PantherJamRespawnSpawn);
+DEFINE_STAT(STAT_PantherJamCheckpointSave);
+DEFINE_STAT(STAT_PantherJamCheckpointRestore);
+DEFINE_STAT(STAT_PantherJamLifeBarUpdate);
+DEFINE_STAT(STAT_PantherJamLifeBarPaint);
+DEFINE_STAT(STAT_PantherJamFloorProfileBake);
+DEFINE_STAT(STAT_PantherJamPickupField);
+
+DEFINE_STAT(STAT_PantherJamTraces);
+DEFINE_STAT(STAT_PantherJamDamageEvents);
+DEFINE_STAT(STAT_PantherJamQueuedHits);
+DEFINE_STAT(STAT_PantherJamCoalescedHits);
+DEFINE_STAT(STAT_PantherJamNetCorrections);
+DEFINE_STAT(STAT_PantherJamNetMoveBits);
+DEFINE_STAT(STAT_PantherJamSpawns);
+DEFINE_STAT(STAT_PantherJamStateTreeTransitions);
+DEFINE_STAT(STAT_PantherJamScheduledMontages);
+DEFINE_STAT(STAT_PantherJamRagdollBodies);
+DEFINE_STAT(STAT_PantherJamFrozenRagdolls);
+DEFINE_STAT(STAT_PantherJamDegradedHitReactions);
+DEFINE_STAT(STAT_PantherJamSpawnQueueDepth);
+DEFINE_STAT(STAT_PantherJamBlockingLoads);
+DEFINE_STAT(STAT_PantherJamLifeBarWidgets);
+DEFINE_STAT(STAT_PantherJamLifeBarsDrawn);
+DEFINE_STAT(STAT_PantherJamFloorProfileMismatches);
+DEFINE_STAT(STAT_PantherJamSoftCollisionUpdates);
+DEFINE_STAT(STAT_PantherJamSoftCollisionUpdatesAvoided);
+DEFINE_STAT(STAT_PantherJamPickupFieldCandidates);
+
+DEFINE_STAT(STAT_PantherJamPhysicsStep);
+DEFINE_STAT(STAT_PantherJamSpawnQueueLatency);
+DEFINE_STAT(STAT_PantherJamBlockingLoadTime);
+
+CSV_DEFINE_CATEGORY(PantherJam, true);
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+/**
+ *  Game thread stats for the gameplay hot paths, shown with "stat PantherJam".
+ *  The same scopes and counters are emitted to Unreal Insights and to the PantherJam CSV profiler category.
+ */
+DECLARE_STATS_GROUP(TEXT("PantherJam"), STATGROUP_PantherJam, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Tick"), STAT_PantherJamCharacterTick, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wall Probe"), STAT_PantherJamWallProbe, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attack Trace"), STAT_PantherJamAttackTrace, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attack Trace Flush"), STAT_PantherJamAttackTraceFlush, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Damage Flush"), STAT_PantherJamDamageFlush, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Multi Jump"), STAT_PantherJamMultiJump, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Camera Update"), STAT_PantherJamCameraUpdate, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("StateTree Tasks"), STAT_PantherJamStateTreeTask, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Montage Schedule"), STAT_PantherJamMontageSchedule, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Queue"), STAT_PantherJamSpawnQueue, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Respawn In Place"), STAT_PantherJamRespawnInPlace, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Respawn Destroy And Spawn"), STAT_PantherJamRespawnSpawn, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Checkpoint Save"), STAT_PantherJamCheckpointSave, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Checkpoint Restore"), STAT_PantherJamCheckpointRestore, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Life Bar Update"), STAT_PantherJamLifeBarUpdate, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Life Bar Paint"), STAT_PantherJamLifeBarPaint, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Floor Profile Bake"), STAT_PantherJamFloorProfileBake, STATGROUP_PantherJam, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pickup Field"), STAT_PantherJamPickupField, STATGROUP_PantherJam, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scene Queries"), STAT_PantherJamTraces, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Damage Events"), STAT_PantherJamDamageEvents, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Queued Hits"), STAT_PantherJamQueuedHits, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalesced Hits"), STAT_PantherJamCoalescedHits, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net Corrections"), STAT_PantherJamNetCorrections, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net Move Bits"), STAT_PantherJamNetMoveBits, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawns"), STAT_PantherJamSpawns, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("StateTree Transitions"), STAT_PantherJamStateTreeTransitions, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scheduled Montages"), STAT_PantherJamScheduledMontages, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ragdoll Bodies"), STAT_PantherJamRagdollBodies, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Frozen Ragdolls"), STAT_PantherJamFrozenRagdolls, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Degraded Hit Reactions"), STAT_PantherJamDegradedHitReactions, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawn Queue Depth"), STAT_PantherJamSpawnQueueDepth, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blocking Loads"), STAT_PantherJamBlockingLoads, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Life Bar Widgets"), STAT_PantherJamLifeBarWidgets, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Life Bars Drawn"), STAT_PantherJamLifeBarsDrawn, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Floor Profile Mismatches"), STAT_PantherJamFloorProfileMismatches, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Soft Collision Updates"), STAT_PantherJamSoftCollisionUpdates, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Soft Collision Updates Avoided"), STAT_PantherJamSoftCollisionUpdatesAvoided, STATGROUP_PantherJam, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pickup Field Candidates"), STAT_PantherJamPickupFieldCandidates, STATGROUP_PantherJam, );
+
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Physics Step (ms)"), STAT_PantherJamPhysicsStep, STATGROUP_PantherJam, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Spawn Queue Latency (ms)"), STAT_PantherJamSpawnQueueLatency, STATGROUP_PantherJam, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Blocking Load Time (ms)"), STAT_PantherJamBlockingLoadTime, STATGROUP_PantherJam, );
+
+CSV_DECLARE_CATEGORY_EXTERN(PantherJam);
+
+/** Times the enclosing scope under STAT_PantherJam<Name>, in stats, Insights and the CSV profiler */
+#define PANTHERJAM_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_PantherJam##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(PantherJam_##Name); \
+	CSV_SCOPED_TIMING_STAT(PantherJam, Name)
+
+/** Adds to the per-frame STAT_PantherJam<Name> counter, in stats and the CSV profiler. Game thread only */
+#define PANTHERJAM_INC_COUNTER(Name, Amount) \
+	INC_DWORD_STAT_BY(STAT_PantherJam##Name, Amount); \
+	CSV_CUSTOM_STAT(PantherJam, Name, (int32)(Amount), ECsvCustomStatOp::Accumulate)
+
+/** Adds to the per-frame STAT_PantherJam<Name> float counter, in stats and the CSV profiler. Game thread only */
+#define PANTHERJAM_INC_FLOAT_COUNTER(Name, Amount) \
+	INC_FLOAT_STAT_BY(STAT_PantherJam##Name, Amount); \
+	CSV_CUSTOM_STAT(PantherJam, Name, (float)(Amount), ECsvCustomStatOp::Accumulate)
@@ -0,0 +1,311 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamWallProbeComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "CollisionQueryParams.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/HitResult.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "PantherJamStats.h"
+
+UPantherJamWallProbeComponent::UPantherJamWallProbeComponent()
+{
+	// probes are pulled on demand by the owner, so we never need to tick
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+const FPantherJamWallProbeResult& UPantherJamWallProbeComponent::ProbeWalls()
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(WallProbe);
+
+	const AActor* Owner = GetOwner();
+	check(Owner);
+
+	const FVector Location = Owner->GetActorLocation();
+	const FVector RightVector = Owner->GetActorRightVector();
+
+	// can we serve this request from the cache?
+	if (CanReuseCachedResult(Location, RightVector))
+	{
+		++CacheHits;
+
+		// slide the impact point along the wall plane so wall distance checks stay accurate
+		if (CachedResult.HasWall())
+		{
+			CachedResult.ImpactPoint += FVector::VectorPlaneProject(Location - CachedLocation, CachedResult.WallNormal);
+		}
+
+		CachedLocation = Location;
+		CachedFrame = GFrameCounter;
+
+		return CachedResult;
+	}
+
+	++CacheMisses;
+
+	FPantherJamWallProbeResult NewResult;
+	bool bResolved = false;
+
+	// try to use the async probe from the last frame, then queue up the next one
+	if (ShouldUseAsyncProbe())
+	{
+		bResolved = ConsumeAsyncProbe(Location, NewResult);
+
+		if (bResolved)
+		{
+			++AsyncResults;
+		}
+
+		IssueAsyncProbe(Location, RightVector);
+	}
+
+	// run the scene queries right away if we have no async result
+	if (!bResolved)
+	{
+		if (bUseOverlapProbe)
+		{
+			ProbeWithOverlap(Location, RightVector, NewResult);
+		}
+		else
+		{
+			ProbeWithTraces(Location, RightVector, NewResult);
+		}
+	}
+
+	// save the result for the next requests
+	CachedResult = NewResult;
+	CachedLocation = Location;
+	CachedRightVector = RightVector;
+	CachedFrame = GFrameCounter;
+	bHasCachedResult = true;
+
+	return CachedResult;
+}
+
+FPantherJamWallProbeResult UPantherJamWallProbeComponent::ProbeWallsAt(const FVector& Location, const FVector& RightVector) const
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(WallProbe);
+
+	FPantherJamWallProbeResult Result;
+
+	if (bUseOverlapProbe)
+	{
+		ProbeWithOverlap(Location, RightVector, Result);
+	}
+	else
+	{
+		ProbeWithTraces(Location, RightVector, Result);
+	}
+
+	return Result;
+}
+
+void UPantherJamWallProbeComponent::InvalidateCache()
+{
+	bHasCachedResult = false;
+}
+
+void UPantherJamWallProbeComponent::ResetCounters()
+{
+	CacheHits = 0;
+	CacheMisses = 0;
+	AsyncResults = 0;
+}
+
+void UPantherJamWallProbeComponent::SetUseAsyncProbe(bool bEnabled)
+{
+	bUseAsyncProbe = bEnabled;
+
+	// drop any in-flight probe so we don't consume it after switching modes
+	bHasPendingProbe = false;
+}
+
+bool UPantherJamWallProbeComponent::CanReuseCachedResult(const FVector& Location, const FVector& RightVector) const
+{
+	if (!bHasCachedResult)
+	{
+		return false;
+	}
+
+	// share the result between callers in the same frame, as long as the owner hasn't moved since
+	if (CachedFrame == GFrameCounter && Location.Equals(CachedLocation) && RightVector.Equals(CachedRightVector))
+	{
+		return true;
+	}
+
+	// has the owner moved too far since the last probe?
+	if (FVector::DistSquared(Location, CachedLocation) > FMath::Square(ReuseDistance))
+	{
+		return false;
+	}
+
+	// has the owner turned too far since the last probe?
+	return FVector::DotProduct(RightVector, CachedRightVector) >= FMath::Cos(FMath::DegreesToRadians(ReuseAngle));
+}
+
+bool UPantherJamWallProbeComponent::ShouldUseAsyncProbe() const
+{
+	// overlap probes need the game thread to find the closest point on each shape
+	if (!bUseAsyncProbe || bUseOverlapProbe)
+	{
+		return false;
+	}
+
+	// fall back to sync traces when a frame of latency would put us too far from the probe location
+	return GetOwner()->GetVelocity().SizeSquared() <= FMath::Square(AsyncMaxSpeed);
+}
+
+void UPantherJamWallProbeComponent::IssueAsyncProbe(const FVector& Location, const FVector& RightVector)
+{
+	// only issue one async probe per frame
+	if (bHasPendingProbe && PendingFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PantherJamWallProbeAsync), false, GetOwner());
+
+	PANTHERJAM_INC_COUNTER(Traces, 2);
+
+	PendingLeftTrace = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Location, Location - RightVector * ProbeDistance, ProbeChannel, QueryParams);
+	PendingRightTrace = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Location, Location + RightVector * ProbeDistance, ProbeChannel, QueryParams);
+
+	PendingLocation = Location;
+	PendingFrame = GFrameCounter;
+	bHasPendingProbe = true;
+}
+
+bool UPantherJamWallProbeComponent::ConsumeAsyncProbe(const FVector& Location, FPantherJamWallProbeResult& OutResult)
+{
+	// async results only become available on the frame after they're issued
+	if (!bHasPendingProbe || PendingFrame == GFrameCounter)
+	{
+		return false;
+	}
+
+	bHasPendingProbe = false;
+
+	// the trace data is discarded if we waited more than a frame to read it
+	FTraceDatum LeftDatum, RightDatum;
+	if (!GetWorld()->QueryTraceData(PendingLeftTrace, LeftDatum) || !GetWorld()->QueryTraceData(PendingRightTrace, RightDatum))
+	{
+		return false;
+	}
+
+	const FHitResult* LeftHit = LeftDatum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	const FHitResult* RightHit = RightDatum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+
+	OutResult.bLeftWall = LeftHit != nullptr;
+	OutResult.bRightWall = RightHit != nullptr;
+
+	// left walls take priority
+	if (const FHitResult* WallHit = LeftHit ? LeftHit : RightHit)
+	{
+		OutResult.WallNormal = WallHit->ImpactNormal;
+
+		// slide the impact point along the wall plane to account for the movement since the probe was issued
+		OutResult.ImpactPoint = WallHit->ImpactPoint + FVector::VectorPlaneProject(Location - PendingLocation, WallHit->ImpactNormal);
+	}
+
+	return true;
+}
+
+void UPantherJamWallProbeComponent::ProbeWithTraces(const FVector& Location, const FVector& RightVector, FPantherJamWallProbeResult& OutResult) const
+{
+	const FVector LeftEnd = Location - RightVector * ProbeDistance;
+	const FVector RightEnd = Location + RightVector * ProbeDistance;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PantherJamWallProbe), false, GetOwner());
+
+	PANTHERJAM_INC_COUNTER(Traces, 2);
+
+	FHitResult LeftHit, RightHit;
+	OutResult.bLeftWall = GetWorld()->LineTraceSingleByChannel(LeftHit, Location, LeftEnd, ProbeChannel, QueryParams);
+	OutResult.bRightWall = GetWorld()->LineTraceSingleByChannel(RightHit, Location, RightEnd, ProbeChannel, QueryParams);
+
+	// left walls take priority
+	if (OutResult.bLeftWall)
+	{
+		OutResult.WallNormal = LeftHit.ImpactNormal;
+		OutResult.ImpactPoint = LeftHit.ImpactPoint;
+	}
+	else if (OutResult.bRightWall)
+	{
+		OutResult.WallNormal = RightHit.ImpactNormal;
+		OutResult.ImpactPoint = RightHit.ImpactPoint;
+	}
+}
+
+void UPantherJamWallProbeComponent::ProbeWithOverlap(const FVector& Location, const FVector& RightVector, FPantherJamWallProbeResult& OutResult) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PantherJamWallProbeOverlap), false, GetOwner());
+
+	PANTHERJAM_INC_COUNTER(Traces, 1);
+
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByChannel(Overlaps, Location, FQuat::Identity, ProbeChannel, FCollisionShape::MakeCapsule(ProbeDistance, ProbeDistance), QueryParams);
+
+	// only accept points that are mostly to the side of the owner, like the side traces would
+	const float MinLateralRatio = UE_INV_SQRT_2;
+
+	float BestLeftDistance = TNumericLimits<float>::Max();
+	float BestRightDistance = TNumericLimits<float>::Max();
+	FVector BestLeftPoint, BestRightPoint;
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		const UPrimitiveComponent* Component = Overlap.GetComponent();
+
+		if (!Component)
+		{
+			continue;
+		}
+
+		// find the closest point on the overlapped shape. Zero means we're inside it, negative means no simple collision
+		FVector ClosestPoint;
+		if (Component->GetClosestPointOnCollision(Location, ClosestPoint) <= 0.0f)
+		{
+			continue;
+		}
+
+		const FVector Offset = ClosestPoint - Location;
+
+		// skip floors and ceilings
+		if (FMath::Abs(Offset.Z) > OverlapVerticalTolerance)
+		{
+			continue;
+		}
+
+		const float Lateral = FVector::DotProduct(Offset, RightVector);
+		const float Distance2D = Offset.Size2D();
+
+		if (FMath::Abs(Lateral) > ProbeDistance || FMath::Abs(Lateral) < Distance2D * MinLateralRatio)
+		{
+			continue;
+		}
+
+		// keep the closest point on each side
+		if (Lateral < 0.0f && Distance2D < BestLeftDistance)
+		{
+			BestLeftDistance = Distance2D;
+			BestLeftPoint = ClosestPoint;
+		}
+		else if (Lateral >= 0.0f && Distance2D < BestRightDistance)
+		{
+			BestRightDistance = Distance2D;
+			BestRightPoint = ClosestPoint;
+		}
+	}
+
+	OutResult.bLeftWall = BestLeftDistance < TNumericLimits<float>::Max();
+	OutResult.bRightWall = BestRightDistance < TNumericLimits<float>::Max();
+
+	// left walls take priority
+	if (OutResult.bLeftWall || OutResult.bRightWall)
+	{
+		OutResult.ImpactPoint = OutResult.bLeftWall ? BestLeftPoint : BestRightPoint;
+		OutResult.WallNormal = (Location - OutResult.ImpactPoint).GetSafeNormal2D();
+	}
+}
@@ -0,0 +1,177 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "PantherJamWallProbeComponent.generated.h"
+
+/**
+ *  Result of a wall probe to the left and right of the owning actor
+ */
+struct FPantherJamWallProbeResult
+{
+	/** If true, a wall was found on the owner's left side */
+	bool bLeftWall = false;
+
+	/** If true, a wall was found on the owner's right side */
+	bool bRightWall = false;
+
+	/** Normal of the detected wall. Left walls take priority over right walls */
+	FVector WallNormal = FVector::ZeroVector;
+
+	/** Impact point on the detected wall */
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	/** Returns true if a wall was found on either side */
+	bool HasWall() const { return bLeftWall || bRightWall; }
+};
+
+/**
+ *  Probes for walls to the sides of the owning actor for wall running and wall jumping.
+ *  Results are shared between callers in the same frame at the same location, and reused across frames
+ *  while the owner stays within a small distance of the last probe location.
+ *  Trace probes can optionally run asynchronously, issuing the traces in one frame and consuming them in the next.
+ *  Movement uses ProbeWalls to start wall runs and wall jumps, and ProbeWallsAt for the wall run sub-steps and client replays,
+ *  which need synchronous queries at the simulated location.
+ */
+UCLASS(ClassGroup=(PantherJam), meta=(BlueprintSpawnableComponent))
+class UPantherJamWallProbeComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Distance to probe to either side of the owner */
+	UPROPERTY(EditAnywhere, Category="Wall Probe", meta=(ClampMin=0, ClampMax=1000, Units="cm"))
+	float ProbeDistance = 100.0f;
+
+	/** Max distance the owner may move before a cached probe result is discarded. Zero only shares results between callers at the same location */
+	UPROPERTY(EditAnywhere, Category="Wall Probe", meta=(ClampMin=0, ClampMax=100, Units="cm"))
+	float ReuseDistance = 5.0f;
+
+	/** Max angle the owner may turn before a cached probe result is discarded */
+	UPROPERTY(EditAnywhere, Category="Wall Probe", meta=(ClampMin=0, ClampMax=45, Units="Degrees"))
+	float ReuseAngle = 2.0f;
+
+	/** If true, a single capsule overlap is used instead of two line traces. Requires simple collision on walls */
+	UPROPERTY(EditAnywhere, Category="Wall Probe")
+	bool bUseOverlapProbe = false;
+
+	/** Max vertical offset between the owner and the closest point on a wall for overlap probes */
+	UPROPERTY(EditAnywhere, Category="Wall Probe", meta=(ClampMin=0, ClampMax=100, Units="cm", EditCondition="bUseOverlapProbe"))
+	float OverlapVerticalTolerance = 10.0f;
+
+	/** If true, trace probes are issued asynchronously and their results are used on the following frame */
+	UPROPERTY(EditAnywhere, Category="Wall Probe|Async", meta=(EditCondition="!bUseOverlapProbe"))
+	bool bUseAsyncProbe = false;
+
+	/** Owner speed above which async probes fall back to synchronous traces, since a frame of latency would be noticeable */
+	UPROPERTY(EditAnywhere, Category="Wall Probe|Async", meta=(ClampMin=0, ClampMax=10000, Units="cm/s", EditCondition="bUseAsyncProbe"))
+	float AsyncMaxSpeed = 1200.0f;
+
+	/** Collision channel to probe on */
+	UPROPERTY(EditAnywhere, Category="Wall Probe")
+	TEnumAsByte<ECollisionChannel> ProbeChannel = ECC_Visibility;
+
+	/** Last probe result */
+	FPantherJamWallProbeResult CachedResult;
+
+	/** Owner location at the time of the last probe */
+	FVector CachedLocation = FVector::ZeroVector;
+
+	/** Owner right vector at the time of the last probe */
+	FVector CachedRightVector = FVector::ZeroVector;
+
+	/** Frame number of the last probe */
+	uint64 CachedFrame = 0;
+
+	/** If true, CachedResult holds a valid probe */
+	bool bHasCachedResult = false;
+
+	/** Number of probe requests served from the cache */
+	int32 CacheHits = 0;
+
+	/** Number of probe requests that ran a scene query */
+	int32 CacheMisses = 0;
+
+	/** Number of cache misses served from an async probe issued on a previous frame */
+	int32 AsyncResults = 0;
+
+	/** Pending async trace to the owner's left */
+	FTraceHandle PendingLeftTrace;
+
+	/** Pending async trace to the owner's right */
+	FTraceHandle PendingRightTrace;
+
+	/** Owner location at the time the pending async probe was issued */
+	FVector PendingLocation = FVector::ZeroVector;
+
+	/** Frame number the pending async probe was issued on */
+	uint64 PendingFrame = 0;
+
+	/** If true, an async probe has been issued and not yet consumed */
+	bool bHasPendingProbe = false;
+
+public:
+
+	/** Constructor */
+	UPantherJamWallProbeComponent();
+
+	/** Returns the wall probe for the owner's current location, running scene queries only if the cached result is stale */
+	const FPantherJamWallProbeResult& ProbeWalls();
+
+	/**
+	 *  Probes at the given location and orientation with synchronous scene queries, bypassing the cache and async probes.
+	 *  Used by movement simulation, which must get the same result whenever a saved move is replayed.
+	 */
+	FPantherJamWallProbeResult ProbeWallsAt(const FVector& Location, const FVector& RightVector) const;
+
+	/** Discards the cached result so the next probe runs a scene query */
+	void InvalidateCache();
+
+	/** Resets the cache hit and miss counters */
+	UFUNCTION(BlueprintCallable, Category="Wall Probe")
+	void ResetCounters();
+
+	/** Returns the number of probe requests served from the cache */
+	UFUNCTION(BlueprintPure, Category="Wall Probe")
+	int32 GetCacheHits() const { return CacheHits; }
+
+	/** Returns the number of probe requests that ran a scene query */
+	UFUNCTION(BlueprintPure, Category="Wall Probe")
+	int32 GetCacheMisses() const { return CacheMisses; }
+
+	/** Returns the number of cache misses served from an async probe */
+	UFUNCTION(BlueprintPure, Category="Wall Probe")
+	int32 GetAsyncResults() const { return AsyncResults; }
+
+	/** Returns the owner speed above which async probes fall back to synchronous traces */
+	float GetAsyncMaxSpeed() const { return AsyncMaxSpeed; }
+
+	/** Enables or disables async probes at runtime */
+	UFUNCTION(BlueprintCallable, Category="Wall Probe")
+	void SetUseAsyncProbe(bool bEnabled);
+
+protected:
+
+	/** Returns true if the cached result can be reused at the given location and orientation */
+	bool CanReuseCachedResult(const FVector& Location, const FVector& RightVector) const;
+
+	/** Runs two line traces to the sides of the owner */
+	void ProbeWithTraces(const FVector& Location, const FVector& RightVector, FPantherJamWallProbeResult& OutResult) const;
+
+	/** Returns true if this probe should be served asynchronously */
+	bool ShouldUseAsyncProbe() const;
+
+	/** Issues async traces to the sides of the owner, to be consumed on the next frame */
+	void IssueAsyncProbe(const FVector& Location, const FVector& RightVector);
+
+	/** Builds a result from the async probe issued on a previous frame. Returns false if no result is available */
+	bool ConsumeAsyncProbe(const FVector& Location, FPantherJamWallProbeResult& OutResult);
+
+	/** Runs a single capsule overlap around the owner */
+	void ProbeWithOverlap(const FVector& Location, const FVector& RightVector, FPantherJamWallProbeResult& OutResult) const;
+};
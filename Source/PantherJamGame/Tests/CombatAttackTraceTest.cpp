@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "CombatAttackTraceSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/PrimitiveComponent.h"
+
+namespace CombatAttackTraceTest
+{
+	/** Distance between the lanes each trace sweeps along, so the traces never see each other's targets */
+	static constexpr double LaneSpacing = 1000.0;
+
+	/** Builds an attack trace along +X in the given lane */
+	static FCombatAttackTraceRequest MakeRequest(AActor* Attacker, int32 Lane)
+	{
+		FCombatAttackTraceRequest Request;
+		Request.Attacker = Attacker;
+		Request.Start = FVector(0.0, Lane * LaneSpacing, 100.0);
+		Request.End = FVector(300.0, Lane * LaneSpacing, 100.0);
+		Request.Radius = 20.0f;
+		Request.ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+		Request.ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+
+		return Request;
+	}
+
+	/** Location in front of the attacker, inside the given lane */
+	static FVector InLane(int32 Lane)
+	{
+		return FVector(200.0, Lane * LaneSpacing, 100.0);
+	}
+
+	/** Checks two hit lists hit the same components at the same points, in any order */
+	static void TestSameHits(FAutomationTestBase& Test, const FString& What, TArray<FHitResult> Expected, TArray<FHitResult> Actual)
+	{
+		if (!Test.TestEqual(What + TEXT(" hit count"), Actual.Num(), Expected.Num()))
+		{
+			return;
+		}
+
+		auto ByTime = [](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; };
+		Expected.StableSort(ByTime);
+		Actual.StableSort(ByTime);
+
+		for (int32 Index = 0; Index < Expected.Num(); ++Index)
+		{
+			const FHitResult& A = Expected[Index];
+			const FHitResult& B = Actual[Index];
+
+			Test.TestTrue(FString::Printf(TEXT("%s hit %d component"), *What, Index), A.GetComponent() == B.GetComponent());
+			Test.TestEqual(FString::Printf(TEXT("%s hit %d time"), *What, Index), B.Time, A.Time, 1.e-3f);
+			Test.TestEqual(FString::Printf(TEXT("%s hit %d impact point"), *What, Index), B.ImpactPoint, A.ImpactPoint, 0.1f);
+			Test.TestEqual(FString::Printf(TEXT("%s hit %d impact normal"), *What, Index), B.ImpactNormal, A.ImpactNormal, 0.01f);
+		}
+	}
+}
+
+/**
+ *  Queues attack traces against targets that move before the batch is resolved,
+ *  and checks the batched hits match the immediate sweeps run at request time.
+ *
+ *  Usage:
+ *  UnrealEditor PantherJam.uproject -nullrhi -unattended -ExecCmds="Automation RunTests PantherJam.Combat.BatchedAttackTraces; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatBatchedAttackTracesTest, "PantherJam.Combat.BatchedAttackTraces",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCombatBatchedAttackTracesTest::RunTest(const FString& Parameters)
+{
+	using namespace CombatAttackTraceTest;
+
+	UWorld* World = PantherJamAutomation::CreateGameWorld();
+	UCombatAttackTraceSubsystem* Subsystem = World->GetSubsystem<UCombatAttackTraceSubsystem>();
+
+	if (!TestNotNull(TEXT("Attack trace subsystem"), Subsystem))
+	{
+		PantherJamAutomation::DestroyGameWorld(World);
+		return false;
+	}
+
+	AActor* Attacker = World->SpawnActor<AActor>();
+
+	// lane 0: a target that leaves the sweep before the flush
+	AStaticMeshActor* Leaver = PantherJamAutomation::SpawnBasicShape(World, TEXT("Cube"), FTransform(InLane(0)), ECC_Pawn);
+
+	// lane 1: a target that enters the sweep before the flush
+	AStaticMeshActor* Arriver = PantherJamAutomation::SpawnBasicShape(World, TEXT("Sphere"), FTransform(InLane(1) + FVector(0.0, 400.0, 0.0)), ECC_WorldDynamic);
+
+	// lane 2: a target that turns and slides sideways, so the hit point moves on its surface
+	AStaticMeshActor* Turner = PantherJamAutomation::SpawnBasicShape(World, TEXT("Cube"), FTransform(FRotator(0.0, 20.0, 0.0), InLane(2)), ECC_Pawn);
+
+	// lane 3: a wall that isn't registered and doesn't move
+	AStaticMeshActor* Wall = PantherJamAutomation::SpawnBasicShape(World, TEXT("Cube"), FTransform(InLane(3)), ECC_WorldDynamic);
+
+	if (!TestTrue(TEXT("Spawned the targets"), Attacker && Leaver && Arriver && Turner && Wall))
+	{
+		PantherJamAutomation::DestroyGameWorld(World);
+		return false;
+	}
+
+	UCombatAttackTraceSubsystem::RegisterTarget(Leaver);
+	UCombatAttackTraceSubsystem::RegisterTarget(Arriver);
+	UCombatAttackTraceSubsystem::RegisterTarget(Turner);
+
+	// queue the traces, sweeping each one immediately as well
+	constexpr int32 NumLanes = 4;
+	TArray<TArray<FHitResult>> ImmediateHits;
+	ImmediateHits.SetNum(NumLanes);
+
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		const FCombatAttackTraceRequest Request = MakeRequest(Attacker, Lane);
+
+		UCombatAttackTraceSubsystem::SweepAttackTrace(World, Request, ImmediateHits[Lane]);
+		Subsystem->QueueAttackTrace(Request);
+	}
+
+	TestEqual(TEXT("Immediate hits on the target leaving"), ImmediateHits[0].Num(), 1);
+	TestEqual(TEXT("Immediate hits on the target arriving"), ImmediateHits[1].Num(), 0);
+	TestEqual(TEXT("Immediate hits on the target turning"), ImmediateHits[2].Num(), 1);
+	TestEqual(TEXT("Immediate hits on the wall"), ImmediateHits[3].Num(), 1);
+
+	// move the targets like the rest of the frame would
+	Leaver->SetActorLocation(InLane(0) + FVector(0.0, 500.0, 0.0));
+	Arriver->SetActorLocation(InLane(1));
+	Turner->SetActorLocationAndRotation(InLane(2) + FVector(30.0, 37.0, 0.0), FRotator(0.0, -15.0, 0.0));
+
+	// make sure the scene really changed under the queued traces
+	TArray<FHitResult> LateHits;
+	UCombatAttackTraceSubsystem::SweepAttackTrace(World, MakeRequest(Attacker, 0), LateHits);
+	TestEqual(TEXT("Hits on the target leaving after it moved"), LateHits.Num(), 0);
+
+	Subsystem->ResolveAttackTraces();
+
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		TestSameHits(*this, FString::Printf(TEXT("Lane %d"), Lane), ImmediateHits[Lane], Subsystem->GetResolvedHits(Lane));
+	}
+
+	PantherJamAutomation::DestroyGameWorld(World);
+
+	return true;
+}
+
+#endif
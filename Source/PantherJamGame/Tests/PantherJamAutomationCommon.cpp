@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+
+UWorld* PantherJamAutomation::CreateGameWorld()
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+
+	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+	Context.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	return World;
+}
+
+void PantherJamAutomation::DestroyGameWorld(UWorld* World)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+AStaticMeshActor* PantherJamAutomation::SpawnBasicShape(UWorld* World, const TCHAR* ShapeName, const FTransform& Transform, ECollisionChannel ObjectType)
+{
+	UStaticMesh* Shape = LoadObject<UStaticMesh>(nullptr, *FString::Printf(TEXT("/Engine/BasicShapes/%s.%s"), ShapeName, ShapeName));
+	AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Transform.GetLocation(), Transform.Rotator());
+
+	if (!Shape || !Actor)
+	{
+		return nullptr;
+	}
+
+	// the tests move their shapes around, so they can't be static
+	UStaticMeshComponent* Mesh = Actor->GetStaticMeshComponent();
+	Mesh->SetMobility(EComponentMobility::Movable);
+	Mesh->SetStaticMesh(Shape);
+	Mesh->SetWorldScale3D(Transform.GetScale3D());
+	Mesh->SetCollisionProfileName(TEXT("BlockAllDynamic"));
+	Mesh->SetCollisionObjectType(ObjectType);
+
+	return Actor;
+}
+
+#endif
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+TArray<UWorld*> PantherJamAutomation::GetPIEWorlds()
+{
+	TArray<UWorld*> Worlds;
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		if (Context.WorldType == EWorldType::PIE && Context.World())
+		{
+			Worlds.Add(Context.World());
+		}
+	}
+
+	// servers first, then clients in the order they were created
+	Worlds.StableSort([](const UWorld& A, const UWorld& B)
+	{
+		return A.GetNetMode() != NM_Client && B.GetNetMode() == NM_Client;
+	});
+
+	return Worlds;
+}
+
+APawn* PantherJamAutomation::GetLocalPawn(UWorld* World)
+{
+	const APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+
+	return PC ? PC->GetPawn() : nullptr;
+}
+
+bool FPantherJamStartPIECommand::Update()
+{
+	// the settings are copied into the session, so a transient object is enough
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(NetMode);
+	PlaySettings->SetPlayNumberOfClients(NumPlayers);
+	PlaySettings->SetRunUnderOneProcess(true);
+	PlaySettings->bLaunchSeparateServer = false;
+
+	FRequestPlaySessionParams Params;
+	Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+	Params.EditorPlaySettings = PlaySettings;
+
+	GEditor->RequestPlaySession(Params);
+
+	return true;
+}
+
+bool FPantherJamWaitForPawnsCommand::Update()
+{
+	const TArray<UWorld*> Worlds = PantherJamAutomation::GetPIEWorlds();
+
+	bool bReady = Worlds.Num() >= NumWorlds;
+
+	for (UWorld* World : Worlds)
+	{
+		bReady &= PantherJamAutomation::GetLocalPawn(World) != nullptr;
+	}
+
+	if (bReady)
+	{
+		return true;
+	}
+
+	if (GetCurrentRunTime() > Timeout)
+	{
+		Test->AddError(FString::Printf(TEXT("Timed out waiting for %d PIE worlds with pawns, found %d worlds"), NumWorlds, Worlds.Num()));
+		return true;
+	}
+
+	return false;
+}
+
+bool FPantherJamEndPIECommand::Update()
+{
+	if (!bRequested)
+	{
+		GEditor->RequestEndPlayMap();
+		bRequested = true;
+	}
+
+	return GEditor->PlayWorld == nullptr;
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/EngineTypes.h"
+
+class UWorld;
+class APawn;
+class AStaticMeshActor;
+
+/**
+ *  Helpers shared by the automation tests that build their own scene
+ */
+namespace PantherJamAutomation
+{
+	/** Creates a game world with its actors initialized for play and BeginPlay called */
+	UWorld* CreateGameWorld();
+
+	/** Tears down a world made by CreateGameWorld */
+	void DestroyGameWorld(UWorld* World);
+
+	/** Spawns a movable static mesh actor with one of the engine's basic shapes, like TEXT("Cube") */
+	AStaticMeshActor* SpawnBasicShape(UWorld* World, const TCHAR* ShapeName, const FTransform& Transform, ECollisionChannel ObjectType);
+}
+
+#endif
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Settings/LevelEditorPlaySettings.h"
+
+/**
+ *  Helpers shared by the automation tests that run play in editor sessions
+ */
+namespace PantherJamAutomation
+{
+	/** Returns every running PIE world, with the server first */
+	TArray<UWorld*> GetPIEWorlds();
+
+	/** Returns the pawn of the world's first local player */
+	APawn* GetLocalPawn(UWorld* World);
+}
+
+/**
+ *  Starts a PIE session of the loaded map under one process, with the given net mode and number of players
+ */
+class FPantherJamStartPIECommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamStartPIECommand(EPlayNetMode InNetMode, int32 InNumPlayers)
+		: NetMode(InNetMode)
+		, NumPlayers(InNumPlayers)
+	{}
+
+	virtual bool Update() override;
+
+private:
+
+	EPlayNetMode NetMode;
+	int32 NumPlayers;
+};
+
+/**
+ *  Waits until the PIE session has the expected number of worlds, each with a local pawn. Fails the test on timeout
+ */
+class FPantherJamWaitForPawnsCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamWaitForPawnsCommand(FAutomationTestBase* InTest, int32 InNumWorlds, double InTimeout)
+		: Test(InTest)
+		, NumWorlds(InNumWorlds)
+		, Timeout(InTimeout)
+	{}
+
+	virtual bool Update() override;
+
+private:
+
+	FAutomationTestBase* Test;
+	int32 NumWorlds;
+	double Timeout;
+};
+
+/**
+ *  Ends the PIE session and waits for it to shut down
+ */
+class FPantherJamEndPIECommand : public IAutomationLatentCommand
+{
+public:
+
+	virtual bool Update() override;
+
+private:
+
+	bool bRequested = false;
+};
+
+#endif
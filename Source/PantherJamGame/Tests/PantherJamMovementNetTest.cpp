@@ -0,0 +1,186 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationEditorCommon.h"
+#include "PantherJamGameCharacter.h"
+#include "PantherJamMovementComponent.h"
+#include "PantherJamInputReplayable.h"
+#include "Engine/World.h"
+
+namespace PantherJamMovementNetTest
+{
+	/** Map with the wall running character as the default pawn */
+	static const TCHAR* MapName = TEXT("/Game/ThirdPerson/Lvl_ThirdPerson");
+
+	/** Listen server plus two clients */
+	static constexpr int32 NumPlayers = 3;
+
+	/** Time the clients run the jump script for */
+	static constexpr double Duration = 10.0;
+
+	/** Length of one loop of the jump script */
+	static constexpr float ScriptLength = 2.0f;
+
+	/** Max fraction of client moves the server may correct */
+	static constexpr float MaxCorrectionRate = 0.02f;
+
+	/** Max movement bandwidth per client, in both directions, in bytes per second */
+	static constexpr float MaxMoveBandwidth = 4096.0f;
+
+	/** Returns the movement component of each client's local character */
+	static TArray<UPantherJamMovementComponent*> GetClientMovement()
+	{
+		TArray<UPantherJamMovementComponent*> Result;
+
+		for (UWorld* World : PantherJamAutomation::GetPIEWorlds())
+		{
+			if (World->GetNetMode() != NM_Client)
+			{
+				continue;
+			}
+
+			if (const APantherJamGameCharacter* Character = Cast<APantherJamGameCharacter>(PantherJamAutomation::GetLocalPawn(World)))
+			{
+				Result.Add(Character->GetPantherJamMovement());
+			}
+		}
+
+		return Result;
+	}
+}
+
+/**
+ *  Runs every client forward through a loop of ground jumps, wall jump requests and double jumps,
+ *  through the same entry points as the jump and move bindings
+ */
+class FPantherJamDriveClientsCommand : public IAutomationLatentCommand
+{
+public:
+
+	virtual bool Update() override
+	{
+		using namespace PantherJamMovementNetTest;
+
+		const TArray<UPantherJamMovementComponent*> Clients = GetClientMovement();
+		const float Time = (float)GetCurrentRunTime();
+
+		// measure from the start of the script
+		if (LastPhases.IsEmpty())
+		{
+			for (UPantherJamMovementComponent* MoveComp : Clients)
+			{
+				MoveComp->ResetNetStats();
+			}
+
+			LastPhases.Init(-1.0f, Clients.Num());
+		}
+
+		for (int32 Index = 0; Index < Clients.Num() && Index < LastPhases.Num(); ++Index)
+		{
+			IPantherJamInputReplayable* Input = Cast<IPantherJamInputReplayable>(Clients[Index]->GetOwner());
+
+			if (!Input)
+			{
+				continue;
+			}
+
+			// offset each client so they don't all jump on the same frame
+			const float Phase = FMath::Fmod(Time + Index * 0.37f, ScriptLength);
+			const float LastPhase = Phase < LastPhases[Index] ? -1.0f : LastPhases[Index];
+
+			auto Crossed = [Phase, LastPhase](float At) { return LastPhase < At && Phase >= At; };
+
+			Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(0.3f, 1.0f));
+
+			// jump off the ground, release, then double jump in the air and release again
+			if (Crossed(0.0f) || Crossed(0.45f))
+			{
+				Input->ReplayInput(EPantherJamInputAction::JumpStart, FVector2f::ZeroVector);
+			}
+
+			if (Crossed(0.2f) || Crossed(0.6f))
+			{
+				Input->ReplayInput(EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+			}
+
+			LastPhases[Index] = Phase;
+		}
+
+		return Time >= PantherJamMovementNetTest::Duration;
+	}
+
+private:
+
+	/** Script phase of each client on the last update */
+	TArray<float> LastPhases;
+};
+
+/**
+ *  Checks the correction rate and bandwidth of each client against the budgets
+ */
+class FPantherJamCheckNetStatsCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamCheckNetStatsCommand(FAutomationTestBase* InTest)
+		: Test(InTest)
+	{}
+
+	virtual bool Update() override
+	{
+		using namespace PantherJamMovementNetTest;
+
+		const TArray<UPantherJamMovementComponent*> Clients = GetClientMovement();
+
+		Test->TestEqual(TEXT("Number of clients"), Clients.Num(), NumPlayers - 1);
+
+		for (int32 Index = 0; Index < Clients.Num(); ++Index)
+		{
+			const UPantherJamMovementComponent* MoveComp = Clients[Index];
+			const FPantherJamNetMoveStats& Stats = MoveComp->GetNetStats();
+
+			Test->AddInfo(FString::Printf(TEXT("Client %d: %d moves, %d corrections (%.2f%%), %.0f bytes/s"),
+				Index, Stats.MovesSent, Stats.Corrections, MoveComp->GetCorrectionRate() * 100.0f, MoveComp->GetMoveBandwidth()));
+
+			Test->TestTrue(FString::Printf(TEXT("Client %d sent moves"), Index), Stats.MovesSent > 0);
+			Test->TestTrue(FString::Printf(TEXT("Client %d correction rate is within budget"), Index), MoveComp->GetCorrectionRate() <= MaxCorrectionRate);
+			Test->TestTrue(FString::Printf(TEXT("Client %d movement bandwidth is within budget"), Index), MoveComp->GetMoveBandwidth() <= MaxMoveBandwidth);
+		}
+
+		return true;
+	}
+
+private:
+
+	FAutomationTestBase* Test;
+};
+
+/**
+ *  Hosts a listen server with two clients over loopback, runs the clients through a script of jumps,
+ *  double jumps and wall jump requests, and checks the server rarely has to correct their predicted moves.
+ *
+ *  Usage:
+ *  UnrealEditor PantherJam.uproject -nullrhi -unattended -ExecCmds="Automation RunTests PantherJam.Movement.NetPrediction; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPantherJamMovementNetPredictionTest, "PantherJam.Movement.NetPrediction",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FPantherJamMovementNetPredictionTest::RunTest(const FString& Parameters)
+{
+	using namespace PantherJamMovementNetTest;
+
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(MapName));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamStartPIECommand(EPlayNetMode::PIE_ListenServer, NumPlayers));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamWaitForPawnsCommand(this, NumPlayers, 30.0));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamDriveClientsCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamCheckNetStatsCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamEndPIECommand());
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,430 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationEditorCommon.h"
+#include "PantherJamInputReplayable.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+
+namespace PantherJamServerSoakTest
+{
+	/** Combat level, with the combat character as the default pawn */
+	static const TCHAR* MapName = TEXT("/Game/Variant_Combat/Lvl_Combat");
+
+	/** Number of connected clients in the full soak. Can be overridden with -SoakClients */
+	static constexpr int32 DefaultNumClients = 64;
+
+	/** Time to let the session settle after everyone has connected */
+	static constexpr double SettleTime = 5.0;
+
+	/** Time to record the server tick for */
+	static constexpr double RecordTime = 20.0;
+
+	/** Max time to wait for all the clients to connect and spawn */
+	static constexpr double ConnectTimeout = 300.0;
+
+	/** Length of one loop of the scripted client input */
+	static constexpr float ScriptLength = 8.0f;
+
+	/** Measurements of one soak session */
+	struct FSession
+	{
+		/** Number of connected clients */
+		int32 Clients = 0;
+
+		/** Process memory used once every client connected, over the memory used before the session, in MB */
+		double MemoryMB = 0.0;
+
+		/** Recorded server world tick times, in milliseconds */
+		TArray<float> TickTimes;
+	};
+
+	/** Sessions run so far, shared between the latent commands */
+	struct FResults
+	{
+		/** Process memory used before the current session started */
+		uint64 MemoryBeforeSession = 0;
+
+		TArray<FSession> Sessions;
+	};
+
+	/** Returns the number of clients to connect in the full soak */
+	static int32 GetNumClients()
+	{
+		int32 NumClients = DefaultNumClients;
+		FParse::Value(FCommandLine::Get(), TEXT("SoakClients="), NumClients);
+
+		return FMath::Max(NumClients, 2);
+	}
+
+	/** Returns the dedicated server PIE world */
+	static UWorld* GetServerWorld()
+	{
+		for (UWorld* World : PantherJamAutomation::GetPIEWorlds())
+		{
+			if (World->GetNetMode() == NM_DedicatedServer)
+			{
+				return World;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/** Returns the number of client connections on the server with a spawned pawn */
+	static int32 GetNumConnectedPawns(UWorld* ServerWorld)
+	{
+		const UNetDriver* NetDriver = ServerWorld ? ServerWorld->GetNetDriver() : nullptr;
+
+		if (!NetDriver)
+		{
+			return 0;
+		}
+
+		int32 Count = 0;
+
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (Connection && Connection->PlayerController && Connection->PlayerController->GetPawn())
+			{
+				++Count;
+			}
+		}
+
+		return Count;
+	}
+
+	/** Returns the given percentile of the samples */
+	static float GetPercentile(TArray<float> Samples, float Percentile)
+	{
+		if (Samples.IsEmpty())
+		{
+			return 0.0f;
+		}
+
+		// nearest rank percentile
+		Samples.Sort();
+
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt32(Percentile * Samples.Num()) - 1, 0, Samples.Num() - 1);
+
+		return Samples[Rank];
+	}
+}
+
+/**
+ *  Records the process memory before a soak session starts
+ */
+class FPantherJamSoakBeginSessionCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamSoakBeginSessionCommand(TSharedRef<PantherJamServerSoakTest::FResults> InResults)
+		: Results(InResults)
+	{}
+
+	virtual bool Update() override
+	{
+		Results->MemoryBeforeSession = FPlatformMemory::GetStats().UsedPhysical;
+
+		return true;
+	}
+
+private:
+
+	TSharedRef<PantherJamServerSoakTest::FResults> Results;
+};
+
+/**
+ *  Waits until the dedicated server has the expected number of client connections, each with a spawned pawn
+ */
+class FPantherJamSoakWaitForClientsCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamSoakWaitForClientsCommand(FAutomationTestBase* InTest, int32 InNumClients)
+		: Test(InTest)
+		, NumClients(InNumClients)
+	{}
+
+	virtual bool Update() override
+	{
+		using namespace PantherJamServerSoakTest;
+
+		const int32 Connected = GetNumConnectedPawns(GetServerWorld());
+
+		if (Connected >= NumClients)
+		{
+			return true;
+		}
+
+		if (GetCurrentRunTime() > ConnectTimeout)
+		{
+			Test->AddError(FString::Printf(TEXT("Timed out waiting for %d clients to connect, %d connected"), NumClients, Connected));
+			return true;
+		}
+
+		return false;
+	}
+
+private:
+
+	FAutomationTestBase* Test;
+	int32 NumClients;
+};
+
+/**
+ *  Drives every client through a loop of moves and attacks through the same entry points as their bindings,
+ *  and records the server world tick time once the session has settled
+ */
+class FPantherJamSoakRecordCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamSoakRecordCommand(FAutomationTestBase* InTest, TSharedRef<PantherJamServerSoakTest::FResults> InResults, int32 InNumClients)
+		: Test(InTest)
+		, Results(InResults)
+		, NumClients(InNumClients)
+	{}
+
+	virtual ~FPantherJamSoakRecordCommand()
+	{
+		Unhook();
+	}
+
+	virtual bool Update() override
+	{
+		using namespace PantherJamServerSoakTest;
+
+		if (!ServerWorld)
+		{
+			ServerWorld = GetServerWorld();
+
+			if (!ServerWorld)
+			{
+				Test->AddError(TEXT("No dedicated server world to soak"));
+				return true;
+			}
+
+			// memory is measured once everyone has connected, before the clients start moving around
+			Session.Clients = GetNumConnectedPawns(ServerWorld);
+			Session.MemoryMB = (double(int64(FPlatformMemory::GetStats().UsedPhysical)) - double(int64(Results->MemoryBeforeSession))) / (1024.0 * 1024.0);
+			Session.TickTimes.Reserve(FMath::CeilToInt32(RecordTime * 60.0));
+
+			TickStartHandle = FWorldDelegates::OnWorldTickStart.AddRaw(this, &FPantherJamSoakRecordCommand::OnWorldTickStart);
+			TickEndHandle = FWorldDelegates::OnWorldTickEnd.AddRaw(this, &FPantherJamSoakRecordCommand::OnWorldTickEnd);
+		}
+
+		const double Time = GetCurrentRunTime();
+
+		DriveClients(float(Time));
+
+		bRecording = Time > SettleTime;
+
+		if (Time < SettleTime + RecordTime)
+		{
+			return false;
+		}
+
+		Unhook();
+
+		Results->Sessions.Add(MoveTemp(Session));
+
+		return true;
+	}
+
+private:
+
+	/** Feeds the scripted input to each client's local pawn */
+	void DriveClients(float Time)
+	{
+		using namespace PantherJamServerSoakTest;
+
+		int32 Index = 0;
+
+		for (UWorld* World : PantherJamAutomation::GetPIEWorlds())
+		{
+			if (World->GetNetMode() != NM_Client)
+			{
+				continue;
+			}
+
+			IPantherJamInputReplayable* Input = Cast<IPantherJamInputReplayable>(PantherJamAutomation::GetLocalPawn(World));
+
+			if (!Input)
+			{
+				continue;
+			}
+
+			if (!AttacksHeld.IsValidIndex(Index))
+			{
+				AttacksHeld.SetNumZeroed(Index + 1);
+			}
+
+			// offset each client so they don't all act on the same frame
+			const float Phase = FMath::Fmod(Time + Index * 0.13f, ScriptLength);
+
+			// wander in a circle while turning, attacking every other second
+			Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(FMath::Sin(Phase), 0.5f));
+			Input->ReplayInput(EPantherJamInputAction::Look, FVector2f(0.5f, 0.0f));
+
+			const bool bAttackHeld = FMath::Fmod(Phase, 2.0f) < 0.2f;
+
+			if (bAttackHeld != AttacksHeld[Index])
+			{
+				Input->ReplayInput(bAttackHeld ? EPantherJamInputAction::ComboAttackStart : EPantherJamInputAction::ComboAttackEnd, FVector2f::ZeroVector);
+				AttacksHeld[Index] = bAttackHeld;
+			}
+
+			++Index;
+		}
+	}
+
+	/** Called when any world starts its tick */
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (World == ServerWorld)
+		{
+			TickStartTime = FPlatformTime::Seconds();
+		}
+	}
+
+	/** Called when any world finishes its tick, including the net driver flush */
+	void OnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (World == ServerWorld && bRecording && TickStartTime > 0.0)
+		{
+			Session.TickTimes.Add(float((FPlatformTime::Seconds() - TickStartTime) * 1000.0));
+		}
+	}
+
+	/** Removes the world tick delegates */
+	void Unhook()
+	{
+		FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+		FWorldDelegates::OnWorldTickEnd.Remove(TickEndHandle);
+
+		TickStartHandle.Reset();
+		TickEndHandle.Reset();
+	}
+
+	FAutomationTestBase* Test;
+
+	TSharedRef<PantherJamServerSoakTest::FResults> Results;
+
+	int32 NumClients;
+
+	/** Measurements of this session */
+	PantherJamServerSoakTest::FSession Session;
+
+	UWorld* ServerWorld = nullptr;
+
+	FDelegateHandle TickStartHandle;
+	FDelegateHandle TickEndHandle;
+
+	/** Attack input held by each client on the last update */
+	TArray<bool> AttacksHeld;
+
+	double TickStartTime = 0.0;
+
+	bool bRecording = false;
+};
+
+/**
+ *  Compares the single client session against the full one, and reports the server cost of each extra connected player
+ */
+class FPantherJamSoakReportCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamSoakReportCommand(FAutomationTestBase* InTest, TSharedRef<PantherJamServerSoakTest::FResults> InResults)
+		: Test(InTest)
+		, Results(InResults)
+	{}
+
+	virtual bool Update() override
+	{
+		using namespace PantherJamServerSoakTest;
+
+		if (!Test->TestEqual(TEXT("Soak sessions recorded"), Results->Sessions.Num(), 2))
+		{
+			return true;
+		}
+
+		const FSession& Single = Results->Sessions[0];
+		const FSession& Full = Results->Sessions[1];
+
+		for (const FSession& Session : Results->Sessions)
+		{
+			Test->AddInfo(FString::Printf(TEXT("%d clients: %d server frames, tick p50 %.3fms, p95 %.3fms, p99 %.3fms, %.1f MB over the editor"),
+				Session.Clients, Session.TickTimes.Num(), GetPercentile(Session.TickTimes, 0.5f), GetPercentile(Session.TickTimes, 0.95f),
+				GetPercentile(Session.TickTimes, 0.99f), Session.MemoryMB));
+
+			Test->TestTrue(FString::Printf(TEXT("Recorded the server tick with %d clients"), Session.Clients), Session.TickTimes.Num() > 0);
+		}
+
+		const int32 ExtraClients = Full.Clients - Single.Clients;
+
+		if (!Test->TestTrue(TEXT("The full session had more clients than the single client one"), ExtraClients > 0))
+		{
+			return true;
+		}
+
+		// the PIE clients run in the same process, so the memory includes each client's own world too
+		Test->AddInfo(FString::Printf(TEXT("Per connected player: server tick p50 +%.4fms, p95 +%.4fms, memory +%.1f KB including its PIE client world"),
+			(GetPercentile(Full.TickTimes, 0.5f) - GetPercentile(Single.TickTimes, 0.5f)) / ExtraClients,
+			(GetPercentile(Full.TickTimes, 0.95f) - GetPercentile(Single.TickTimes, 0.95f)) / ExtraClients,
+			(Full.MemoryMB - Single.MemoryMB) * 1024.0 / ExtraClients));
+
+		return true;
+	}
+
+private:
+
+	FAutomationTestBase* Test;
+
+	TSharedRef<PantherJamServerSoakTest::FResults> Results;
+};
+
+/**
+ *  Hosts the combat level on a dedicated PIE server, first with one connected client, then with -SoakClients
+ *  (64 by default), drives every client with scripted moves and attacks, and reports the server tick time
+ *  and memory each extra connected player adds.
+ *
+ *  Usage:
+ *  UnrealEditor PantherJam.uproject -nullrhi -unattended [-SoakClients=64] -ExecCmds="Automation RunTests PantherJam.Server.Soak; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPantherJamServerSoakTest, "PantherJam.Server.Soak",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FPantherJamServerSoakTest::RunTest(const FString& Parameters)
+{
+	using namespace PantherJamServerSoakTest;
+
+	const TSharedRef<FResults> Results = MakeShared<FResults>();
+
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(MapName));
+
+	for (const int32 NumClients : { 1, GetNumClients() })
+	{
+		ADD_LATENT_AUTOMATION_COMMAND(FPantherJamSoakBeginSessionCommand(Results));
+		ADD_LATENT_AUTOMATION_COMMAND(FPantherJamStartPIECommand(EPlayNetMode::PIE_Client, NumClients));
+		ADD_LATENT_AUTOMATION_COMMAND(FPantherJamSoakWaitForClientsCommand(this, NumClients));
+		ADD_LATENT_AUTOMATION_COMMAND(FPantherJamSoakRecordCommand(this, Results, NumClients));
+		ADD_LATENT_AUTOMATION_COMMAND(FPantherJamEndPIECommand());
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamSoakReportCommand(this, Results));
+
+	return true;
+}
+
+#endif
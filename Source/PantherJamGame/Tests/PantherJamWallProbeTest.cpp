@@ -0,0 +1,349 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PantherJamGameCharacter.h"
+#include "PantherJamMovementComponent.h"
+#include "PantherJamMovementSimCommandlet.h"
+#include "PantherJamWallProbeComponent.h"
+#include "PantherJamInputReplayable.h"
+#include "Engine/World.h"
+#include "Engine/StaticMeshActor.h"
+
+namespace PantherJamWallProbeTest
+{
+	/** Length of the corridor */
+	static constexpr double CorridorLength = 4000.0;
+
+	/** Distance from the corridor center to the inner face of each wall. Inside the default probe distance */
+	static constexpr double HalfWidth = 70.0;
+
+	/** Length of each wall segment. Segments go left, right, then a gap on both sides */
+	static constexpr double SegmentLength = 200.0;
+
+	/** Fixed time step the world is ticked at */
+	static constexpr float TimeStep = 1.0f / 60.0f;
+
+	/** Time between jumps in the scripted run */
+	static constexpr float JumpInterval = 1.0f;
+
+	/** Time the jump button is held, which is also the time we want to wall run */
+	static constexpr float JumpHoldTime = 0.8f;
+
+	/** Max frames a run may take to reach the end of the corridor */
+	static constexpr int32 MaxFrames = 1800;
+
+	/** Wall probe mode and run speed for each pass down the corridor */
+	struct FPass
+	{
+		const TCHAR* Name;
+		bool bAsync;
+		float Speed;
+	};
+
+	static const FPass Passes[] = {
+		{ TEXT("Sync"), false, 600.0f },
+		{ TEXT("Async"), true, 600.0f },
+		{ TEXT("Async above the max async speed"), true, 1600.0f }
+	};
+}
+
+/**
+ *  Runs a wall run character down a generated corridor with gaps, once per pass, feeding it input the same way
+ *  input replays do. Every frame the character is in the air holding jump next to a wall, it should start a wall run.
+ *  Sync probes must never miss one, async probes may be a frame late, and fast characters must fall back to sync probes.
+ */
+class FPantherJamWallProbeCorridorCommand : public IAutomationLatentCommand
+{
+public:
+
+	FPantherJamWallProbeCorridorCommand(FAutomationTestBase* InTest)
+		: Test(InTest)
+	{}
+
+	virtual ~FPantherJamWallProbeCorridorCommand()
+	{
+		TearDown();
+	}
+
+	virtual bool Update() override
+	{
+		using namespace PantherJamWallProbeTest;
+
+		if (!World && !SetUp())
+		{
+			TearDown();
+			return true;
+		}
+
+		if (!Character && !StartPass())
+		{
+			TearDown();
+			return true;
+		}
+
+		// input is fed from inside the world tick, so the character sees it on the same frame
+		World->Tick(LEVELTICK_All, TimeStep);
+
+		CheckFrame();
+
+		if (Character->GetActorLocation().X < CorridorLength - SegmentLength && Frame < MaxFrames)
+		{
+			return false;
+		}
+
+		FinishPass();
+
+		if (++PassIndex < (int32)UE_ARRAY_COUNT(Passes))
+		{
+			return false;
+		}
+
+		TearDown();
+		return true;
+	}
+
+private:
+
+	/** Builds the corridor */
+	bool SetUp()
+	{
+		using namespace PantherJamWallProbeTest;
+
+		World = PantherJamAutomation::CreateGameWorld();
+
+		const FVector FloorCenter(CorridorLength * 0.5, 0.0, -10.0);
+		const FVector FloorScale(CorridorLength / 100.0 + 4.0, 3.0, 0.2);
+
+		if (!PantherJamAutomation::SpawnBasicShape(World, TEXT("Cube"), FTransform(FQuat::Identity, FloorCenter, FloorScale), ECC_WorldStatic))
+		{
+			Test->AddError(TEXT("Couldn't spawn the corridor floor"));
+			return false;
+		}
+
+		// walls alternate sides with a gap after each pair, so the character keeps falling off and finding walls again
+		const FVector WallScale(SegmentLength / 100.0, 0.2, 6.0);
+
+		for (int32 Segment = 0; Segment * SegmentLength < CorridorLength; ++Segment)
+		{
+			if (Segment % 3 == 2)
+			{
+				continue;
+			}
+
+			const double Side = Segment % 3 == 0 ? -1.0 : 1.0;
+			const FVector Center((Segment + 0.5) * SegmentLength, Side * (HalfWidth + 10.0), 300.0);
+
+			if (!PantherJamAutomation::SpawnBasicShape(World, TEXT("Cube"), FTransform(FQuat::Identity, Center, WallScale), ECC_WorldDynamic))
+			{
+				Test->AddError(TEXT("Couldn't spawn the corridor walls"));
+				return false;
+			}
+		}
+
+		PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddRaw(this, &FPantherJamWallProbeCorridorCommand::OnPreActorTick);
+
+		return true;
+	}
+
+	/** Spawns a fresh character at the start of the corridor for the current pass */
+	bool StartPass()
+	{
+		using namespace PantherJamWallProbeTest;
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		Character = World->SpawnActor<APantherJamGameCharacter>(APantherJamGameCharacter::StaticClass(), FTransform(FVector(0.0, 0.0, 100.0)), SpawnParams);
+		Controller = World->SpawnActor<APantherJamSimController>();
+
+		if (!Character || !Controller)
+		{
+			Test->AddError(TEXT("Couldn't spawn the wall run character"));
+			return false;
+		}
+
+		Controller->Possess(Character);
+		Controller->SetControlRotation(FRotator::ZeroRotator);
+
+		Character->GetCharacterMovement()->MaxWalkSpeed = Passes[PassIndex].Speed;
+		Character->GetWallProbe()->SetUseAsyncProbe(Passes[PassIndex].bAsync);
+		Character->GetWallProbe()->ResetCounters();
+
+		Frame = 0;
+		Misses = 0;
+		ConsecutiveMisses = 0;
+		MaxConsecutiveMisses = 0;
+		FastFrames = 0;
+		FastMisses = 0;
+		WallRuns = 0;
+		bJumpHeld = false;
+		bWasWallRunning = false;
+		bShouldStartWallRun = false;
+
+		return true;
+	}
+
+	/** Feeds the scripted input to the character, and checks whether it should start a wall run on this frame */
+	void OnPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+	{
+		using namespace PantherJamWallProbeTest;
+
+		if (InWorld != World || !Character)
+		{
+			return;
+		}
+
+		IPantherJamInputReplayable* Input = Cast<IPantherJamInputReplayable>(Character);
+
+		Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(0.0f, 1.0f));
+
+		const bool bHeld = FMath::Fmod(Frame * TimeStep, JumpInterval) < JumpHoldTime;
+
+		if (bHeld != bJumpHeld)
+		{
+			Input->ReplayInput(bHeld ? EPantherJamInputAction::JumpStart : EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+			bJumpHeld = bHeld;
+		}
+
+		// the movement probes from where the character is before it moves
+		const UPantherJamMovementComponent* Movement = Character->GetPantherJamMovement();
+
+		bShouldStartWallRun = bJumpHeld && Movement->MovementMode == MOVE_Falling
+			&& Character->GetWallProbe()->ProbeWallsAt(Character->GetActorLocation(), Character->GetActorRightVector()).HasWall();
+
+		bFast = Character->GetVelocity().SizeSquared() > FMath::Square(Character->GetWallProbe()->GetAsyncMaxSpeed());
+	}
+
+	/** Counts the wall runs, and the frames the character should have started one and didn't */
+	void CheckFrame()
+	{
+		const bool bWallRunning = Character->IsWallRunning();
+
+		if (bWallRunning && !bWasWallRunning)
+		{
+			++WallRuns;
+		}
+
+		if (bShouldStartWallRun && !bWallRunning)
+		{
+			++Misses;
+			MaxConsecutiveMisses = FMath::Max(MaxConsecutiveMisses, ++ConsecutiveMisses);
+
+			if (bFast)
+			{
+				++FastMisses;
+			}
+		}
+		else
+		{
+			ConsecutiveMisses = 0;
+		}
+
+		if (bFast)
+		{
+			++FastFrames;
+		}
+
+		bWasWallRunning = bWallRunning;
+		++Frame;
+	}
+
+	/** Checks the pass results and removes the character */
+	void FinishPass()
+	{
+		using namespace PantherJamWallProbeTest;
+
+		const FPass& Pass = Passes[PassIndex];
+		const UPantherJamWallProbeComponent* WallProbe = Character->GetWallProbe();
+
+		Test->AddInfo(FString::Printf(TEXT("%s: %d frames, %d wall runs, %d missed frames, %d cache hits, %d cache misses, %d async results"),
+			Pass.Name, Frame, WallRuns, Misses, WallProbe->GetCacheHits(), WallProbe->GetCacheMisses(), WallProbe->GetAsyncResults()));
+
+		Test->TestTrue(FString::Printf(TEXT("%s pass reached the end of the corridor"), Pass.Name), Frame < MaxFrames);
+		Test->TestTrue(FString::Printf(TEXT("%s pass started wall runs"), Pass.Name), WallRuns > 0);
+		Test->TestTrue(FString::Printf(TEXT("%s pass probed through the wall probe"), Pass.Name), WallProbe->GetCacheMisses() > 0);
+
+		if (!Pass.bAsync)
+		{
+			Test->TestEqual(TEXT("Sync pass frames that missed a wall"), Misses, 0);
+			Test->TestEqual(TEXT("Sync pass async results"), WallProbe->GetAsyncResults(), 0);
+		}
+		else if (Pass.Speed <= WallProbe->GetAsyncMaxSpeed())
+		{
+			// an async result was traced from the previous frame, so it may be one frame late, but never more
+			Test->TestTrue(TEXT("Async pass served results from async probes"), WallProbe->GetAsyncResults() > 0);
+			Test->TestTrue(TEXT("Async pass was never more than a frame late"), MaxConsecutiveMisses <= 1);
+		}
+		else
+		{
+			// above the max async speed the probe falls back to sync traces, so nothing is late
+			Test->TestTrue(TEXT("Fast pass ran above the max async speed"), FastFrames > 0);
+			Test->TestEqual(TEXT("Fast pass frames that missed a wall above the max async speed"), FastMisses, 0);
+		}
+
+		Controller->UnPossess();
+		Controller->Destroy();
+		Character->Destroy();
+
+		Controller = nullptr;
+		Character = nullptr;
+	}
+
+	/** Destroys the corridor world */
+	void TearDown()
+	{
+		FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+		PreActorTickHandle.Reset();
+
+		PantherJamAutomation::DestroyGameWorld(World);
+		World = nullptr;
+		Character = nullptr;
+		Controller = nullptr;
+	}
+
+	FAutomationTestBase* Test;
+
+	UWorld* World = nullptr;
+
+	APantherJamGameCharacter* Character = nullptr;
+	APantherJamSimController* Controller = nullptr;
+
+	FDelegateHandle PreActorTickHandle;
+
+	int32 PassIndex = 0;
+	int32 Frame = 0;
+	int32 Misses = 0;
+	int32 ConsecutiveMisses = 0;
+	int32 MaxConsecutiveMisses = 0;
+	int32 FastFrames = 0;
+	int32 FastMisses = 0;
+	int32 WallRuns = 0;
+
+	bool bJumpHeld = false;
+	bool bWasWallRunning = false;
+	bool bShouldStartWallRun = false;
+	bool bFast = false;
+};
+
+/**
+ *  Checks the wall run character starts wall runs off sync probes right away, off async probes at most a frame late,
+ *  and falls back to sync probes above the max async speed, in a corridor with gaps.
+ *
+ *  Usage:
+ *  UnrealEditor PantherJam.uproject -nullrhi -unattended -ExecCmds="Automation RunTests PantherJam.Movement.AsyncWallProbe; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPantherJamAsyncWallProbeTest, "PantherJam.Movement.AsyncWallProbe",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FPantherJamAsyncWallProbeTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamWallProbeCorridorCommand(this));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,239 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PantherJamAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationEditorCommon.h"
+#include "SideScrollingCameraManager.h"
+#include "PantherJamInputRecordingSubsystem.h"
+#include "PantherJamInputReplayable.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace SideScrollingFloorProfileTest
+{
+	/** Side scrolling level with jump pads, moving and soft platforms */
+	static const TCHAR* MapName = TEXT("/Game/Variant_SideScrolling/Lvl_SideScrolling");
+
+	/** Name of the input recording made and played back by the test */
+	static const TCHAR* RecordingName = TEXT("AutomationFloorProfile");
+
+	/** Time the scripted run is recorded for */
+	static constexpr double RunDuration = 12.0;
+
+	/** Time between jumps in the scripted run */
+	static constexpr float JumpInterval = 1.2f;
+
+	/** Time the jump button is held */
+	static constexpr float JumpHoldTime = 0.4f;
+
+	/** Max time to wait for the playback to finish */
+	static constexpr double ReplayTimeout = 60.0;
+
+	/**
+	 *  Fraction of floor checks allowed to disagree with the trace.
+	 *  Moving platforms are only baked again after they move, so the profile can lag them by a frame
+	 */
+	static constexpr float MaxMismatchRate = 0.01f;
+
+	/** Returns the first PIE world */
+	static UWorld* GetPIEWorld()
+	{
+		const TArray<UWorld*> Worlds = PantherJamAutomation::GetPIEWorlds();
+
+		return Worlds.IsEmpty() ? nullptr : Worlds[0];
+	}
+}
+
+/**
+ *  Records a scripted run through the level: right then back left, jumping all the way
+ */
+class FSideScrollingRecordRunCommand : public IAutomationLatentCommand
+{
+public:
+
+	FSideScrollingRecordRunCommand(FAutomationTestBase* InTest)
+		: Test(InTest)
+	{}
+
+	virtual bool Update() override
+	{
+		using namespace SideScrollingFloorProfileTest;
+
+		UWorld* World = GetPIEWorld();
+		UPantherJamInputRecordingSubsystem* Recorder = World ? World->GetSubsystem<UPantherJamInputRecordingSubsystem>() : nullptr;
+		IPantherJamInputReplayable* Input = Cast<IPantherJamInputReplayable>(PantherJamAutomation::GetLocalPawn(World));
+
+		if (!Recorder || !Input)
+		{
+			Test->AddError(TEXT("No side scrolling player to record"));
+			return true;
+		}
+
+		if (!bStarted)
+		{
+			Recorder->StartRecording(RecordingName);
+			bStarted = true;
+		}
+
+		const float Time = (float)GetCurrentRunTime();
+
+		if (Time >= RunDuration)
+		{
+			Input->ReplayInput(EPantherJamInputAction::Move, FVector2f::ZeroVector);
+			Recorder->StopRecording();
+			return true;
+		}
+
+		// the inputs go through the same entry points as the bindings, so the recorder picks them up
+		Input->ReplayInput(EPantherJamInputAction::Move, FVector2f(Time < RunDuration * 0.5 ? 1.0f : -1.0f, 0.0f));
+
+		const bool bJumpHeld = FMath::Fmod(Time, JumpInterval) < JumpHoldTime;
+
+		if (bJumpHeld != bWasJumpHeld)
+		{
+			Input->ReplayInput(bJumpHeld ? EPantherJamInputAction::JumpStart : EPantherJamInputAction::JumpEnd, FVector2f::ZeroVector);
+			bWasJumpHeld = bJumpHeld;
+		}
+
+		return false;
+	}
+
+private:
+
+	FAutomationTestBase* Test;
+
+	bool bStarted = false;
+	bool bWasJumpHeld = false;
+};
+
+/**
+ *  Plays the recorded run back with floor profile validation on, and checks the profile rarely disagreed with the trace
+ */
+class FSideScrollingReplayRunCommand : public IAutomationLatentCommand
+{
+public:
+
+	FSideScrollingReplayRunCommand(FAutomationTestBase* InTest)
+		: Test(InTest)
+	{}
+
+	virtual bool Update() override
+	{
+		using namespace SideScrollingFloorProfileTest;
+
+		UWorld* World = GetPIEWorld();
+		UPantherJamInputRecordingSubsystem* Recorder = World ? World->GetSubsystem<UPantherJamInputRecordingSubsystem>() : nullptr;
+		const APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+		ASideScrollingCameraManager* Camera = PC ? Cast<ASideScrollingCameraManager>(PC->PlayerCameraManager) : nullptr;
+
+		if (!Recorder || !Camera)
+		{
+			Test->AddError(TEXT("No side scrolling player to replay into"));
+			return Finish();
+		}
+
+		if (!bStarted)
+		{
+			bStarted = true;
+
+			ValidateCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("SideScrolling.FloorProfile.Validate"));
+
+			if (ValidateCVar)
+			{
+				bPreviousValidate = ValidateCVar->GetBool();
+				ValidateCVar->Set(true, ECVF_SetByCode);
+			}
+
+			Camera->ResetFloorProfileCounters();
+
+			if (!Recorder->StartReplay(RecordingName))
+			{
+				Test->AddError(FString::Printf(TEXT("Couldn't load the %s recording"), RecordingName));
+				return Finish();
+			}
+
+			return false;
+		}
+
+		if (Recorder->IsReplaying())
+		{
+			if (GetCurrentRunTime() > ReplayTimeout)
+			{
+				Test->AddError(TEXT("Timed out waiting for the playback to finish"));
+				Recorder->StopReplay();
+				return Finish();
+			}
+
+			return false;
+		}
+
+		const int32 Checks = Camera->GetFloorProfileChecks();
+		const int32 Mismatches = Camera->GetFloorProfileMismatches();
+
+		Test->AddInfo(FString::Printf(TEXT("%d floor profile checks, %d mismatches"), Checks, Mismatches));
+
+		Test->TestTrue(TEXT("The camera validated the floor profile"), Checks > 0);
+		Test->TestTrue(FString::Printf(TEXT("Floor profile mismatches (%d of %d) are within %.0f%% of the checks"), Mismatches, Checks, MaxMismatchRate * 100.0f),
+			Mismatches <= FMath::FloorToInt32(Checks * MaxMismatchRate));
+
+		return Finish();
+	}
+
+private:
+
+	/** Restores the validation cvar */
+	bool Finish()
+	{
+		if (ValidateCVar)
+		{
+			ValidateCVar->Set(bPreviousValidate, ECVF_SetByCode);
+			ValidateCVar = nullptr;
+		}
+
+		return true;
+	}
+
+	FAutomationTestBase* Test;
+
+	IConsoleVariable* ValidateCVar = nullptr;
+
+	bool bPreviousValidate = false;
+	bool bStarted = false;
+};
+
+/**
+ *  Records a run through the side scrolling level, replays it in a fresh session with
+ *  SideScrolling.FloorProfile.Validate on, and checks the floor profile agreed with the trace on nearly every frame.
+ *
+ *  Usage:
+ *  UnrealEditor PantherJam.uproject -nullrhi -unattended -ExecCmds="Automation RunTests PantherJam.SideScrolling.FloorProfileReplay; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSideScrollingFloorProfileReplayTest, "PantherJam.SideScrolling.FloorProfileReplay",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FSideScrollingFloorProfileReplayTest::RunTest(const FString& Parameters)
+{
+	using namespace SideScrollingFloorProfileTest;
+
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(MapName));
+
+	// record the run
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamStartPIECommand(EPlayNetMode::PIE_Standalone, 1));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamWaitForPawnsCommand(this, 1, 30.0));
+	ADD_LATENT_AUTOMATION_COMMAND(FSideScrollingRecordRunCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamEndPIECommand());
+
+	// play it back from the start of the level
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamStartPIECommand(EPlayNetMode::PIE_Standalone, 1));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamWaitForPawnsCommand(this, 1, 30.0));
+	ADD_LATENT_AUTOMATION_COMMAND(FSideScrollingReplayRunCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FPantherJamEndPIECommand());
+
+	return true;
+}
+
+#endif
@@ -7,10 +7,21 @@
 #include "CombatAIController.h"
 #include "Components/WidgetComponent.h"
 #include "Engine/DamageEvents.h"
-#include "CombatLifeBar.h"
+#include "CombatLifeBarSubsystem.h"
 #include "TimerManager.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
+#include "CombatAttackTraceSubsystem.h"
+#include "CombatDamageQueueSubsystem.h"
+#include "CombatMontageSchedulerSubsystem.h"
+#include "CombatRagdollBudgetSubsystem.h"
+#include "CombatPreloadSubsystem.h"
+#include "CombatEnemyPoolSubsystem.h"
+#include "CombatCheckpointSubsystem.h"
+#include "PantherJamAILODSubsystem.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
+#include "UObject/ObjectSaveContext.h"
 
 ACombatEnemy::ACombatEnemy()
 {
@@ -32,6 +43,9 @@ ACombatEnemy::ACombatEnemy()
 	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// default to the shipped life bar widget
+	LifeBarWidgetClass = TSoftClassPtr<UCombatLifeBar>(FSoftObjectPath(TEXT("/Game/Variant_Combat/UI/UI_LifeBar.UI_LifeBar_C")));
+
 	// set the collision capsule size
 	GetCapsuleComponent()->SetCapsuleSize(35.0f, 90.0f);
 
@@ -60,17 +74,7 @@ void ACombatEnemy::DoAIComboAttack()
 	CurrentComboAttack = 0;
 
 	// play the attack montage
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-	{
-		const float MontageLength = AnimInstance->Montage_Play(ComboAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
-
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
-		{
-			// set the end delegate for the montage
-			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ComboAttackMontage);
-		}
-	}
+	UCombatMontageSchedulerSubsystem::PlayMontage(GetMesh(), UCombatPreloadSubsystem::GetOrLoad(this, ComboAttackMontage), ComboAttackTiming, OnAttackMontageEnded);
 }
 
 void ACombatEnemy::DoAIChargedAttack()
@@ -91,17 +95,7 @@ void ACombatEnemy::DoAIChargedAttack()
 	CurrentChargeLoop = 0;
 
 	// play the attack montage
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-	{
-		const float MontageLength = AnimInstance->Montage_Play(ChargedAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
-
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
-		{
-			// set the end delegate for the montage
-			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ChargedAttackMontage);
-		}
-	}
+	UCombatMontageSchedulerSubsystem::PlayMontage(GetMesh(), UCombatPreloadSubsystem::GetOrLoad(this, ChargedAttackMontage), ChargedAttackTiming, OnAttackMontageEnded);
 }
 
 void ACombatEnemy::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
@@ -115,45 +109,48 @@ void ACombatEnemy::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 
 void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(AttackTrace);
+
 	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
+	FCombatAttackTraceRequest Request;
+	Request.Attacker = this;
 
 	// start at the provided socket location, sweep forward
-	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
-	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
-
-	// enemies only affect Pawn collision objects; they don't knock back boxes
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	Request.Start = UCombatMontageSchedulerSubsystem::GetAttackSourceLocation(GetMesh(), DamageSourceBone);
+	Request.End = Request.Start + (GetActorForwardVector() * MeleeTraceDistance);
 
 	// use a sphere shape for the sweep
-	FCollisionShape CollisionShape;
-	CollisionShape.SetSphere(MeleeTraceRadius);
+	Request.Radius = MeleeTraceRadius;
 
-	// ignore self
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
+	// enemies only affect Pawn collision objects; they don't knock back boxes
+	Request.ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
 
-	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
+	// the hits will be passed back to ProcessAttackHits
+	UCombatAttackTraceSubsystem::RequestAttackTrace(Request);
+}
+
+void ACombatEnemy::ProcessAttackHits(const TArray<FHitResult>& Hits)
+{
+	// iterate over each object hit
+	for (const FHitResult& CurrentHit : Hits)
 	{
-		// iterate over each object hit
-		for (const FHitResult& CurrentHit : OutHits)
+		/** does the actor have the player tag? */
+		if (CurrentHit.GetActor()->ActorHasTag(FName("Player")))
 		{
-			/** does the actor have the player tag? */
-			if (CurrentHit.GetActor()->ActorHasTag(FName("Player")))
+			// check if the actor is damageable
+			if (Cast<ICombatDamageable>(CurrentHit.GetActor()))
 			{
-				// check if the actor is damageable
-				ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
-
-				if (Damageable)
-				{
-					// knock upwards and away from the impact normal
-					const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+				// knock upwards and away from the impact normal
+				FCombatDamageEvent DamageEvent;
+				DamageEvent.Target = CurrentHit.GetActor();
+				DamageEvent.Causer = this;
+				DamageEvent.Location = CurrentHit.ImpactPoint;
+				DamageEvent.Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+				DamageEvent.Damage = MeleeDamage;
 
-					// pass the damage event to the actor
-					Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+				// queue the damage for the actor
+				UCombatDamageQueueSubsystem::QueueDamage(DamageEvent);
 
-				}
 			}
 		}
 	}
@@ -168,10 +165,7 @@ void ACombatEnemy::CheckCombo()
 	if (CurrentComboAttack < TargetComboCount)
 	{
 		// jump to the next attack section
-		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-		{
-			AnimInstance->Montage_JumpToSection(ComboSectionNames[CurrentComboAttack], ComboAttackMontage);
-		}
+		UCombatMontageSchedulerSubsystem::JumpToSection(GetMesh(), ComboSectionNames[CurrentComboAttack], ComboAttackMontage.Get());
 	}
 }
 
@@ -181,14 +175,14 @@ void ACombatEnemy::CheckChargedAttack()
 	++CurrentChargeLoop;
 
 	// jump to either the loop or attack section of the montage depending on whether we hit the loop target
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-	{
-		AnimInstance->Montage_JumpToSection(CurrentChargeLoop >= TargetChargeLoops ? ChargeAttackSection : ChargeLoopSection, ChargedAttackMontage);
-	}
+	UCombatMontageSchedulerSubsystem::JumpToSection(GetMesh(), CurrentChargeLoop >= TargetChargeLoops ? ChargeAttackSection : ChargeLoopSection, ChargedAttackMontage.Get());
 }
 
 void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
+	// count the damage event
+	PANTHERJAM_INC_COUNTER(DamageEvents, 1);
+
 	
 	// pass the damage event to the actor
 	FDamageEvent DamageEvent;
@@ -207,22 +201,29 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 			GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
 		}
 
-		// stop the attack montages to interrupt the attack
-		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+		// stop the attack montages to interrupt the attack. Montages that haven't loaded can't be playing
+		if (UAnimMontage* Montage = ComboAttackMontage.Get())
 		{
-			AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
-			AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
+			UCombatMontageSchedulerSubsystem::StopMontage(GetMesh(), 0.1f, Montage);
+		}
+
+		if (UAnimMontage* Montage = ChargedAttackMontage.Get())
+		{
+			UCombatMontageSchedulerSubsystem::StopMontage(GetMesh(), 0.1f, Montage);
 		}
 
 		// pass control to BP to play effects, etc.
-		ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
+		if (FPantherJamPresentation::IsEnabled(this))
+		{
+			ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
+		}
 	}
 }
 
 void ACombatEnemy::HandleDeath()
 {
 	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	UCombatLifeBarSubsystem::SetLifeBarHidden(this, true);
 
 	// disable the collision capsule to avoid being hit again while dead
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -230,8 +231,8 @@ void ACombatEnemy::HandleDeath()
 	// disable character movement
 	GetCharacterMovement()->DisableMovement();
 
-	// enable full ragdoll physics
-	GetMesh()->SetSimulatePhysics(true);
+	// enable full ragdoll physics, within the ragdoll budget
+	UCombatRagdollBudgetSubsystem::StartRagdoll(GetMesh());
 
 	// call the died delegate to notify any subscribers
 	OnEnemyDied.Broadcast();
@@ -245,12 +246,137 @@ void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
+void ACombatEnemy::SerializeCheckpoint(FArchive& Ar)
+{
+	float SavedHP = CurrentHP;
+	FTransform Transform = GetActorTransform();
+
+	Ar << SavedHP << Transform;
+
+	// we can't come back to life in place once we've died
+	if (!Ar.IsLoading() || CurrentHP <= 0.0f)
+	{
+		return;
+	}
+
+	// did we die at the checkpoint?
+	if (SavedHP <= 0.0f)
+	{
+		CurrentHP = 0.0f;
+		HandleDeath();
+		return;
+	}
+
+	CurrentHP = SavedHP;
+
+	// move back to the checkpoint position
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	GetCharacterMovement()->StopMovementImmediately();
+
+	// update the life bar
+	UCombatLifeBarSubsystem::SetLifePercentage(this, CurrentHP / MaxHP);
+}
+
 void ACombatEnemy::RemoveFromLevel()
 {
+	// return to the enemy pool if we came from it
+	if (UCombatEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+	{
+		if (EnemyPool->ReleaseEnemy(this))
+		{
+			return;
+		}
+	}
+
 	// destroy this actor
 	Destroy();
 }
 
+void ACombatEnemy::DeactivateForPool()
+{
+	// stop managing our tick rate first so it doesn't override the deactivation
+	if (UPantherJamAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UPantherJamAILODSubsystem>())
+	{
+		AILOD->UnregisterAgent(this);
+	}
+
+	// clear the death timer in case we're deactivated early
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// unbind the previous spawner
+	OnEnemyDied.Clear();
+
+	// stop any attacks in progress
+	UCombatMontageSchedulerSubsystem::StopMontage(GetMesh(), 0.0f);
+
+	bIsAttacking = false;
+
+	// unpossess to stop the StateTree, but keep the controller around for reuse
+	PooledController = GetController();
+
+	if (PooledController)
+	{
+		PooledController->UnPossess();
+	}
+
+	// stop ragdolling and put the mesh back in place
+	UCombatRagdollBudgetSubsystem::StopRagdoll(GetMesh());
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeTransform(InitialMeshRelativeTransform);
+
+	// hide the enemy and take it out of the simulation
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->Deactivate();
+	GetMesh()->Deactivate();
+}
+
+void ACombatEnemy::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	// move to the spawn point
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// reset HP to maximum before the StateTree starts so it picks it up at the right value
+	CurrentHP = MaxHP;
+
+	// reset the attack state
+	CurrentComboAttack = 0;
+	CurrentChargeLoop = 0;
+
+	// restore collision and movement
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	SetActorEnableCollision(true);
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(true);
+
+	GetMesh()->Activate(true);
+	GetCharacterMovement()->Activate(true);
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// refill and show the life bar
+	UCombatLifeBarSubsystem::SetLifePercentage(this, 1.0f);
+	UCombatLifeBarSubsystem::SetLifeBarHidden(this, false);
+
+	// possess again to restart the StateTree
+	if (PooledController)
+	{
+		PooledController->Possess(this);
+		PooledController = nullptr;
+	}
+	else
+	{
+		SpawnDefaultController();
+	}
+
+	// resume managing our tick rate
+	if (UPantherJamAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UPantherJamAILODSubsystem>())
+	{
+		AILOD->RegisterAgent(this);
+	}
+}
+
 float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// only process damage if the character is still alive
@@ -271,11 +397,10 @@ float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEv
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		UCombatLifeBarSubsystem::SetLifePercentage(this, CurrentHP / MaxHP);
 
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		// enable partial ragdoll physics if the ragdoll budget allows, or play the additive hit reaction
+		UCombatRagdollBudgetSubsystem::StartHitReaction(GetMesh(), PelvisBoneName, HitReactionMontage.Get());
 	}
 
 	// return the received damage amount
@@ -290,7 +415,7 @@ void ACombatEnemy::Landed(const FHitResult& Hit)
 	if (CurrentHP >= 0.0f)
 	{
 		// disable ragdoll physics
-		GetMesh()->SetPhysicsBlendWeight(0.0f);
+		UCombatRagdollBudgetSubsystem::EndHitReaction(GetMesh());
 	}
 
 	// call the landed Delegate for StateTree
@@ -302,15 +427,43 @@ void ACombatEnemy::BeginPlay()
 	// reset HP to maximum
 	CurrentHP = MaxHP;
 
+	// batched life bars are drawn by a shared layer, so keep the component from building its own widget
+	if (UCombatLifeBarSubsystem::IsBatched())
+	{
+		LifeBar->SetWidgetClass(nullptr);
+	}
+
 	// we top the HP before BeginPlay so StateTree picks it up at the right value
 	Super::BeginPlay();
 
-	// get the life bar widget from the widget comp
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
+	// save the mesh placement so we can restore it after ragdolling
+	InitialMeshRelativeTransform = GetMesh()->GetRelativeTransform();
+
+	// let batched attack traces hit us where we were when they were requested
+	UCombatAttackTraceSubsystem::RegisterTarget(this);
+
+	if (FPantherJamPresentation::IsEnabled(this))
+	{
+		// add our life bar to the shared life bar layer
+		UCombatLifeBarSubsystem::RegisterLifeBar(this, LifeBar, LifeBarColor, LifeBarWidgetClass);
+	}
+	else
+	{
+		// nobody is watching on a dedicated server, so switch off the life bar
+		FPantherJamPresentation::DisableComponent(LifeBar);
+
+		// skip animation entirely. Attacks play from their timing tables instead
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
 
-	// fill the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	// let the AI LOD manage our tick rate
+	if (UPantherJamAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UPantherJamAILODSubsystem>())
+	{
+		AILOD->RegisterAgent(this);
+	}
+
+	// save our state with the checkpoints if we were placed in the level
+	UCombatCheckpointSubsystem::RegisterCheckpointable(this);
 }
 
 void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -319,4 +472,39 @@ void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// stop managing our tick rate
+	if (UPantherJamAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UPantherJamAILODSubsystem>())
+	{
+		AILOD->UnregisterAgent(this);
+	}
+
+	UCombatAttackTraceSubsystem::UnregisterTarget(this);
+
+	// remove our life bar
+	UCombatLifeBarSubsystem::UnregisterLifeBar(this);
+}
+
+void ACombatEnemy::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	OutAssets.Add(ComboAttackMontage.ToSoftObjectPath());
+	OutAssets.Add(ChargedAttackMontage.ToSoftObjectPath());
+	OutAssets.Add(HitReactionMontage.ToSoftObjectPath());
+
+	// the life bar widget is only used when life bars aren't batched
+	if (!UCombatLifeBarSubsystem::IsBatched())
+	{
+		OutAssets.Add(LifeBarWidgetClass.ToSoftObjectPath());
+	}
+}
+
+#if WITH_EDITOR
+void ACombatEnemy::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	// bake the attack montages so they can be played without animating the mesh
+	ComboAttackTiming.Build(ComboAttackMontage.LoadSynchronous());
+	ChargedAttackTiming.Build(ChargedAttackMontage.LoadSynchronous());
 }
+#endif
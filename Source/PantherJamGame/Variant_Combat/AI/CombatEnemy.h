@@ -6,6 +6,8 @@
 #include "GameFramework/Character.h"
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
+#include "CombatCheckpointable.h"
+#include "CombatMontageTiming.h"
 #include "Animation/AnimMontage.h"
 #include "Engine/TimerHandle.h"
 #include "CombatEnemy.generated.h"
@@ -28,11 +30,11 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEnemyDied);
  *  Its bundled AI Controller runs logic through StateTree
  */
 UCLASS(abstract)
-class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable
+class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 
-	/** Life bar widget component */
+	/** Life bar widget component. Only draws when life bars aren't batched, otherwise it just places the bar */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = UI, meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* LifeBar;
 
@@ -59,9 +61,17 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
+	/** Additive hit reaction played instead of the partial ragdoll when the ragdoll budget is full. Skipped if it hasn't loaded yet */
 	UPROPERTY(EditAnywhere, Category="Damage")
-	UCombatLifeBar* LifeBarWidget;
+	TSoftObjectPtr<UAnimMontage> HitReactionMontage;
+
+	/** Life bar fill color */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	FLinearColor LifeBarColor = FLinearColor::Red;
+
+	/** Life bar widget class. If set, it replaces the life bar component's widget class once loaded, when life bars aren't batched */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	TSoftClassPtr<UCombatLifeBar> LifeBarWidgetClass;
 
 	/** If true, the character is currently playing an attack animation */
 	bool bIsAttacking = false;
@@ -86,23 +96,31 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
 	float MeleeLaunchImpulse = 350.0f;
 
-	/** AnimMontage that will play for combo attacks */
+	/** AnimMontage that will play for combo attacks. Loaded on demand */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
-	UAnimMontage* ComboAttackMontage;
+	TSoftObjectPtr<UAnimMontage> ComboAttackMontage;
 
 	/** Names of the AnimMontage sections that correspond to each stage of the combo attack */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
 	TArray<FName> ComboSectionNames;
 
+	/** Sections and notifies of the combo attack montage, used when the mesh isn't animating */
+	UPROPERTY(VisibleAnywhere, Category="Melee Attack|Combo")
+	FCombatMontageTimingTable ComboAttackTiming;
+
 	/** Target number of attacks in the combo attack string we're playing */
 	int32 TargetComboCount = 0;
 
 	/** Index of the current stage of the melee attack combo */
 	int32 CurrentComboAttack = 0;
 
-	/** AnimMontage that will play for charged attacks */
+	/** AnimMontage that will play for charged attacks. Loaded on demand */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
-	UAnimMontage* ChargedAttackMontage;
+	TSoftObjectPtr<UAnimMontage> ChargedAttackMontage;
+
+	/** Sections and notifies of the charged attack montage, used when the mesh isn't animating */
+	UPROPERTY(VisibleAnywhere, Category="Melee Attack|Charged")
+	FCombatMontageTimingTable ChargedAttackTiming;
 
 	/** Name of the AnimMontage section that corresponds to the charge loop */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
@@ -133,6 +151,16 @@ protected:
 	/** Enemy death timer */
 	FTimerHandle DeathTimer;
 
+	/** If true, this enemy is managed by the enemy pool and will be returned to it instead of being destroyed */
+	bool bIsPooled = false;
+
+	/** AI controller kept while this enemy waits in the pool, so it can be possessed again on reuse */
+	UPROPERTY(Transient)
+	TObjectPtr<AController> PooledController;
+
+	/** Mesh relative transform at BeginPlay, restored after ragdolling */
+	FTransform InitialMeshRelativeTransform;
+
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
@@ -165,6 +193,9 @@ public:
 	/** Performs an attack's collision check */
 	virtual void DoAttackTrace(FName DamageSourceBone) override;
 
+	/** Handles the hits from an attack's collision check */
+	virtual void ProcessAttackHits(const TArray<FHitResult>& Hits) override;
+
 	/** Performs a combo attack's check to continue the string */
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void CheckCombo() override;
@@ -188,11 +219,35 @@ public:
 
 	// ~end ICombatDamageable interface
 
+	// ~begin ICombatCheckpointable interface
+
+	/** Saves or restores the HP and placement. Enemies that have died can't be brought back here, their spawner spawns new ones instead */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~end ICombatCheckpointable interface
+
 protected:
 
 	/** Removes this character from the level after it dies */
 	void RemoveFromLevel();
 
+public:
+
+	/** Returns true if this enemy is managed by the enemy pool */
+	bool IsPooled() const { return bIsPooled; }
+
+	/** Sets whether this enemy is managed by the enemy pool */
+	void SetPooled(bool bPooled) { bIsPooled = bPooled; }
+
+	/** Hides this enemy, stops its AI and disables collision and ticking while it waits in the pool */
+	void DeactivateForPool();
+
+	/** Resets this enemy to its spawned state at the given transform and restarts its AI */
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	/** Appends the soft referenced assets this enemy needs, so spawners can preload them */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
@@ -214,4 +269,9 @@ protected:
 
 	/** EndPlay cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+#if WITH_EDITOR
+	/** Rebuilds the attack montage timing tables whenever the enemy is saved or cooked */
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
 };
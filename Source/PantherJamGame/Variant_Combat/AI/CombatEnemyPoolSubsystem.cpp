@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyPoolSubsystem.h"
+#include "CombatEnemy.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Stats/Stats.h"
+#include "PantherJamStats.h"
+
+DECLARE_STATS_GROUP(TEXT("CombatEnemyPool"), STATGROUP_CombatEnemyPool, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Acquire Enemy"), STAT_CombatEnemyPoolAcquire, STATGROUP_CombatEnemyPool);
+DECLARE_CYCLE_STAT(TEXT("Release Enemy"), STAT_CombatEnemyPoolRelease, STATGROUP_CombatEnemyPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Hits"), STAT_CombatEnemyPoolHits, STATGROUP_CombatEnemyPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Misses"), STAT_CombatEnemyPoolMisses, STATGROUP_CombatEnemyPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Inactive Enemies"), STAT_CombatEnemyPoolInactive, STATGROUP_CombatEnemyPool);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Pool Hit Rate"), STAT_CombatEnemyPoolHitRate, STATGROUP_CombatEnemyPool);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Spawn Time Saved (ms)"), STAT_CombatEnemyPoolTimeSaved, STATGROUP_CombatEnemyPool);
+
+void UCombatEnemyPoolSubsystem::PrewarmPool(TSubclassOf<ACombatEnemy> EnemyClass, int32 Count, const FTransform& SpawnTransform)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return;
+	}
+
+	FCombatEnemyPool& Pool = Pools.FindOrAdd(EnemyClass);
+
+	// spawn and immediately deactivate enemies until the pool is full
+	while (Pool.InactiveEnemies.Num() < Count)
+	{
+		ACombatEnemy* Enemy = SpawnPooledEnemy(EnemyClass, SpawnTransform);
+
+		if (!Enemy)
+		{
+			break;
+		}
+
+		Enemy->DeactivateForPool();
+		Pool.InactiveEnemies.Add(Enemy);
+	}
+
+	UpdateStats();
+}
+
+ACombatEnemy* UCombatEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatEnemyPoolAcquire);
+
+	if (!IsValid(EnemyClass))
+	{
+		return nullptr;
+	}
+
+	PANTHERJAM_INC_COUNTER(Spawns, 1);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// do we have an inactive enemy we can reuse?
+	if (FCombatEnemyPool* Pool = Pools.Find(EnemyClass))
+	{
+		while (Pool->InactiveEnemies.Num() > 0)
+		{
+			ACombatEnemy* Enemy = Pool->InactiveEnemies.Pop(EAllowShrinking::No);
+
+			// skip any enemies that were destroyed while pooled, e.g. by a kill volume
+			if (!IsValid(Enemy))
+			{
+				continue;
+			}
+
+			Enemy->ActivateFromPool(SpawnTransform);
+
+			++PoolHits;
+			TotalReuseTime += FPlatformTime::Seconds() - StartTime;
+			UpdateStats();
+
+			return Enemy;
+		}
+	}
+
+	// spawn a new enemy
+	ACombatEnemy* Enemy = SpawnPooledEnemy(EnemyClass, SpawnTransform);
+
+	++PoolMisses;
+	TotalSpawnTime += FPlatformTime::Seconds() - StartTime;
+	UpdateStats();
+
+	return Enemy;
+}
+
+bool UCombatEnemyPoolSubsystem::ReleaseEnemy(ACombatEnemy* Enemy)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatEnemyPoolRelease);
+
+	// ignore enemies we didn't spawn, such as the ones placed in the level
+	if (!IsValid(Enemy) || !Enemy->IsPooled())
+	{
+		return false;
+	}
+
+	Enemy->DeactivateForPool();
+
+	Pools.FindOrAdd(Enemy->GetClass()).InactiveEnemies.Add(Enemy);
+
+	UpdateStats();
+
+	return true;
+}
+
+float UCombatEnemyPoolSubsystem::GetPoolHitRate() const
+{
+	const int32 Acquisitions = PoolHits + PoolMisses;
+
+	return Acquisitions > 0 ? float(PoolHits) / float(Acquisitions) : 0.0f;
+}
+
+float UCombatEnemyPoolSubsystem::GetSpawnTimeSavedMs() const
+{
+	// we can only estimate the savings once we've measured at least one spawn
+	if (PoolMisses == 0)
+	{
+		return 0.0f;
+	}
+
+	const double AverageSpawnTime = TotalSpawnTime / PoolMisses;
+
+	return float((AverageSpawnTime * PoolHits - TotalReuseTime) * 1000.0);
+}
+
+void UCombatEnemyPoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatEnemyPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ACombatEnemy* UCombatEnemyPoolSubsystem::SpawnPooledEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform) const
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	ACombatEnemy* Enemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+
+	// flag the enemy so it returns to the pool instead of being destroyed
+	if (Enemy)
+	{
+		Enemy->SetPooled(true);
+	}
+
+	return Enemy;
+}
+
+void UCombatEnemyPoolSubsystem::UpdateStats() const
+{
+	int32 InactiveEnemies = 0;
+
+	for (const TPair<TSubclassOf<ACombatEnemy>, FCombatEnemyPool>& Pool : Pools)
+	{
+		InactiveEnemies += Pool.Value.InactiveEnemies.Num();
+	}
+
+	SET_DWORD_STAT(STAT_CombatEnemyPoolHits, PoolHits);
+	SET_DWORD_STAT(STAT_CombatEnemyPoolMisses, PoolMisses);
+	SET_DWORD_STAT(STAT_CombatEnemyPoolInactive, InactiveEnemies);
+	SET_FLOAT_STAT(STAT_CombatEnemyPoolHitRate, GetPoolHitRate());
+	SET_FLOAT_STAT(STAT_CombatEnemyPoolTimeSaved, GetSpawnTimeSavedMs());
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatEnemyPoolSubsystem.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  Inactive enemies of a single class, waiting to be reused
+ */
+USTRUCT()
+struct FCombatEnemyPool
+{
+	GENERATED_BODY()
+
+	/** Enemies ready to be acquired */
+	UPROPERTY()
+	TArray<TObjectPtr<ACombatEnemy>> InactiveEnemies;
+};
+
+/**
+ *  Keeps pools of inactive enemies, keyed by class, so spawners can reuse dead enemies
+ *  instead of paying for SpawnActor, component registration, StateTree startup and widget creation every time.
+ *  Pool hit rate and estimated spawn time savings are reported under "stat CombatEnemyPool"
+ */
+UCLASS()
+class UCombatEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Inactive enemy pools, keyed by enemy class */
+	UPROPERTY()
+	TMap<TSubclassOf<ACombatEnemy>, FCombatEnemyPool> Pools;
+
+	/** Number of acquisitions served from a pool */
+	int32 PoolHits = 0;
+
+	/** Number of acquisitions that had to spawn a new enemy */
+	int32 PoolMisses = 0;
+
+	/** Total time spent spawning new enemies on pool misses, in seconds */
+	double TotalSpawnTime = 0.0;
+
+	/** Total time spent reactivating pooled enemies on pool hits, in seconds */
+	double TotalReuseTime = 0.0;
+
+public:
+
+	/** Spawns enemies of the given class until its pool holds at least Count inactive enemies */
+	void PrewarmPool(TSubclassOf<ACombatEnemy> EnemyClass, int32 Count, const FTransform& SpawnTransform);
+
+	/** Returns an active enemy of the given class at the given transform, reusing a pooled enemy if one is available */
+	ACombatEnemy* AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform);
+
+	/** Deactivates a pooled enemy and returns it to its pool. Returns false if the enemy isn't managed by the pool */
+	bool ReleaseEnemy(ACombatEnemy* Enemy);
+
+	/** Returns the fraction of acquisitions served from a pool */
+	UFUNCTION(BlueprintPure, Category="Enemy Pool")
+	float GetPoolHitRate() const;
+
+	/** Returns the estimated time saved by reusing pooled enemies instead of spawning them, in milliseconds */
+	UFUNCTION(BlueprintPure, Category="Enemy Pool")
+	float GetSpawnTimeSavedMs() const;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Spawns a new pooled enemy */
+	ACombatEnemy* SpawnPooledEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform) const;
+
+	/** Updates the pool stats */
+	void UpdateStats() const;
+};
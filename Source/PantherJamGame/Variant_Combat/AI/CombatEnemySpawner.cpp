@@ -7,6 +7,11 @@
 #include "Components/ArrowComponent.h"
 #include "TimerManager.h"
 #include "CombatEnemy.h"
+#include "CombatEnemyPoolSubsystem.h"
+#include "CombatSpawnSchedulerSubsystem.h"
+#include "CombatPreloadSubsystem.h"
+#include "CombatCheckpointSubsystem.h"
+#include "PantherJamStats.h"
 
 ACombatEnemySpawner::ACombatEnemySpawner()
 {
@@ -30,7 +35,13 @@ ACombatEnemySpawner::ACombatEnemySpawner()
 void ACombatEnemySpawner::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// start loading our enemy right away if we'll need it soon. Otherwise wait until we're approached or activated
+	if (bShouldSpawnEnemiesImmediately || !UCombatPreloadSubsystem::IsAsyncEnabled())
+	{
+		PreloadEnemy();
+	}
+
 	// should we spawn an enemy right away?
 	if (bShouldSpawnEnemiesImmediately)
 	{
@@ -38,6 +49,8 @@ void ACombatEnemySpawner::BeginPlay()
 		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, InitialSpawnDelay);
 	}
 
+	// save our progress with the checkpoints
+	UCombatCheckpointSubsystem::RegisterCheckpointable(this);
 }
 
 void ACombatEnemySpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -46,30 +59,102 @@ void ACombatEnemySpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the spawn timer
 	GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
+
+	// drop any spawns still waiting in the queue
+	UCombatSpawnSchedulerSubsystem::CancelSpawns(this);
+}
+
+void ACombatEnemySpawner::PrewarmEnemyPool()
+{
+	// fill the enemy pool so the first enemies don't need to be spawned during gameplay
+	if (UCombatEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+	{
+		EnemyPool->PrewarmPool(EnemyClass.Get(), FMath::Min(PoolPrewarmCount, SpawnCount), SpawnCapsule->GetComponentTransform());
+	}
+}
+
+void ACombatEnemySpawner::PreloadEnemy()
+{
+	// ensure we only request the assets once
+	if (bHasRequestedPreload || EnemyClass.IsNull())
+	{
+		return;
+	}
+
+	bHasRequestedPreload = true;
+
+	UCombatPreloadSubsystem::RequestPreload(this, { EnemyClass.ToSoftObjectPath() }, FSimpleDelegate::CreateUObject(this, &ACombatEnemySpawner::OnEnemyClassLoaded));
+}
+
+void ACombatEnemySpawner::OnEnemyClassLoaded()
+{
+	// the enemy's montages and widgets are soft referenced too, so they can only be requested once we have its class
+	TArray<FSoftObjectPath> EnemyAssets;
+
+	if (UClass* LoadedClass = EnemyClass.Get())
+	{
+		LoadedClass->GetDefaultObject<ACombatEnemy>()->GetPreloadAssets(EnemyAssets);
+	}
+
+	UCombatPreloadSubsystem::RequestPreload(this, EnemyAssets, FSimpleDelegate::CreateUObject(this, &ACombatEnemySpawner::OnEnemyAssetsLoaded));
+}
+
+void ACombatEnemySpawner::OnEnemyAssetsLoaded()
+{
+	// fill the enemy pool on the next tick, once every actor in the level has begun play
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ACombatEnemySpawner::PrewarmEnemyPool);
 }
 
 void ACombatEnemySpawner::SpawnEnemy()
 {
 	// ensure the enemy class is valid
-	if (IsValid(EnemyClass))
+	if (!EnemyClass.IsNull())
 	{
-		// spawn the enemy at the reference capsule's transform
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		// queue the spawn with the other spawners
+		UCombatSpawnSchedulerSubsystem::RequestSpawn(this, SpawnCapsule->GetComponentLocation());
+	}
+}
+
+void ACombatEnemySpawner::SpawnQueuedEnemy()
+{
+	// get the enemy class, only blocking if it still hasn't loaded
+	const TSubclassOf<ACombatEnemy> LoadedClass = UCombatPreloadSubsystem::GetOrLoad(this, EnemyClass);
+
+	// ensure the enemy class is valid
+	if (IsValid(LoadedClass))
+	{
+		ACombatEnemy* SpawnedEnemy = nullptr;
+
+		// get the enemy from the pool at the reference capsule's transform
+		if (UCombatEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+		{
+			SpawnedEnemy = EnemyPool->AcquireEnemy(LoadedClass, SpawnCapsule->GetComponentTransform());
+		}
+		else
+		{
+			PANTHERJAM_INC_COUNTER(Spawns, 1);
 
-		ACombatEnemy* SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+			SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(LoadedClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+		}
 
 		// was the enemy successfully created?
 		if (SpawnedEnemy)
 		{
 			// subscribe to the death delegate
 			SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+
+			CurrentEnemy = SpawnedEnemy;
 		}
 	}
 }
 
 void ACombatEnemySpawner::OnEnemyDied()
 {
+	CurrentEnemy = nullptr;
+
 	// decrease the spawn counter
 	--SpawnCount;
 
@@ -115,6 +200,17 @@ void ACombatEnemySpawner::ActivateInteraction(AActor* ActivationInstigator)
 	// raise the activation flag
 	bHasBeenActivated = true;
 
+	// make sure our enemy is loading, and get the spawners we activate when depleted loading too
+	PreloadEnemy();
+
+	for (AActor* CurrentActor : ActorsToActivateWhenDepleted)
+	{
+		if (ACombatEnemySpawner* NextSpawner = Cast<ACombatEnemySpawner>(CurrentActor))
+		{
+			NextSpawner->PreloadEnemy();
+		}
+	}
+
 	// spawn the first enemy
 	SpawnEnemy();
 }
@@ -123,3 +219,52 @@ void ACombatEnemySpawner::DeactivateInteraction(AActor* ActivationInstigator)
 {
 	// stub
 }
+
+void ACombatEnemySpawner::SerializeCheckpoint(FArchive& Ar)
+{
+	uint8 bHasEnemy = IsValid(CurrentEnemy);
+	uint8 bActivated = bHasBeenActivated;
+
+	Ar << SpawnCount << bActivated << bHasEnemy;
+
+	if (Ar.IsLoading())
+	{
+		bHasBeenActivated = bActivated != 0;
+
+		// drop any spawn in progress
+		GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
+		UCombatSpawnSchedulerSubsystem::CancelSpawns(this);
+
+		// put away the current enemy. It'll be replaced if the checkpoint had one
+		if (IsValid(CurrentEnemy))
+		{
+			CurrentEnemy->OnEnemyDied.RemoveDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+
+			UCombatEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>();
+
+			if (!EnemyPool || !EnemyPool->ReleaseEnemy(CurrentEnemy))
+			{
+				CurrentEnemy->Destroy();
+			}
+		}
+
+		CurrentEnemy = nullptr;
+
+		if (bHasEnemy)
+		{
+			// bring the enemy back right away instead of going through the spawn queue
+			SpawnQueuedEnemy();
+		}
+		else if (SpawnCount > 0 && (bHasBeenActivated || bShouldSpawnEnemiesImmediately))
+		{
+			// we were waiting for the next enemy
+			GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, RespawnDelay);
+		}
+	}
+
+	// the enemy's state goes last, so it can be skipped if it failed to spawn
+	if (bHasEnemy && IsValid(CurrentEnemy))
+	{
+		CurrentEnemy->SerializeCheckpoint(Ar);
+	}
+}
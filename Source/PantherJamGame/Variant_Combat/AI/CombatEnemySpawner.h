@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "CombatActivatable.h"
+#include "CombatCheckpointable.h"
 #include "CombatEnemySpawner.generated.h"
 
 class UCapsuleComponent;
@@ -14,11 +15,14 @@ class ACombatEnemy;
 /**
  *  A basic Actor in charge of spawning Enemy Characters and monitoring their deaths.
  *  Enemies will be spawned one by one, and the spawner will wait until the enemy dies before spawning a new one.
+ *  Spawns go through the spawn scheduler, so they may be delayed by a few frames when many spawners fire at once.
+ *  The enemy class and its assets are soft referenced, and start loading when the spawner is approached or activated.
  *  The spawner can be remotely activated through the ICombatActivatable interface
  *  When the last spawned enemy dies, the spawner can also activate other ICombatActivatables
+ *  Its progress and the state of its live enemy are saved with the combat checkpoints
  */
 UCLASS(abstract)
-class ACombatEnemySpawner : public AActor, public ICombatActivatable
+class ACombatEnemySpawner : public AActor, public ICombatActivatable, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 	
@@ -30,9 +34,9 @@ class ACombatEnemySpawner : public AActor, public ICombatActivatable
 
 protected:
 
-	/** Type of enemy to spawn */
+	/** Type of enemy to spawn. Loaded on demand */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
-	TSubclassOf<ACombatEnemy> EnemyClass;
+	TSoftClassPtr<ACombatEnemy> EnemyClass;
 
 	/** If true, the first enemy will be spawned as soon as the game starts */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
@@ -46,6 +50,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 100))
 	int32 SpawnCount = 1;
 
+	/** Number of enemies to spawn into the enemy pool on BeginPlay, so they can be reused instead of spawned */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 100))
+	int32 PoolPrewarmCount = 1;
+
 	/** Time to wait before spawning the next enemy after the current one dies */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
 	float RespawnDelay = 5.0f;
@@ -61,9 +69,16 @@ protected:
 	/** Flag to ensure this is only activated once */
 	bool bHasBeenActivated = false;
 
+	/** Flag to ensure the enemy assets are only requested once */
+	bool bHasRequestedPreload = false;
+
 	/** Timer to spawn enemies after a delay */
 	FTimerHandle SpawnTimer;
 
+	/** Enemy currently alive, if any */
+	UPROPERTY(Transient)
+	TObjectPtr<ACombatEnemy> CurrentEnemy;
+
 public:	
 	
 	/** Constructor */
@@ -79,7 +94,16 @@ public:
 
 protected:
 
-	/** Spawn an enemy and subscribe to its death event */
+	/** Spawns enemies into the enemy pool ahead of time */
+	void PrewarmEnemyPool();
+
+	/** Called when the enemy class has loaded, to load the enemy's own assets */
+	void OnEnemyClassLoaded();
+
+	/** Called when the enemy class and its assets have loaded */
+	void OnEnemyAssetsLoaded();
+
+	/** Asks the spawn scheduler for the next enemy */
 	void SpawnEnemy();
 
 	/** Called when the spawned enemy has died */
@@ -91,6 +115,12 @@ protected:
 
 public:
 
+	/** Acquire an enemy from the enemy pool and subscribe to its death event. Called by the spawn scheduler */
+	void SpawnQueuedEnemy();
+
+	/** Starts loading the enemy class and its assets, then fills the enemy pool */
+	void PreloadEnemy();
+
 	// ~begin ICombatActivatable interface
 
 	/** Toggles the Spawner */
@@ -106,4 +136,11 @@ public:
 	virtual void DeactivateInteraction(AActor* ActivationInstigator) override;
 
 	// ~end IActivatable interface
+
+	// ~begin ICombatCheckpointable interface
+
+	/** Saves or restores the spawn progress and the live enemy, then reschedules spawning */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~end ICombatCheckpointable interface
 };
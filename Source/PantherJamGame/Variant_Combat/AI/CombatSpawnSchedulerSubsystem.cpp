@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSpawnSchedulerSubsystem.h"
+#include "CombatEnemySpawner.h"
+#include "PantherJamPlayerSnapshotSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<bool> CVarSpawnQueue(
+	TEXT("Combat.SpawnQueue"),
+	true,
+	TEXT("If true, enemy spawner spawns are queued and served within Combat.SpawnQueueBudgetMs per frame. If false, enemies spawn immediately."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpawnQueueBudgetMs(
+	TEXT("Combat.SpawnQueueBudgetMs"),
+	2.0f,
+	TEXT("Time the spawn queue may spend spawning enemies each frame, in milliseconds. At least one enemy is spawned per frame."),
+	ECVF_Default);
+
+/** Orders the request heap so the closest spawn is on top */
+struct FCombatSpawnRequestPredicate
+{
+	bool operator()(const FCombatSpawnRequest& A, const FCombatSpawnRequest& B) const
+	{
+		return A.Priority < B.Priority;
+	}
+};
+
+void UCombatSpawnSchedulerSubsystem::RequestSpawn(ACombatEnemySpawner* Spawner, const FVector& Location)
+{
+	if (!Spawner)
+	{
+		return;
+	}
+
+	// queue the spawn if queueing is enabled for this world
+	if (CVarSpawnQueue.GetValueOnGameThread())
+	{
+		if (UCombatSpawnSchedulerSubsystem* Subsystem = Spawner->GetWorld()->GetSubsystem<UCombatSpawnSchedulerSubsystem>())
+		{
+			FCombatSpawnRequest Request;
+			Request.Spawner = Spawner;
+			Request.Location = Location;
+			Request.RequestTime = FPlatformTime::Seconds();
+
+			// the priority is refreshed before the request is served
+			Subsystem->PendingRequests.HeapPush(Request, FCombatSpawnRequestPredicate());
+			return;
+		}
+	}
+
+	// spawn the enemy immediately
+	Spawner->SpawnQueuedEnemy();
+}
+
+void UCombatSpawnSchedulerSubsystem::CancelSpawns(ACombatEnemySpawner* Spawner)
+{
+	if (!Spawner)
+	{
+		return;
+	}
+
+	if (UCombatSpawnSchedulerSubsystem* Subsystem = Spawner->GetWorld()->GetSubsystem<UCombatSpawnSchedulerSubsystem>())
+	{
+		const int32 NumRemoved = Subsystem->PendingRequests.RemoveAll([Spawner](const FCombatSpawnRequest& Request) { return Request.Spawner.Get() == Spawner; });
+
+		if (NumRemoved > 0)
+		{
+			Subsystem->PendingRequests.Heapify(FCombatSpawnRequestPredicate());
+		}
+	}
+}
+
+void UCombatSpawnSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessRequests();
+
+	PANTHERJAM_INC_COUNTER(SpawnQueueDepth, PendingRequests.Num());
+}
+
+TStatId UCombatSpawnSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatSpawnSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatSpawnSchedulerSubsystem::Deinitialize()
+{
+	PendingRequests.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatSpawnSchedulerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatSpawnSchedulerSubsystem::ProcessRequests()
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(SpawnQueue);
+
+	if (PendingRequests.IsEmpty())
+	{
+		return;
+	}
+
+	// refresh the priorities, since the players have moved since the requests were queued
+	UPantherJamPlayerSnapshotSubsystem* PlayerSnapshots = UPantherJamPlayerSnapshotSubsystem::Get(this);
+
+	for (FCombatSpawnRequest& Request : PendingRequests)
+	{
+		const FPantherJamPlayerSnapshot* ClosestPlayer = PlayerSnapshots ? PlayerSnapshots->FindClosestPlayer(Request.Location) : nullptr;
+
+		Request.Priority = ClosestPlayer ? FVector::DistSquared(Request.Location, ClosestPlayer->Location) : 0.0;
+	}
+
+	PendingRequests.Heapify(FCombatSpawnRequestPredicate());
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = CVarSpawnQueueBudgetMs.GetValueOnGameThread() / 1000.0;
+
+	double MaxLatency = 0.0;
+
+	// always serve at least one request so the queue can't stall on a small budget
+	do
+	{
+		FCombatSpawnRequest Request;
+		PendingRequests.HeapPop(Request, FCombatSpawnRequestPredicate(), EAllowShrinking::No);
+
+		// skip requests from spawners that were destroyed while queued
+		ACombatEnemySpawner* Spawner = Request.Spawner.Get();
+
+		if (!Spawner)
+		{
+			continue;
+		}
+
+		MaxLatency = FMath::Max(MaxLatency, FPlatformTime::Seconds() - Request.RequestTime);
+
+		Spawner->SpawnQueuedEnemy();
+
+	} while (!PendingRequests.IsEmpty() && FPlatformTime::Seconds() - StartTime < Budget);
+
+	PANTHERJAM_INC_FLOAT_COUNTER(SpawnQueueLatency, MaxLatency * 1000.0);
+}
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatSpawnSchedulerSubsystem.generated.h"
+
+class ACombatEnemySpawner;
+
+/**
+ *  A pending enemy spawn from an enemy spawner
+ */
+struct FCombatSpawnRequest
+{
+	/** Spawner that asked for the enemy */
+	TWeakObjectPtr<ACombatEnemySpawner> Spawner;
+
+	/** Where the enemy will appear */
+	FVector Location = FVector::ZeroVector;
+
+	/** Squared distance to the closest player, refreshed every frame. Closer spawns are served first */
+	double Priority = 0.0;
+
+	/** Platform time the spawn was requested at */
+	double RequestTime = 0.0;
+};
+
+/**
+ *  Takes enemy spawn requests from every enemy spawner and serves them within a per frame time budget,
+ *  so spawners whose timers fire on the same tick don't pay for all of their SpawnActor calls,
+ *  widget components, AI controllers and StateTree startups in a single frame.
+ *  Requests closest to a player are served first. At least one request is served every frame.
+ *  Queue depth, processing time and wait latency are reported under "stat PantherJam".
+ *  Can be toggled with Combat.SpawnQueue to fall back to spawning immediately.
+ */
+UCLASS()
+class UCombatSpawnSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Pending requests, kept as a heap on Priority */
+	TArray<FCombatSpawnRequest> PendingRequests;
+
+public:
+
+	/** Spawns an enemy for the spawner, either through the queue or immediately */
+	static void RequestSpawn(ACombatEnemySpawner* Spawner, const FVector& Location);
+
+	/** Drops any pending requests from the spawner */
+	static void CancelSpawns(ACombatEnemySpawner* Spawner);
+
+	/** Returns the number of pending requests */
+	int32 GetQueueDepth() const { return PendingRequests.Num(); }
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Serves pending requests until the frame budget runs out */
+	void ProcessRequests();
+};
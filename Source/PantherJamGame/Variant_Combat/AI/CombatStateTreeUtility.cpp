@@ -8,11 +8,14 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "AIController.h"
 #include "CombatEnemy.h"
-#include "Kismet/GameplayStatics.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "PantherJamPlayerSnapshotSubsystem.h"
+#include "PantherJamStats.h"
 
 bool FStateTreeCharacterGroundedCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	// is the character currently grounded?
@@ -32,6 +35,9 @@ FText FStateTreeCharacterGroundedCondition::GetDescription(const FGuid& ID, FSta
 
 EStateTreeRunStatus FStateTreeComboAttackTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+	PANTHERJAM_INC_COUNTER(StateTreeTransitions, 1);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -56,6 +62,8 @@ EStateTreeRunStatus FStateTreeComboAttackTask::EnterState(FStateTreeExecutionCon
 
 void FStateTreeComboAttackTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -78,6 +86,9 @@ FText FStateTreeComboAttackTask::GetDescription(const FGuid& ID, FStateTreeDataV
 
 EStateTreeRunStatus FStateTreeChargedAttackTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+	PANTHERJAM_INC_COUNTER(StateTreeTransitions, 1);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -101,6 +112,8 @@ EStateTreeRunStatus FStateTreeChargedAttackTask::EnterState(FStateTreeExecutionC
 
 void FStateTreeChargedAttackTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -123,6 +136,9 @@ FText FStateTreeChargedAttackTask::GetDescription(const FGuid& ID, FStateTreeDat
 
 EStateTreeRunStatus FStateTreeWaitForLandingTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+	PANTHERJAM_INC_COUNTER(StateTreeTransitions, 1);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -143,6 +159,8 @@ EStateTreeRunStatus FStateTreeWaitForLandingTask::EnterState(FStateTreeExecution
 
 void FStateTreeWaitForLandingTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -165,6 +183,9 @@ FText FStateTreeWaitForLandingTask::GetDescription(const FGuid& ID, FStateTreeDa
 
 EStateTreeRunStatus FStateTreeFaceActorTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+	PANTHERJAM_INC_COUNTER(StateTreeTransitions, 1);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -180,6 +201,8 @@ EStateTreeRunStatus FStateTreeFaceActorTask::EnterState(FStateTreeExecutionConte
 
 void FStateTreeFaceActorTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// have we transitioned to another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -202,6 +225,9 @@ FText FStateTreeFaceActorTask::GetDescription(const FGuid& ID, FStateTreeDataVie
 
 EStateTreeRunStatus FStateTreeFaceLocationTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+	PANTHERJAM_INC_COUNTER(StateTreeTransitions, 1);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -217,6 +243,8 @@ EStateTreeRunStatus FStateTreeFaceLocationTask::EnterState(FStateTreeExecutionCo
 
 void FStateTreeFaceLocationTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// have we transitioned to another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -239,6 +267,9 @@ FText FStateTreeFaceLocationTask::GetDescription(const FGuid& ID, FStateTreeData
 
 EStateTreeRunStatus FStateTreeSetCharacterSpeedTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+	PANTHERJAM_INC_COUNTER(StateTreeTransitions, 1);
+
 	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
@@ -263,21 +294,46 @@ FText FStateTreeSetCharacterSpeedTask::GetDescription(const FGuid& ID, FStateTre
 
 EStateTreeRunStatus FStateTreeGetPlayerInfoTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-	// get the character possessed by the first local player
-	InstanceData.TargetPlayerCharacter = Cast<ACharacter>(UGameplayStatics::GetPlayerPawn(InstanceData.Character, 0));
+	// are we waiting for a reduced rate update?
+	InstanceData.TimeUntilUpdate -= DeltaTime;
+
+	if (InstanceData.TimeUntilUpdate > 0.0f || !IsValid(InstanceData.Character))
+	{
+		return EStateTreeRunStatus::Running;
+	}
+
+	const FVector CharacterLocation = InstanceData.Character->GetActorLocation();
+
+	// get the target player from this frame's player snapshot
+	const FPantherJamPlayerSnapshot* TargetPlayer = nullptr;
+
+	if (UPantherJamPlayerSnapshotSubsystem* PlayerSnapshots = UPantherJamPlayerSnapshotSubsystem::Get(InstanceData.Character))
+	{
+		TargetPlayer = InstanceData.bTargetClosestPlayer ? PlayerSnapshots->FindClosestPlayer(CharacterLocation) : PlayerSnapshots->GetPlayer(InstanceData.PlayerIndex);
+	}
+
+	InstanceData.TargetPlayerCharacter = TargetPlayer ? Cast<ACharacter>(TargetPlayer->GetPawn()) : nullptr;
 
 	// do we have a valid target?
 	if (InstanceData.TargetPlayerCharacter)
 	{
 		// update the last known location
-		InstanceData.TargetPlayerLocation = InstanceData.TargetPlayerCharacter->GetActorLocation();
+		InstanceData.TargetPlayerLocation = TargetPlayer->Location;
 	}
 
 	// update the distance
-	InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+	InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, CharacterLocation);
+
+	// update at a reduced rate while the target is far away
+	if (InstanceData.ReducedUpdateDistance > 0.0f && InstanceData.DistanceToTarget > InstanceData.ReducedUpdateDistance)
+	{
+		InstanceData.TimeUntilUpdate = InstanceData.ReducedUpdateInterval;
+	}
 
 	return EStateTreeRunStatus::Running;
 }
@@ -2,16 +2,29 @@
 
 
 #include "EnvQueryContext_Player.h"
-#include "Kismet/GameplayStatics.h"
+#include "PantherJamPlayerSnapshotSubsystem.h"
 #include "EnvironmentQuery/EnvQueryTypes.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Actor.h"
 #include "GameFramework/Pawn.h"
 
 void UEnvQueryContext_Player::ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const
 {
-	// get the player pawn for the first local player
-	AActor* PlayerPawn = UGameplayStatics::GetPlayerPawn(QueryInstance.Owner.Get(), 0);
-	check(PlayerPawn);
+	// get the player pawn closest to the querier from this frame's player snapshot
+	const FPantherJamPlayerSnapshot* Player = nullptr;
+
+	if (UPantherJamPlayerSnapshotSubsystem* PlayerSnapshots = UPantherJamPlayerSnapshotSubsystem::Get(QueryInstance.Owner.Get()))
+	{
+		const AActor* Querier = Cast<AActor>(QueryInstance.Owner.Get());
+		Player = Querier ? PlayerSnapshots->FindClosestPlayer(Querier->GetActorLocation()) : PlayerSnapshots->GetPlayer(0);
+	}
+
+	// leave the context empty if there's no player, e.g. while they respawn
+	AActor* PlayerPawn = Player ? Player->GetPawn() : nullptr;
+
+	if (!PlayerPawn)
+	{
+		return;
+	}
 
 	// add the actor data to the context
 	UEnvQueryItemType_Actor::SetContextHelper(ContextData, PlayerPawn);
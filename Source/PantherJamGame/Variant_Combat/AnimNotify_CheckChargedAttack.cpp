@@ -3,10 +3,17 @@
 
 #include "AnimNotify_CheckChargedAttack.h"
 #include "CombatAttacker.h"
+#include "CombatMontageSchedulerSubsystem.h"
 #include "Components/SkeletalMeshComponent.h"
 
 void UAnimNotify_CheckChargedAttack::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
 {
+	// the timing table dispatches this notify on time when the mesh skips animation updates
+	if (UCombatMontageSchedulerSubsystem::IsDrivingAttackNotifies(MeshComp))
+	{
+		return;
+	}
+
 	// cast the owner to the attacker interface
 	if (ICombatAttacker* AttackerInterface = Cast<ICombatAttacker>(MeshComp->GetOwner()))
 	{
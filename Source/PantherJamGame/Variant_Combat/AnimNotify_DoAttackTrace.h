@@ -22,6 +22,9 @@ protected:
 
 public:
 
+	/** Returns the source bone for the attack trace */
+	FName GetAttackBoneName() const { return AttackBoneName; }
+
 	/** Perform the Anim Notify */
 	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
 
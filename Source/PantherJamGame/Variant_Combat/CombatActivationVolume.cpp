@@ -5,6 +5,8 @@
 #include "Components/BoxComponent.h"
 #include "GameFramework/Character.h"
 #include "CombatActivatable.h"
+#include "CombatEnemySpawner.h"
+#include "CombatPreloadSubsystem.h"
 
 ACombatActivationVolume::ACombatActivationVolume()
 {
@@ -24,6 +26,25 @@ ACombatActivationVolume::ACombatActivationVolume()
 	Box->OnComponentBeginOverlap.AddDynamic(this, &ACombatActivationVolume::OnOverlap);
 }
 
+void ACombatActivationVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// start loading the activatables' assets when a player gets close
+	UCombatPreloadSubsystem::AddPreloadZone(this, Box->Bounds.GetBox(), PreloadDistance);
+}
+
+void ACombatActivationVolume::PreloadActivatables()
+{
+	for (AActor* CurrentActor : ActorsToActivate)
+	{
+		if (ACombatEnemySpawner* Spawner = Cast<ACombatEnemySpawner>(CurrentActor))
+		{
+			Spawner->PreloadEnemy();
+		}
+	}
+}
+
 void ACombatActivationVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	// has a Character entered the volume?
@@ -10,6 +10,7 @@ class UBoxComponent;
 
 /**
  *  A simple volume that activates a list of actors when the player pawn enters.
+ *  Enemy spawners in the list start loading their enemies when a player comes within the preload distance.
  */
 UCLASS()
 class ACombatActivationVolume : public AActor
@@ -26,13 +27,23 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation Volume")
 	TArray<AActor*> ActorsToActivate;
 
+	/** Distance from the volume at which the actors to activate start loading their assets */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation Volume", meta = (ClampMin = 0, Units = "cm"))
+	float PreloadDistance = 3000.0f;
+
 public:	
 	
 	/** Constructor */
 	ACombatActivationVolume();
 
+	/** Starts loading the assets of the actors to activate */
+	void PreloadActivatables();
+
 protected:
 
+	/** Registers the volume for preloading */
+	virtual void BeginPlay() override;
+
 	/** Handles overlaps with the box volume */
 	UFUNCTION()
 	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
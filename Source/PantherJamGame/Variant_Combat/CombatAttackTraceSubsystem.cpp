@@ -0,0 +1,337 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatAttackTraceSubsystem.h"
+#include "CombatAttacker.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<bool> CVarBatchAttackTraces(
+	TEXT("Combat.BatchAttackTraces"),
+	true,
+	TEXT("If true, melee attack traces are queued and resolved together at the end of the frame. If false, they're resolved immediately."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAttackTraceParallelThreshold(
+	TEXT("Combat.AttackTraceParallelThreshold"),
+	4,
+	TEXT("Minimum number of queued attack traces before they're resolved across task graph workers."),
+	ECVF_Default);
+
+void UCombatAttackTraceSubsystem::RequestAttackTrace(const FCombatAttackTraceRequest& Request)
+{
+	AActor* Attacker = Request.Attacker.Get();
+
+	if (!Attacker)
+	{
+		return;
+	}
+
+	UWorld* World = Attacker->GetWorld();
+
+	// queue the trace if batching is enabled for this world
+	if (CVarBatchAttackTraces.GetValueOnGameThread())
+	{
+		if (UCombatAttackTraceSubsystem* Subsystem = World->GetSubsystem<UCombatAttackTraceSubsystem>())
+		{
+			Subsystem->QueueAttackTrace(Request);
+			return;
+		}
+	}
+
+	PANTHERJAM_INC_COUNTER(Traces, 1);
+
+	// resolve the trace immediately
+	TArray<FHitResult> Hits;
+	SweepAttackTrace(World, Request, Hits);
+	DispatchAttackHits(Request, Hits);
+}
+
+void UCombatAttackTraceSubsystem::SweepAttackTrace(const UWorld* World, const FCombatAttackTraceRequest& Request, TArray<FHitResult>& OutHits)
+{
+	// use a sphere shape for the sweep
+	FCollisionShape CollisionShape;
+	CollisionShape.SetSphere(Request.Radius);
+
+	// ignore the attacker
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CombatAttackTrace));
+	QueryParams.AddIgnoredActor(Request.Attacker.Get());
+
+	World->SweepMultiByObjectType(OutHits, Request.Start, Request.End, FQuat::Identity, Request.ObjectParams, CollisionShape, QueryParams);
+}
+
+void UCombatAttackTraceSubsystem::RegisterTarget(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	if (UCombatAttackTraceSubsystem* Subsystem = Actor->GetWorld()->GetSubsystem<UCombatAttackTraceSubsystem>())
+	{
+		Subsystem->Targets.Add(Actor);
+	}
+}
+
+void UCombatAttackTraceSubsystem::UnregisterTarget(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	if (UCombatAttackTraceSubsystem* Subsystem = Actor->GetWorld()->GetSubsystem<UCombatAttackTraceSubsystem>())
+	{
+		Subsystem->Targets.Remove(Actor);
+	}
+}
+
+void UCombatAttackTraceSubsystem::QueueAttackTrace(const FCombatAttackTraceRequest& Request)
+{
+	PendingRequests.Add(Request);
+
+	// reuse the target arrays from previous frames
+	if (PendingTargets.Num() < PendingRequests.Num())
+	{
+		PendingTargets.SetNum(PendingRequests.Num());
+	}
+
+	TArray<FCombatAttackTraceTarget>& RequestTargets = PendingTargets[PendingRequests.Num() - 1];
+	RequestTargets.Reset();
+
+	SnapshotTargets(Request, RequestTargets);
+}
+
+void UCombatAttackTraceSubsystem::SnapshotTargets(const FCombatAttackTraceRequest& Request, TArray<FCombatAttackTraceTarget>& OutTargets) const
+{
+	// the sweep can only touch bodies inside the bounds of the swept sphere
+	const FBox SweepBounds = FBox(FVector::Min(Request.Start, Request.End), FVector::Max(Request.Start, Request.End)).ExpandBy(Request.Radius);
+	const int32 QueryBits = Request.ObjectParams.GetQueryBitfield();
+	const AActor* Attacker = Request.Attacker.Get();
+
+	auto AddBody = [&OutTargets, QueryBits](UPrimitiveComponent* Component, int32 BodyIndex, const FBodyInstance* Body)
+	{
+		// skip bodies the immediate sweep wouldn't see
+		if (!Body || !Body->IsValidBodyInstance() || !CollisionEnabledHasQuery(Body->GetCollisionEnabled())
+			|| (QueryBits & ECC_TO_BITFIELD(Body->GetObjectType())) == 0)
+		{
+			return;
+		}
+
+		FCombatAttackTraceTarget& Target = OutTargets.AddDefaulted_GetRef();
+		Target.Component = Component;
+		Target.BodyIndex = BodyIndex;
+		Target.Transform = Body->GetUnrealWorldTransform();
+	};
+
+	for (const TWeakObjectPtr<AActor>& WeakTarget : Targets)
+	{
+		const AActor* Target = WeakTarget.Get();
+
+		if (!Target || Target == Attacker)
+		{
+			continue;
+		}
+
+		Target->ForEachComponent<UPrimitiveComponent>(false, [&](UPrimitiveComponent* Component)
+		{
+			if (!Component->IsQueryCollisionEnabled() || !Component->Bounds.GetBox().Intersect(SweepBounds))
+			{
+				return;
+			}
+
+			// skeletal meshes collide with one body per bone
+			if (const USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Component))
+			{
+				for (int32 BodyIndex = 0; BodyIndex < SkeletalMesh->Bodies.Num(); ++BodyIndex)
+				{
+					AddBody(Component, BodyIndex, SkeletalMesh->Bodies[BodyIndex]);
+				}
+
+			} else {
+
+				AddBody(Component, INDEX_NONE, Component->GetBodyInstance());
+			}
+		});
+	}
+}
+
+const FBodyInstance* UCombatAttackTraceSubsystem::GetTargetBody(const FCombatAttackTraceTarget& Target)
+{
+	UPrimitiveComponent* Component = Target.Component.Get();
+
+	if (!Component)
+	{
+		return nullptr;
+	}
+
+	if (Target.BodyIndex == INDEX_NONE)
+	{
+		return Component->GetBodyInstance();
+	}
+
+	// the physics asset may have been swapped since the request
+	const USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Component);
+
+	return SkeletalMesh && SkeletalMesh->Bodies.IsValidIndex(Target.BodyIndex) ? SkeletalMesh->Bodies[Target.BodyIndex] : nullptr;
+}
+
+void UCombatAttackTraceSubsystem::SweepTargets(const FCombatAttackTraceRequest& Request, const TArray<FCombatAttackTraceTarget>& InTargets, TArray<FHitResult>& InOutHits)
+{
+	FCollisionShape CollisionShape;
+	CollisionShape.SetSphere(Request.Radius);
+
+	const int32 NumSceneHits = InOutHits.Num();
+
+	for (const FCombatAttackTraceTarget& Target : InTargets)
+	{
+		const FBodyInstance* Body = GetTargetBody(Target);
+
+		if (!Body || !Body->IsValidBodyInstance())
+		{
+			continue;
+		}
+
+		// move the sweep along with the body instead of moving the body back
+		const FTransform Current = Body->GetUnrealWorldTransform();
+
+		auto ToCurrent = [&Target, &Current](const FVector& Location) { return Current.TransformPosition(Target.Transform.InverseTransformPosition(Location)); };
+		auto ToRequest = [&Target, &Current](const FVector& Location) { return Target.Transform.TransformPosition(Current.InverseTransformPosition(Location)); };
+
+		FHitResult Hit;
+
+		if (!Body->Sweep(Hit, ToCurrent(Request.Start), ToCurrent(Request.End), FQuat::Identity, CollisionShape))
+		{
+			continue;
+		}
+
+		// put the hit back where the body was when the trace was requested
+		const FQuat Rotation = Target.Transform.GetRotation() * Current.GetRotation().Inverse();
+
+		Hit.Location = ToRequest(Hit.Location);
+		Hit.ImpactPoint = ToRequest(Hit.ImpactPoint);
+		Hit.Normal = Rotation.RotateVector(Hit.Normal);
+		Hit.ImpactNormal = Rotation.RotateVector(Hit.ImpactNormal);
+		Hit.TraceStart = Request.Start;
+		Hit.TraceEnd = Request.End;
+
+		InOutHits.Add(Hit);
+	}
+
+	// keep the hits in sweep order, like the scene query
+	if (InOutHits.Num() > NumSceneHits)
+	{
+		InOutHits.StableSort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+	}
+}
+
+void UCombatAttackTraceSubsystem::ResolveAttackTraces()
+{
+	const int32 NumRequests = PendingRequests.Num();
+
+	// grow the hit arrays without throwing away previous allocations
+	if (PendingHits.Num() < NumRequests)
+	{
+		PendingHits.SetNum(NumRequests);
+	}
+
+	// run the sweeps. Scene queries are read only, so they can run in parallel
+	const UWorld* World = GetWorld();
+	const bool bSingleThreaded = NumRequests < CVarAttackTraceParallelThreshold.GetValueOnGameThread();
+
+	ParallelFor(NumRequests, [this, World](int32 Index)
+	{
+		PendingHits[Index].Reset();
+		SweepAttackTrace(World, PendingRequests[Index], PendingHits[Index]);
+
+	}, bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// registered targets may have moved since the request, so swap their scene hits for hits against the recorded bodies
+	for (int32 Index = 0; Index < NumRequests; ++Index)
+	{
+		TArray<FHitResult>& Hits = PendingHits[Index];
+
+		if (!Targets.IsEmpty())
+		{
+			Hits.RemoveAll([this](const FHitResult& Hit) { return Targets.Contains(Hit.GetActor()); });
+		}
+
+		SweepTargets(PendingRequests[Index], PendingTargets[Index], Hits);
+	}
+}
+
+void UCombatAttackTraceSubsystem::FlushAttackTraces()
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(AttackTraceFlush);
+
+	const int32 NumRequests = PendingRequests.Num();
+
+	if (NumRequests == 0)
+	{
+		return;
+	}
+
+	PANTHERJAM_INC_COUNTER(Traces, NumRequests);
+
+	ResolveAttackTraces();
+
+	// swap the batch out so any traces requested while dispatching go into the next batch
+	TArray<FCombatAttackTraceRequest> Requests = MoveTemp(PendingRequests);
+	TArray<TArray<FHitResult>> Hits = MoveTemp(PendingHits);
+
+	// dispatch the hits in request order so damage is applied deterministically
+	for (int32 Index = 0; Index < NumRequests; ++Index)
+	{
+		DispatchAttackHits(Requests[Index], Hits[Index]);
+	}
+
+	// hold on to the allocations for the next frame, unless a new batch was started while dispatching
+	if (PendingRequests.IsEmpty())
+	{
+		Requests.Reset();
+		PendingRequests = MoveTemp(Requests);
+	}
+
+	PendingHits = MoveTemp(Hits);
+}
+
+void UCombatAttackTraceSubsystem::DispatchAttackHits(const FCombatAttackTraceRequest& Request, const TArray<FHitResult>& Hits)
+{
+	// the attacker may have been destroyed since the trace was requested
+	if (ICombatAttacker* Attacker = Cast<ICombatAttacker>(Request.Attacker.Get()))
+	{
+		Attacker->ProcessAttackHits(Hits);
+	}
+}
+
+void UCombatAttackTraceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushAttackTraces();
+}
+
+TStatId UCombatAttackTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatAttackTraceSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatAttackTraceSubsystem::Deinitialize()
+{
+	PendingRequests.Empty();
+	PendingHits.Empty();
+	PendingTargets.Empty();
+	Targets.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatAttackTraceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/HitResult.h"
+#include "CollisionQueryParams.h"
+#include "CombatAttackTraceSubsystem.generated.h"
+
+class UPrimitiveComponent;
+struct FBodyInstance;
+
+/**
+ *  A single melee attack sweep requested by an attacker
+ */
+struct FCombatAttackTraceRequest
+{
+	/** Actor performing the attack. Receives the hits and is ignored by the sweep */
+	TWeakObjectPtr<AActor> Attacker;
+
+	/** Sweep start location */
+	FVector Start = FVector::ZeroVector;
+
+	/** Sweep end location */
+	FVector End = FVector::ZeroVector;
+
+	/** Radius of the swept sphere */
+	float Radius = 0.0f;
+
+	/** Object types the sweep can hit */
+	FCollisionObjectQueryParams ObjectParams;
+};
+
+/**
+ *  A target body a queued attack trace could hit, with its transform when the trace was requested
+ */
+struct FCombatAttackTraceTarget
+{
+	/** Component the body belongs to */
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/** Index of the body in a skeletal mesh, or INDEX_NONE for the component's own body */
+	int32 BodyIndex = INDEX_NONE;
+
+	/** World transform of the body when the trace was requested */
+	FTransform Transform;
+};
+
+/**
+ *  Resolves melee attack sweeps for ICombatAttacker actors.
+ *  Attack traces requested during the frame are queued and resolved together at the end of the frame,
+ *  running the sweeps in parallel across task graph workers. Hits are then handed back to each attacker
+ *  on the game thread, in the order the traces were requested.
+ *  Batching can be toggled with Combat.BatchAttackTraces to fall back to immediate sweeps.
+ *
+ *  Registered targets may move between the request and the end of the frame, so their bodies near each sweep
+ *  are recorded when the trace is queued. The batched sweep then hits them where they were at request time,
+ *  which gives the same hits as the immediate sweep. Anything that isn't registered is swept where it is at the end of the frame.
+ */
+UCLASS()
+class UCombatAttackTraceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Traces queued for this frame */
+	TArray<FCombatAttackTraceRequest> PendingRequests;
+
+	/** Hit results for each queued trace. Kept around to reuse the allocations */
+	TArray<TArray<FHitResult>> PendingHits;
+
+	/** Target bodies near each queued trace, as they were when the trace was requested */
+	TArray<TArray<FCombatAttackTraceTarget>> PendingTargets;
+
+	/** Actors that can move while their attack traces are queued */
+	TSet<TWeakObjectPtr<AActor>> Targets;
+
+public:
+
+	/** Requests an attack trace. Hits are passed to the attacker's ProcessAttackHits, either immediately or at the end of the frame */
+	static void RequestAttackTrace(const FCombatAttackTraceRequest& Request);
+
+	/** Runs the sweep for a single attack trace */
+	static void SweepAttackTrace(const UWorld* World, const FCombatAttackTraceRequest& Request, TArray<FHitResult>& OutHits);
+
+	/** Registers an actor that can be hit by attack traces and can move before they're resolved */
+	static void RegisterTarget(AActor* Actor);
+
+	/** Unregisters a target actor */
+	static void UnregisterTarget(AActor* Actor);
+
+	/** Queues an attack trace to be resolved at the end of the frame */
+	void QueueAttackTrace(const FCombatAttackTraceRequest& Request);
+
+	/** Runs the sweeps for all queued attack traces, without dispatching them */
+	void ResolveAttackTraces();
+
+	/** Returns the hits of a queued trace, valid between ResolveAttackTraces and the end of the flush */
+	const TArray<FHitResult>& GetResolvedHits(int32 Index) const { return PendingHits[Index]; }
+
+	/** Resolves all queued attack traces and dispatches their hits */
+	void FlushAttackTraces();
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Records the registered target bodies the trace could hit */
+	void SnapshotTargets(const FCombatAttackTraceRequest& Request, TArray<FCombatAttackTraceTarget>& OutTargets) const;
+
+	/** Sweeps the recorded target bodies as they were when the trace was requested, and adds their hits */
+	static void SweepTargets(const FCombatAttackTraceRequest& Request, const TArray<FCombatAttackTraceTarget>& InTargets, TArray<FHitResult>& InOutHits);
+
+	/** Returns the body a recorded target refers to, if it still exists */
+	static const FBodyInstance* GetTargetBody(const FCombatAttackTraceTarget& Target);
+
+	/** Passes the hits for a resolved trace back to its attacker */
+	static void DispatchAttackHits(const FCombatAttackTraceRequest& Request, const TArray<FHitResult>& Hits);
+};
@@ -6,6 +6,8 @@
 #include "UObject/Interface.h"
 #include "CombatAttacker.generated.h"
 
+struct FHitResult;
+
 /**
  *  CombatAttacker Interface
  *  Provides common functionality to trigger attack animation events.
@@ -26,6 +28,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void DoAttackTrace(FName DamageSourceBone) = 0;
 
+	/** Handles the hits from an attack's collision check. Called by UCombatAttackTraceSubsystem once the trace is resolved */
+	virtual void ProcessAttackHits(const TArray<FHitResult>& Hits) = 0;
+
 	/** Performs a combo attack's check to continue the string. Usually called from a montage's AnimNotify */
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void CheckCombo() = 0;
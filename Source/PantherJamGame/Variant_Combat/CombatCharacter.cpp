@@ -10,14 +10,31 @@
 #include "Camera/CameraComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "EnhancedInputComponent.h"
-#include "CombatLifeBar.h"
+#include "CombatLifeBarSubsystem.h"
 #include "Engine/DamageEvents.h"
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
 #include "CombatPlayerController.h"
+#include "CombatAttackTraceSubsystem.h"
+#include "CombatDamageQueueSubsystem.h"
+#include "CombatMontageSchedulerSubsystem.h"
+#include "CombatRagdollBudgetSubsystem.h"
+#include "CombatPreloadSubsystem.h"
+#include "CombatCheckpointSubsystem.h"
+#include "PantherJamInputRecordingSubsystem.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
+#include "UObject/ObjectSaveContext.h"
+#include "HAL/IConsoleManager.h"
 
 DEFINE_LOG_CATEGORY(LogCombatCharacter);
 
+static TAutoConsoleVariable<bool> CVarInPlaceRespawn(
+	TEXT("Combat.InPlaceRespawn"),
+	true,
+	TEXT("If true (default), the player character is reset at the checkpoint when it respawns. Set to 0 to switch back to destroying it and having the Player Controller spawn a new one."),
+	ECVF_Default);
+
 ACombatCharacter::ACombatCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -49,6 +66,9 @@ ACombatCharacter::ACombatCharacter()
 	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// default to the shipped life bar widget
+	LifeBarWidgetClass = TSoftClassPtr<UCombatLifeBar>(FSoftObjectPath(TEXT("/Game/Variant_Combat/UI/UI_LifeBar.UI_LifeBar_C")));
+
 	// set the player tag
 	Tags.Add(FName("Player"));
 }
@@ -90,6 +110,8 @@ void ACombatCharacter::ChargedAttackReleased()
 
 void ACombatCharacter::DoMove(float Right, float Forward)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Move, FVector2f(Right, Forward));
+
 	if (GetController() != nullptr)
 	{
 		// find out which way is forward
@@ -110,6 +132,8 @@ void ACombatCharacter::DoMove(float Right, float Forward)
 
 void ACombatCharacter::DoLook(float Yaw, float Pitch)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Look, FVector2f(Yaw, Pitch));
+
 	if (GetController() != nullptr)
 	{
 		// add yaw and pitch input to controller
@@ -120,6 +144,8 @@ void ACombatCharacter::DoLook(float Yaw, float Pitch)
 
 void ACombatCharacter::DoComboAttackStart()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::ComboAttackStart);
+
 	// are we already playing an attack animation?
 	if (bIsAttacking)
 	{
@@ -135,11 +161,15 @@ void ACombatCharacter::DoComboAttackStart()
 
 void ACombatCharacter::DoComboAttackEnd()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::ComboAttackEnd);
+
 	// stub
 }
 
 void ACombatCharacter::DoChargedAttackStart()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::ChargedAttackStart);
+
 	// raise the charging attack flag
 	bIsChargingAttack = true;
 
@@ -156,6 +186,8 @@ void ACombatCharacter::DoChargedAttackStart()
 
 void ACombatCharacter::DoChargedAttackEnd()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::ChargedAttackEnd);
+
 	// lower the charging attack flag
 	bIsChargingAttack = false;
 
@@ -166,13 +198,46 @@ void ACombatCharacter::DoChargedAttackEnd()
 	}
 }
 
+void ACombatCharacter::ReplayInput(EPantherJamInputAction Action, const FVector2f& Value)
+{
+	switch (Action)
+	{
+	case EPantherJamInputAction::Move:
+		DoMove(Value.X, Value.Y);
+		break;
+
+	case EPantherJamInputAction::Look:
+		DoLook(Value.X, Value.Y);
+		break;
+
+	case EPantherJamInputAction::ComboAttackStart:
+		DoComboAttackStart();
+		break;
+
+	case EPantherJamInputAction::ComboAttackEnd:
+		DoComboAttackEnd();
+		break;
+
+	case EPantherJamInputAction::ChargedAttackStart:
+		DoChargedAttackStart();
+		break;
+
+	case EPantherJamInputAction::ChargedAttackEnd:
+		DoChargedAttackEnd();
+		break;
+
+	default:
+		break;
+	}
+}
+
 void ACombatCharacter::ResetHP()
 {
 	// reset the current HP total
 	CurrentHP = MaxHP;
 
 	// update the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	UCombatLifeBarSubsystem::SetLifePercentage(this, 1.0f);
 }
 
 void ACombatCharacter::ComboAttack()
@@ -184,17 +249,7 @@ void ACombatCharacter::ComboAttack()
 	ComboCount = 0;
 
 	// play the attack montage
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-	{
-		const float MontageLength = AnimInstance->Montage_Play(ComboAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
-
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
-		{
-			// set the end delegate for the montage
-			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ComboAttackMontage);
-		}
-	}
+	UCombatMontageSchedulerSubsystem::PlayMontage(GetMesh(), UCombatPreloadSubsystem::GetOrLoad(this, ComboAttackMontage), ComboAttackTiming, OnAttackMontageEnded);
 
 }
 
@@ -207,17 +262,7 @@ void ACombatCharacter::ChargedAttack()
 	bHasLoopedChargedAttack = false;
 
 	// play the charged attack montage
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-	{
-		const float MontageLength = AnimInstance->Montage_Play(ChargedAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
-
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
-		{
-			// set the end delegate for the montage
-			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ChargedAttackMontage);
-		}
-	}
+	UCombatMontageSchedulerSubsystem::PlayMontage(GetMesh(), UCombatPreloadSubsystem::GetOrLoad(this, ChargedAttackMontage), ChargedAttackTiming, OnAttackMontageEnded);
 }
 
 void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
@@ -244,43 +289,49 @@ void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupt
 
 void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(AttackTrace);
+
 	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
+	FCombatAttackTraceRequest Request;
+	Request.Attacker = this;
 
 	// start at the provided socket location, sweep forward
-	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
-	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
-
-	// check for pawn and world dynamic collision object types
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	Request.Start = UCombatMontageSchedulerSubsystem::GetAttackSourceLocation(GetMesh(), DamageSourceBone);
+	Request.End = Request.Start + (GetActorForwardVector() * MeleeTraceDistance);
 
 	// use a sphere shape for the sweep
-	FCollisionShape CollisionShape;
-	CollisionShape.SetSphere(MeleeTraceRadius);
+	Request.Radius = MeleeTraceRadius;
 
-	// ignore self
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
+	// check for pawn and world dynamic collision object types
+	Request.ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	Request.ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+
+	// the hits will be passed back to ProcessAttackHits
+	UCombatAttackTraceSubsystem::RequestAttackTrace(Request);
+}
 
-	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
+void ACombatCharacter::ProcessAttackHits(const TArray<FHitResult>& Hits)
+{
+	// iterate over each object hit
+	for (const FHitResult& CurrentHit : Hits)
 	{
-		// iterate over each object hit
-		for (const FHitResult& CurrentHit : OutHits)
+		// check if we've hit a damageable actor
+		if (Cast<ICombatDamageable>(CurrentHit.GetActor()))
 		{
-			// check if we've hit a damageable actor
-			ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
-
-			if (Damageable)
+			// knock upwards and away from the impact normal
+			FCombatDamageEvent DamageEvent;
+			DamageEvent.Target = CurrentHit.GetActor();
+			DamageEvent.Causer = this;
+			DamageEvent.Location = CurrentHit.ImpactPoint;
+			DamageEvent.Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+			DamageEvent.Damage = MeleeDamage;
+
+			// queue the damage for the actor
+			UCombatDamageQueueSubsystem::QueueDamage(DamageEvent);
+
+			// call the BP handler to play effects, etc.
+			if (FPantherJamPresentation::IsEnabled(this))
 			{
-				// knock upwards and away from the impact normal
-				const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
-
-				// pass the damage event to the actor
-				Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
-
-				// call the BP handler to play effects, etc.
 				DealtDamage(MeleeDamage, CurrentHit.ImpactPoint);
 			}
 		}
@@ -305,10 +356,7 @@ void ACombatCharacter::CheckCombo()
 			if (ComboCount < ComboSectionNames.Num())
 			{
 				// jump to the next combo section
-				if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-				{
-					AnimInstance->Montage_JumpToSection(ComboSectionNames[ComboCount], ComboAttackMontage);
-				}
+				UCombatMontageSchedulerSubsystem::JumpToSection(GetMesh(), ComboSectionNames[ComboCount], ComboAttackMontage.Get());
 			}
 		}
 	}
@@ -320,14 +368,14 @@ void ACombatCharacter::CheckChargedAttack()
 	bHasLoopedChargedAttack = true;
 
 	// jump to either the loop or the attack section depending on whether we're still holding the charge button
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-	{
-		AnimInstance->Montage_JumpToSection(bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection, ChargedAttackMontage);
-	}
+	UCombatMontageSchedulerSubsystem::JumpToSection(GetMesh(), bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection, ChargedAttackMontage.Get());
 }
 
 void ACombatCharacter::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
+	// count the damage event
+	PANTHERJAM_INC_COUNTER(DamageEvents, 1);
+
 	// pass the damage event to the actor
 	FDamageEvent DamageEvent;
 	const float ActualDamage = TakeDamage(Damage, DamageEvent, nullptr, DamageCauser);
@@ -346,7 +394,10 @@ void ACombatCharacter::ApplyDamage(float Damage, AActor* DamageCauser, const FVe
 		}
 
 		// pass control to BP to play effects, etc.
-		ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
+		if (FPantherJamPresentation::IsEnabled(this))
+		{
+			ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
+		}
 	}
 
 }
@@ -356,11 +407,11 @@ void ACombatCharacter::HandleDeath()
 	// disable movement while we're dead
 	GetCharacterMovement()->DisableMovement();
 
-	// enable full ragdoll physics
-	GetMesh()->SetSimulatePhysics(true);
+	// enable full ragdoll physics, within the ragdoll budget
+	UCombatRagdollBudgetSubsystem::StartRagdoll(GetMesh());
 
 	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	UCombatLifeBarSubsystem::SetLifeBarHidden(this, true);
 
 	// pull back the camera
 	GetCameraBoom()->TargetArmLength = DeathCameraDistance;
@@ -376,10 +427,75 @@ void ACombatCharacter::ApplyHealing(float Healing, AActor* Healer)
 
 void ACombatCharacter::RespawnCharacter()
 {
+	// reuse this character if the Player Controller can take it back, so we skip rebuilding its components and widgets
+	ACombatPlayerController* PC = Cast<ACombatPlayerController>(GetController());
+
+	if (PC && CVarInPlaceRespawn.GetValueOnGameThread())
+	{
+		PANTHERJAM_SCOPE_CYCLE_COUNTER(RespawnInPlace);
+
+		// roll the whole level back to the checkpoint if requested. This brings us back to life too
+		if (UCombatCheckpointSubsystem::ShouldRestoreOnRespawn() && UCombatCheckpointSubsystem::RestoreCheckpoint(this))
+		{
+			return;
+		}
+
+		RespawnInPlace(PC->GetRespawnTransform());
+		return;
+	}
+
+	// the Player Controller spawns and possesses the new character from the OnDestroyed broadcast, so it's timed here too
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(RespawnSpawn);
+
 	// destroy the character and let it be respawned by the Player Controller
 	Destroy();
 }
 
+void ACombatCharacter::RespawnInPlace(const FTransform& RespawnTransform)
+{
+	// we may be restored to a checkpoint while still waiting to respawn
+	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// stop any attack that was interrupted by death
+	UCombatMontageSchedulerSubsystem::StopMontage(GetMesh(), 0.0f);
+
+	bIsAttacking = false;
+	bIsChargingAttack = false;
+	bHasLoopedChargedAttack = false;
+	ComboCount = 0;
+	CachedAttackInputTime = 0.0f;
+
+	// undo the ragdoll and put the mesh back on the capsule
+	UCombatRagdollBudgetSubsystem::StopRagdoll(GetMesh());
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeTransform(MeshStartingTransform);
+
+	// move to the checkpoint
+	SetActorTransform(RespawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// reset HP to maximum and show the life bar again
+	ResetHP();
+
+	UCombatLifeBarSubsystem::SetLifeBarHidden(this, false);
+
+	// bring the camera back in
+	GetCameraBoom()->TargetArmLength = DefaultCameraDistance;
+
+	if (APlayerController* PC = Cast<APlayerController>(GetController()))
+	{
+		// face the checkpoint direction like a freshly possessed character would
+		PC->SetControlRotation(RespawnTransform.Rotator());
+
+		// drop any input held down while we were dead
+		PC->FlushPressedKeys();
+		PC->ResetIgnoreInputFlags();
+	}
+}
+
 float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// only process damage if the character is still alive
@@ -400,11 +516,10 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		UCombatLifeBarSubsystem::SetLifePercentage(this, CurrentHP / MaxHP);
 
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		// enable partial ragdoll physics if the ragdoll budget allows, or play the additive hit reaction
+		UCombatRagdollBudgetSubsystem::StartHitReaction(GetMesh(), PelvisBoneName, HitReactionMontage.Get());
 	}
 
 	// return the received damage amount
@@ -419,17 +534,19 @@ void ACombatCharacter::Landed(const FHitResult& Hit)
 	if (CurrentHP >= 0.0f)
 	{
 		// disable ragdoll physics
-		GetMesh()->SetPhysicsBlendWeight(0.0f);
+		UCombatRagdollBudgetSubsystem::EndHitReaction(GetMesh());
 	}
 }
 
 void ACombatCharacter::BeginPlay()
 {
-	Super::BeginPlay();
+	// batched life bars are drawn by a shared layer, so keep the component from building its own widget
+	if (UCombatLifeBarSubsystem::IsBatched())
+	{
+		LifeBar->SetWidgetClass(nullptr);
+	}
 
-	// get the life bar from the widget component
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
+	Super::BeginPlay();
 
 	// initialize the camera
 	GetCameraBoom()->TargetArmLength = DefaultCameraDistance;
@@ -437,8 +554,30 @@ void ACombatCharacter::BeginPlay()
 	// save the relative transform for the mesh so we can reset the ragdoll later
 	MeshStartingTransform = GetMesh()->GetRelativeTransform();
 
-	// set the life bar color
-	LifeBarWidget->SetBarColor(LifeBarColor);
+	// start loading the attack montages before the first attack
+	TArray<FSoftObjectPath> PreloadAssets;
+	GetPreloadAssets(PreloadAssets);
+
+	UCombatPreloadSubsystem::RequestPreload(this, PreloadAssets);
+
+	// let batched attack traces hit us where we were when they were requested
+	UCombatAttackTraceSubsystem::RegisterTarget(this);
+
+	if (FPantherJamPresentation::IsEnabled(this))
+	{
+		// add our life bar to the shared life bar layer
+		UCombatLifeBarSubsystem::RegisterLifeBar(this, LifeBar, LifeBarColor, LifeBarWidgetClass);
+	}
+	else
+	{
+		// nobody is watching on a dedicated server, so switch off the life bar and camera
+		FPantherJamPresentation::DisableComponent(LifeBar);
+		FPantherJamPresentation::DisableComponent(GetCameraBoom());
+		FPantherJamPresentation::DisableComponent(GetFollowCamera());
+
+		// skip animation entirely. Attacks play from their timing tables instead
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
 
 	// reset HP to maximum
 	ResetHP();
@@ -450,6 +589,11 @@ void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	UCombatAttackTraceSubsystem::UnregisterTarget(this);
+
+	// remove our life bar
+	UCombatLifeBarSubsystem::UnregisterLifeBar(this);
 }
 
 void ACombatCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -486,3 +630,26 @@ void ACombatCharacter::NotifyControllerChanged()
 	}
 }
 
+void ACombatCharacter::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	OutAssets.Add(ComboAttackMontage.ToSoftObjectPath());
+	OutAssets.Add(ChargedAttackMontage.ToSoftObjectPath());
+	OutAssets.Add(HitReactionMontage.ToSoftObjectPath());
+
+	// the life bar widget is only used when life bars aren't batched
+	if (!UCombatLifeBarSubsystem::IsBatched())
+	{
+		OutAssets.Add(LifeBarWidgetClass.ToSoftObjectPath());
+	}
+}
+
+#if WITH_EDITOR
+void ACombatCharacter::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	// bake the attack montages so they can be played without animating the mesh
+	ComboAttackTiming.Build(ComboAttackMontage.LoadSynchronous());
+	ChargedAttackTiming.Build(ChargedAttackMontage.LoadSynchronous());
+}
+#endif
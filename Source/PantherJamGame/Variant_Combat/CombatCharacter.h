@@ -6,6 +6,8 @@
 #include "GameFramework/Character.h"
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
+#include "CombatMontageTiming.h"
+#include "PantherJamInputReplayable.h"
 #include "Animation/AnimInstance.h"
 #include "CombatCharacter.generated.h"
 
@@ -27,7 +29,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
  *  - Respawning
  */
 UCLASS(abstract)
-class ACombatCharacter : public ACharacter, public ICombatAttacker, public ICombatDamageable
+class ACombatCharacter : public ACharacter, public ICombatAttacker, public ICombatDamageable, public IPantherJamInputReplayable
 {
 	GENERATED_BODY()
 
@@ -39,7 +41,7 @@ class ACombatCharacter : public ACharacter, public ICombatAttacker, public IComb
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FollowCamera;
 
-	/** Life bar widget component */
+	/** Life bar widget component. Only draws when life bars aren't batched, otherwise it just places the bar */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = UI, meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* LifeBar;
 	
@@ -85,9 +87,13 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
+	/** Additive hit reaction played instead of the partial ragdoll when the ragdoll budget is full. Skipped if it hasn't loaded yet */
 	UPROPERTY(EditAnywhere, Category="Damage")
-	TObjectPtr<UCombatLifeBar> LifeBarWidget;
+	TSoftObjectPtr<UAnimMontage> HitReactionMontage;
+
+	/** Life bar widget class. If set, it replaces the life bar component's widget class once loaded, when life bars aren't batched */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	TSoftClassPtr<UCombatLifeBar> LifeBarWidgetClass;
 
 	/** Max amount of time that may elapse for a non-combo attack input to not be considered stale */
 	UPROPERTY(EditAnywhere, Category="Melee Attack", meta = (ClampMin = 0, ClampMax = 5))
@@ -119,9 +125,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
 	float MeleeLaunchImpulse = 300.0f;
 
-	/** AnimMontage that will play for combo attacks */
+	/** AnimMontage that will play for combo attacks. Loaded on demand */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
-	UAnimMontage* ComboAttackMontage;
+	TSoftObjectPtr<UAnimMontage> ComboAttackMontage;
 
 	/** Names of the AnimMontage sections that correspond to each stage of the combo attack */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
@@ -131,12 +137,16 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo", meta = (ClampMin = 0, ClampMax = 5))
 	float ComboInputCacheTimeTolerance = 0.45f;
 
+	/** Sections and notifies of the combo attack montage, used when the mesh isn't animating */
+	UPROPERTY(VisibleAnywhere, Category="Melee Attack|Combo")
+	FCombatMontageTimingTable ComboAttackTiming;
+
 	/** Index of the current stage of the melee attack combo */
 	int32 ComboCount = 0;
 
-	/** AnimMontage that will play for charged attacks */
+	/** AnimMontage that will play for charged attacks. Loaded on demand */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
-	UAnimMontage* ChargedAttackMontage;
+	TSoftObjectPtr<UAnimMontage> ChargedAttackMontage;
 
 	/** Name of the AnimMontage section that corresponds to the charge loop */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
@@ -146,6 +156,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
 	FName ChargeAttackSection;
 
+	/** Sections and notifies of the charged attack montage, used when the mesh isn't animating */
+	UPROPERTY(VisibleAnywhere, Category="Melee Attack|Charged")
+	FCombatMontageTimingTable ChargedAttackTiming;
+
 	/** Flag that determines if the player is currently holding the charged attack input */
 	bool bIsChargingAttack = false;
 	
@@ -243,6 +257,9 @@ public:
 	/** Performs the collision check for an attack */
 	virtual void DoAttackTrace(FName DamageSourceBone) override;
 
+	/** Handles the hits from an attack's collision check */
+	virtual void ProcessAttackHits(const TArray<FHitResult>& Hits) override;
+
 	/** Performs the combo string check */
 	virtual void CheckCombo() override;
 
@@ -264,9 +281,19 @@ public:
 
 	// ~end CombatDamageable interface
 
-	/** Called from the respawn timer to destroy and re-create the character */
+	// ~begin IPantherJamInputReplayable interface
+
+	/** Performs a recorded input through the Do* entry points */
+	virtual void ReplayInput(EPantherJamInputAction Action, const FVector2f& Value) override;
+
+	// ~end IPantherJamInputReplayable interface
+
+	/** Called from the respawn timer to reset the character at the checkpoint, or to destroy and re-create it */
 	void RespawnCharacter();
 
+	/** Brings the character back to life at the given transform without destroying it */
+	void RespawnInPlace(const FTransform& RespawnTransform);
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
@@ -299,8 +326,16 @@ protected:
 	/** Handles possessed initialization */
 	virtual void NotifyControllerChanged() override;
 
+#if WITH_EDITOR
+	/** Rebuilds the attack montage timing tables whenever the character is saved or cooked */
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+
 public:
 
+	/** Appends the soft referenced assets this character needs, so they can be preloaded */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 
@@ -0,0 +1,307 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatCheckpointSubsystem.h"
+#include "CombatCheckpointable.h"
+#include "CombatCharacter.h"
+#include "CombatPlayerController.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "TimerManager.h"
+#include "PantherJamStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatCheckpoint, Log, All);
+
+/** Marks the start of a checkpoint snapshot */
+static constexpr uint32 CheckpointMagic = 0x4B434A50;
+
+static TAutoConsoleVariable<bool> CVarCheckpointWriteToDisk(
+	TEXT("Combat.Checkpoint.WriteToDisk"),
+	true,
+	TEXT("If true, checkpoint snapshots are also written to Saved/Checkpoints in the background, so -CombatQuickResume can restore them."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarCheckpointRestoreOnRespawn(
+	TEXT("Combat.Checkpoint.RestoreOnRespawn"),
+	false,
+	TEXT("If true, the whole combat level is restored to the latest checkpoint when the player respawns, instead of only the player."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld CCmdCheckpointSave(
+	TEXT("Combat.Checkpoint.Save"),
+	TEXT("Snapshots the combat level, with the player's current location as the respawn point."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (APlayerController* PC = World->GetFirstPlayerController())
+		{
+			if (APawn* Pawn = PC->GetPawn())
+			{
+				UCombatCheckpointSubsystem::SaveCheckpoint(World, Pawn->GetActorTransform());
+			}
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld CCmdCheckpointRestore(
+	TEXT("Combat.Checkpoint.Restore"),
+	TEXT("Restores the combat level and the player to the latest checkpoint snapshot."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		UCombatCheckpointSubsystem::RestoreCheckpoint(World);
+	}));
+
+bool UCombatCheckpointSubsystem::ShouldRestoreOnRespawn()
+{
+	return CVarCheckpointRestoreOnRespawn.GetValueOnGameThread();
+}
+
+void UCombatCheckpointSubsystem::RegisterCheckpointable(AActor* Actor)
+{
+	// runtime spawned actors won't be found under the same name after a reload, so their owners save them instead
+	if (!Actor || !Actor->IsNetStartupActor() || !Cast<ICombatCheckpointable>(Actor))
+	{
+		return;
+	}
+
+	if (UCombatCheckpointSubsystem* Subsystem = Actor->GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Subsystem->Checkpointables.Add(Actor->GetFName(), Actor);
+	}
+}
+
+void UCombatCheckpointSubsystem::SaveCheckpoint(const UObject* WorldContextObject, const FTransform& RespawnTransform)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UCombatCheckpointSubsystem* Subsystem = World ? World->GetSubsystem<UCombatCheckpointSubsystem>() : nullptr;
+
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	Subsystem->WriteSnapshot(RespawnTransform);
+
+	// write the snapshot out for quick resume without holding up the game thread
+	if (CVarCheckpointWriteToDisk.GetValueOnGameThread())
+	{
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Snapshot = Subsystem->Snapshot, Path = Subsystem->GetQuickResumePath()]()
+		{
+			FFileHelper::SaveArrayToFile(Snapshot, *Path);
+		});
+	}
+}
+
+bool UCombatCheckpointSubsystem::RestoreCheckpoint(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UCombatCheckpointSubsystem* Subsystem = World ? World->GetSubsystem<UCombatCheckpointSubsystem>() : nullptr;
+
+	if (!Subsystem || !Subsystem->HasCheckpoint())
+	{
+		return false;
+	}
+
+	return Subsystem->ReadSnapshot(Subsystem->Snapshot);
+}
+
+void UCombatCheckpointSubsystem::WriteSnapshot(const FTransform& RespawnTransform)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(CheckpointSave);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	Snapshot.Reset();
+
+	FMemoryWriter Writer(Snapshot);
+
+	// write the header. The record count is patched in once we know it
+	uint32 Magic = CheckpointMagic;
+	int32 Version = CheckpointVersion;
+	FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	FTransform PlayerRespawn = RespawnTransform;
+	int32 NumRecords = 0;
+
+	Writer << Magic << Version << MapName << PlayerRespawn;
+
+	const int64 NumRecordsOffset = Writer.Tell();
+	Writer << NumRecords;
+
+	// write one size prefixed record per actor, so readers can skip the ones they don't know
+	for (const TPair<FName, TWeakObjectPtr<AActor>>& Entry : Checkpointables)
+	{
+		ICombatCheckpointable* Checkpointable = Cast<ICombatCheckpointable>(Entry.Value.Get());
+
+		if (!Checkpointable)
+		{
+			continue;
+		}
+
+		FName Key = Entry.Key;
+		int32 RecordSize = 0;
+
+		Writer << Key;
+
+		const int64 RecordSizeOffset = Writer.Tell();
+		Writer << RecordSize;
+
+		const int64 RecordStart = Writer.Tell();
+		Checkpointable->SerializeCheckpoint(Writer);
+
+		const int64 RecordEnd = Writer.Tell();
+		RecordSize = int32(RecordEnd - RecordStart);
+
+		Writer.Seek(RecordSizeOffset);
+		Writer << RecordSize;
+		Writer.Seek(RecordEnd);
+
+		++NumRecords;
+	}
+
+	Writer.Seek(NumRecordsOffset);
+	Writer << NumRecords;
+
+	UE_LOG(LogCombatCheckpoint, Log, TEXT("Checkpoint saved in %.2fms: %d actors, %d bytes"), (FPlatformTime::Seconds() - StartTime) * 1000.0, NumRecords, Snapshot.Num());
+}
+
+bool UCombatCheckpointSubsystem::ReadSnapshot(const TArray<uint8>& InSnapshot)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(CheckpointRestore);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FMemoryReader Reader(InSnapshot);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+
+	Reader << Magic << Version;
+
+	if (Reader.IsError() || Magic != CheckpointMagic || Version != CheckpointVersion)
+	{
+		UE_LOG(LogCombatCheckpoint, Warning, TEXT("Ignoring checkpoint snapshot with unsupported version %d"), Version);
+		return false;
+	}
+
+	FString MapName;
+	Reader << MapName;
+
+	if (MapName != UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName()))
+	{
+		UE_LOG(LogCombatCheckpoint, Warning, TEXT("Ignoring checkpoint snapshot of %s"), *MapName);
+		return false;
+	}
+
+	FTransform RespawnTransform;
+	int32 NumRecords = 0;
+
+	Reader << RespawnTransform << NumRecords;
+
+	for (int32 RecordIndex = 0; RecordIndex < NumRecords; ++RecordIndex)
+	{
+		FName Key;
+		int32 RecordSize = 0;
+
+		Reader << Key << RecordSize;
+
+		const int64 RecordStart = Reader.Tell();
+
+		if (Reader.IsError() || RecordSize < 0 || RecordStart + RecordSize > Reader.TotalSize())
+		{
+			UE_LOG(LogCombatCheckpoint, Warning, TEXT("Checkpoint snapshot is truncated, stopped restoring at %s"), *Key.ToString());
+			return false;
+		}
+
+		// give each actor a reader over its own record, so a bad record can't throw off the rest
+		if (ICombatCheckpointable* Checkpointable = Cast<ICombatCheckpointable>(Checkpointables.FindRef(Key).Get()))
+		{
+			FMemoryReaderView RecordReader(MakeArrayView(InSnapshot.GetData() + RecordStart, RecordSize));
+			Checkpointable->SerializeCheckpoint(RecordReader);
+
+			if (RecordReader.IsError() || RecordReader.Tell() != RecordSize)
+			{
+				UE_LOG(LogCombatCheckpoint, Warning, TEXT("Checkpoint record of %s didn't match its size"), *Key.ToString());
+			}
+		}
+		else
+		{
+			UE_LOG(LogCombatCheckpoint, Verbose, TEXT("Skipping checkpoint record of missing actor %s"), *Key.ToString());
+		}
+
+		Reader.Seek(RecordStart + RecordSize);
+	}
+
+	RestorePlayer(RespawnTransform);
+
+	// keep it as the latest snapshot in case we came from disk
+	if (&InSnapshot != &Snapshot)
+	{
+		Snapshot = InSnapshot;
+	}
+
+	UE_LOG(LogCombatCheckpoint, Log, TEXT("Checkpoint restored in %.2fms: %d actors, %d bytes"), (FPlatformTime::Seconds() - StartTime) * 1000.0, NumRecords, InSnapshot.Num());
+
+	return true;
+}
+
+FString UCombatCheckpointSubsystem::GetQuickResumePath() const
+{
+	const FString MapName = FPaths::GetBaseFilename(UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName()));
+
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Checkpoints"), MapName + TEXT(".ckpt"));
+}
+
+bool UCombatCheckpointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatCheckpointSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// only resume once per run, so traveling back to the map starts it fresh
+	static bool bHasQuickResumed = false;
+
+	if (!bHasQuickResumed && FParse::Param(FCommandLine::Get(), TEXT("CombatQuickResume")))
+	{
+		bHasQuickResumed = true;
+
+		// wait for the level actors to begin play and register
+		InWorld.GetTimerManager().SetTimerForNextTick(this, &UCombatCheckpointSubsystem::QuickResume);
+	}
+}
+
+void UCombatCheckpointSubsystem::QuickResume()
+{
+	TArray<uint8> DiskSnapshot;
+
+	if (FFileHelper::LoadFileToArray(DiskSnapshot, *GetQuickResumePath(), FILEREAD_Silent))
+	{
+		ReadSnapshot(DiskSnapshot);
+	}
+}
+
+void UCombatCheckpointSubsystem::RestorePlayer(const FTransform& RespawnTransform) const
+{
+	ACombatPlayerController* PC = Cast<ACombatPlayerController>(GetWorld()->GetFirstPlayerController());
+
+	if (!PC)
+	{
+		return;
+	}
+
+	// respawns go to the checkpoint from now on
+	PC->SetRespawnTransform(RespawnTransform);
+
+	// bring the player back without rebuilding the character. If it's mid respawn, the new one will appear at the checkpoint
+	if (ACombatCharacter* PlayerCharacter = Cast<ACombatCharacter>(PC->GetPawn()))
+	{
+		PlayerCharacter->RespawnInPlace(RespawnTransform);
+	}
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatCheckpointSubsystem.generated.h"
+
+/**
+ *  Saves the gameplay state of the combat level into a compact binary snapshot when the player reaches a checkpoint,
+ *  and restores the level to it in place, without reloading or streaming the map again.
+ *  Level actors implementing ICombatCheckpointable register themselves on BeginPlay and are keyed by name,
+ *  so snapshots can also be written to disk and restored into a freshly loaded copy of the same map for quick resume.
+ *  Enemies spawned at runtime aren't registered. Their spawner saves and restores them instead.
+ *
+ *  Snapshot layout: magic, version, map name, player respawn transform, then one record per actor
+ *  holding its name, the size of its state and the state itself, so unknown actors can be skipped.
+ *
+ *  Usage:
+ *  Combat.Checkpoint.Save / Combat.Checkpoint.Restore from the console, or -CombatQuickResume on the command line
+ *  to restore the last checkpoint written to Saved/Checkpoints for the map.
+ */
+UCLASS()
+class UCombatCheckpointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Version of the snapshot format. Snapshots from other versions are rejected */
+	static constexpr int32 CheckpointVersion = 1;
+
+protected:
+
+	/** Registered checkpointable actors, keyed by name */
+	TMap<FName, TWeakObjectPtr<AActor>> Checkpointables;
+
+	/** Latest snapshot */
+	TArray<uint8> Snapshot;
+
+public:
+
+	/** Returns true if the level should be restored to the checkpoint when the player respawns */
+	static bool ShouldRestoreOnRespawn();
+
+	/** Registers a level actor implementing ICombatCheckpointable. Actors spawned at runtime are ignored */
+	static void RegisterCheckpointable(AActor* Actor);
+
+	/** Snapshots the level, using the given transform as the player's respawn point */
+	static void SaveCheckpoint(const UObject* WorldContextObject, const FTransform& RespawnTransform);
+
+	/** Restores the level and the player to the latest snapshot. Returns false if there's nothing to restore */
+	static bool RestoreCheckpoint(const UObject* WorldContextObject);
+
+	/** Returns true if a snapshot has been taken or loaded in this world */
+	bool HasCheckpoint() const { return !Snapshot.IsEmpty(); }
+
+	/** Writes the gameplay state of every registered actor into a new snapshot */
+	void WriteSnapshot(const FTransform& RespawnTransform);
+
+	/** Applies a snapshot to the level and the player. Returns false if it's invalid or from another map */
+	bool ReadSnapshot(const TArray<uint8>& InSnapshot);
+
+	/** Returns the file snapshots of this map are written to for quick resume */
+	FString GetQuickResumePath() const;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Schedules the quick resume restore, if requested */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Loads the quick resume snapshot from disk and restores it */
+	void QuickResume();
+
+	/** Moves the player to the snapshot's respawn point */
+	void RestorePlayer(const FTransform& RespawnTransform) const;
+};
@@ -4,6 +4,7 @@
 #include "CombatCheckpointVolume.h"
 #include "CombatCharacter.h"
 #include "CombatPlayerController.h"
+#include "CombatCheckpointSubsystem.h"
 
 ACombatCheckpointVolume::ACombatCheckpointVolume()
 {
@@ -21,6 +22,23 @@ ACombatCheckpointVolume::ACombatCheckpointVolume()
 	Box->OnComponentBeginOverlap.AddDynamic(this, &ACombatCheckpointVolume::OnOverlap);
 }
 
+void ACombatCheckpointVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// save our state with the checkpoints
+	UCombatCheckpointSubsystem::RegisterCheckpointable(this);
+}
+
+void ACombatCheckpointVolume::SerializeCheckpoint(FArchive& Ar)
+{
+	uint8 bUsed = bCheckpointUsed;
+
+	Ar << bUsed;
+
+	bCheckpointUsed = bUsed != 0;
+}
+
 void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	// ensure we use this only once
@@ -41,6 +59,9 @@ void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 
 			// update the player's respawn checkpoint
 			PC->SetRespawnTransform(PlayerCharacter->GetActorTransform());
+
+			// snapshot the level so it can be restored to this point
+			UCombatCheckpointSubsystem::SaveCheckpoint(this, PlayerCharacter->GetActorTransform());
 		}
 
 	}
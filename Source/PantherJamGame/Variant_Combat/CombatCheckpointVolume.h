@@ -5,10 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/BoxComponent.h"
+#include "CombatCheckpointable.h"
 #include "CombatCheckpointVolume.generated.h"
 
+/**
+ *  A volume that sets the player's respawn point and snapshots the combat level when first entered
+ */
 UCLASS(abstract)
-class ACombatCheckpointVolume : public AActor
+class ACombatCheckpointVolume : public AActor, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 	
@@ -26,7 +30,19 @@ protected:
 	/** Set to true after use to avoid accidentally resetting the checkpoint */
 	bool bCheckpointUsed = false;
 
+	/** Registers the volume with the checkpoints */
+	virtual void BeginPlay() override;
+
 	/** Handles overlaps with the box volume */
 	UFUNCTION()
 	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+public:
+
+	// ~begin ICombatCheckpointable interface
+
+	/** Saves or restores whether the checkpoint has been used */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~end ICombatCheckpointable interface
 };
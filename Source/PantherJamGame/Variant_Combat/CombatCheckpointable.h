@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "CombatCheckpointable.generated.h"
+
+/**
+ *  Checkpointable Interface
+ *  Lets level actors save their gameplay state into a checkpoint snapshot and restore it later without reloading the map
+ */
+UINTERFACE(MinimalAPI, NotBlueprintable)
+class UCombatCheckpointable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class ICombatCheckpointable
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 *  Writes the actor's gameplay state to the archive, or reads it back when the archive is loading.
+	 *  When loading, the actor must also apply the state, cancelling any timers or effects that no longer apply.
+	 *  Reads and writes must mirror each other exactly. Bump UCombatCheckpointSubsystem::CheckpointVersion when they change.
+	 */
+	virtual void SerializeCheckpoint(FArchive& Ar) = 0;
+};
@@ -0,0 +1,158 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDamageQueueSubsystem.h"
+#include "CombatDamageable.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<bool> CVarQueueDamageEvents(
+	TEXT("Combat.QueueDamageEvents"),
+	true,
+	TEXT("If true, combat damage is queued and applied once per actor per frame. If false, every hit is applied immediately."),
+	ECVF_Default);
+
+void UCombatDamageQueueSubsystem::QueueDamage(const FCombatDamageEvent& Event)
+{
+	AActor* Target = Event.Target.Get();
+
+	if (!Target)
+	{
+		return;
+	}
+
+	// queue the hit if queueing is enabled for this world
+	if (CVarQueueDamageEvents.GetValueOnGameThread())
+	{
+		if (UCombatDamageQueueSubsystem* Subsystem = Target->GetWorld()->GetSubsystem<UCombatDamageQueueSubsystem>())
+		{
+			Subsystem->AddDamageEvent(Event);
+			return;
+		}
+	}
+
+	// apply the damage immediately
+	DispatchDamage(Event);
+}
+
+void UCombatDamageQueueSubsystem::AddDamageEvent(const FCombatDamageEvent& Event)
+{
+	PendingEvents.Add(Event);
+
+	PANTHERJAM_INC_COUNTER(QueuedHits, 1);
+}
+
+void UCombatDamageQueueSubsystem::FlushDamageEvents()
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(DamageFlush);
+
+	if (PendingEvents.IsEmpty())
+	{
+		return;
+	}
+
+	// swap the queue out so any damage dealt while dispatching, e.g. by death handlers, goes into the next batch
+	TArray<FCombatDamageEvent> Events = MoveTemp(PendingEvents);
+
+	BatchEvents.Reset();
+	BatchLargestHits.Reset();
+	BatchTargets.Reset();
+	BatchCoalescedHits.Reset();
+
+	int32 CoalescedHits = 0;
+
+	// fold the hits into one entry per target, in the order the targets were first hit
+	for (const FCombatDamageEvent& Event : Events)
+	{
+		const TObjectKey<AActor> TargetKey(Event.Target.Get());
+
+		// only count continuous contact damage once per causer
+		if (Event.bCoalesce)
+		{
+			bool bAlreadyCounted = false;
+			BatchCoalescedHits.Add(TPair<TObjectKey<AActor>, TObjectKey<AActor>>(TargetKey, TObjectKey<AActor>(Event.Causer.Get())), &bAlreadyCounted);
+
+			if (bAlreadyCounted)
+			{
+				++CoalescedHits;
+				continue;
+			}
+		}
+
+		if (const int32* BatchIndex = BatchTargets.Find(TargetKey))
+		{
+			FCombatDamageEvent& Combined = BatchEvents[*BatchIndex];
+			Combined.Damage += Event.Damage;
+			Combined.Impulse += Event.Impulse;
+
+			// the largest hit decides where the damage effects play and who gets the credit
+			if (Event.Damage > BatchLargestHits[*BatchIndex])
+			{
+				BatchLargestHits[*BatchIndex] = Event.Damage;
+				Combined.Location = Event.Location;
+				Combined.Causer = Event.Causer;
+			}
+
+			++CoalescedHits;
+		}
+		else
+		{
+			BatchTargets.Add(TargetKey, BatchEvents.Add(Event));
+			BatchLargestHits.Add(Event.Damage);
+		}
+	}
+
+	PANTHERJAM_INC_COUNTER(CoalescedHits, CoalescedHits);
+
+	// apply the combined damage once per target
+	for (const FCombatDamageEvent& Event : BatchEvents)
+	{
+		DispatchDamage(Event);
+	}
+
+	// hold on to the allocation for the next frame, unless a new batch was started while dispatching
+	if (PendingEvents.IsEmpty())
+	{
+		Events.Reset();
+		PendingEvents = MoveTemp(Events);
+	}
+}
+
+void UCombatDamageQueueSubsystem::DispatchDamage(const FCombatDamageEvent& Event)
+{
+	// the target may have been destroyed since the hit was queued
+	if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(Event.Target.Get()))
+	{
+		Damageable->ApplyDamage(Event.Damage, Event.Causer.Get(), Event.Location, Event.Impulse);
+	}
+}
+
+void UCombatDamageQueueSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushDamageEvents();
+}
+
+TStatId UCombatDamageQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDamageQueueSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatDamageQueueSubsystem::Deinitialize()
+{
+	PendingEvents.Empty();
+	BatchEvents.Empty();
+	BatchLargestHits.Empty();
+	BatchTargets.Empty();
+	BatchCoalescedHits.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatDamageQueueSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
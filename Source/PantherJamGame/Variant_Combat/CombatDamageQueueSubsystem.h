@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CombatDamageQueueSubsystem.generated.h"
+
+/**
+ *  A single queued hit on an ICombatDamageable actor
+ */
+struct FCombatDamageEvent
+{
+	/** Actor receiving the damage */
+	TWeakObjectPtr<AActor> Target;
+
+	/** Actor dealing the damage */
+	TWeakObjectPtr<AActor> Causer;
+
+	/** World location of the hit */
+	FVector Location = FVector::ZeroVector;
+
+	/** Knockback impulse */
+	FVector Impulse = FVector::ZeroVector;
+
+	/** Amount of damage */
+	float Damage = 0.0f;
+
+	/** If true, repeated hits from the same causer on the same target this frame only count once */
+	bool bCoalesce = false;
+};
+
+/**
+ *  Batches damage for ICombatDamageable actors.
+ *  Hits are appended to a queue during the frame and processed together once per frame.
+ *  Continuous contact damage, such as a lava floor's hit events, is coalesced to one hit per causer and target.
+ *  All hits on a target are then folded into a single ApplyDamage call, so each actor changes its HP,
+ *  updates its life bar and plays its damage effects at most once per frame.
+ *  Queueing can be toggled with Combat.QueueDamageEvents to fall back to immediate damage.
+ */
+UCLASS()
+class UCombatDamageQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Hits queued for this frame */
+	TArray<FCombatDamageEvent> PendingEvents;
+
+	/** Combined damage for each target in the batch being processed. Kept around to reuse the allocation */
+	TArray<FCombatDamageEvent> BatchEvents;
+
+	/** Largest single hit for each target in the batch, used to pick the damage location and causer */
+	TArray<float> BatchLargestHits;
+
+	/** Maps each target to its entry in the batch */
+	TMap<TObjectKey<AActor>, int32> BatchTargets;
+
+	/** Coalesced hits already counted this batch, by target and causer */
+	TSet<TPair<TObjectKey<AActor>, TObjectKey<AActor>>> BatchCoalescedHits;
+
+public:
+
+	/** Deals damage to an ICombatDamageable actor, either through the queue or immediately */
+	static void QueueDamage(const FCombatDamageEvent& Event);
+
+	/** Appends a hit to this frame's queue */
+	void AddDamageEvent(const FCombatDamageEvent& Event);
+
+	/** Processes all queued hits */
+	void FlushDamageEvents();
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Passes a hit to its target's ApplyDamage */
+	static void DispatchDamage(const FCombatDamageEvent& Event);
+};
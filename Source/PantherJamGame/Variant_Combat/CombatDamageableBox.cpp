@@ -5,6 +5,10 @@
 #include "Components/StaticMeshComponent.h"
 #include "TimerManager.h"
 #include "Engine/World.h"
+#include "CombatCheckpointSubsystem.h"
+#include "CombatAttackTraceSubsystem.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
 
 ACombatDamageableBox::ACombatDamageableBox()
 {
@@ -23,10 +27,26 @@ ACombatDamageableBox::ACombatDamageableBox()
 	Mesh->bNavigationRelevant = false;
 }
 
+void ACombatDamageableBox::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// save the object type so it can be restored
+	InitialObjectType = Mesh->GetCollisionObjectType();
+
+	// the box simulates physics, so it can move before batched attack traces are resolved
+	UCombatAttackTraceSubsystem::RegisterTarget(this);
+
+	// save our state with the checkpoints
+	UCombatCheckpointSubsystem::RegisterCheckpointable(this);
+}
+
 void ACombatDamageableBox::RemoveFromLevel()
 {
-	// destroy this actor
-	Destroy();
+	// hide the box instead of destroying it, so a checkpoint can bring it back
+	Mesh->SetSimulatePhysics(false);
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
 }
 
 void ACombatDamageableBox::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -35,10 +55,15 @@ void ACombatDamageableBox::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	UCombatAttackTraceSubsystem::UnregisterTarget(this);
 }
 
 void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
+	// count the damage event
+	PANTHERJAM_INC_COUNTER(DamageEvents, 1);
+
 	// only process damage if we still have HP
 	if (CurrentHP > 0.0f)
 	{
@@ -55,7 +80,10 @@ void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const
 		Mesh->AddImpulseAtLocation(DamageImpulse * Mesh->GetMass(), DamageLocation);
 
 		// call the BP handler to play effects, etc.
-		OnBoxDamaged(DamageLocation, DamageImpulse);
+		if (FPantherJamPresentation::IsEnabled(this))
+		{
+			OnBoxDamaged(DamageLocation, DamageImpulse);
+		}
 	}
 }
 
@@ -65,7 +93,10 @@ void ACombatDamageableBox::HandleDeath()
 	Mesh->SetCollisionObjectType(ECC_Visibility);
 
 	// call the BP handler to play effects, etc.
-	OnBoxDestroyed();
+	if (FPantherJamPresentation::IsEnabled(this))
+	{
+		OnBoxDestroyed();
+	}
 
 	// set up the death cleanup timer
 	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatDamageableBox::RemoveFromLevel, DeathDelayTime);
@@ -76,3 +107,36 @@ void ACombatDamageableBox::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
+void ACombatDamageableBox::SerializeCheckpoint(FArchive& Ar)
+{
+	FTransform Transform = GetActorTransform();
+
+	Ar << CurrentHP << Transform;
+
+	if (!Ar.IsLoading())
+	{
+		return;
+	}
+
+	// cancel any pending removal
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// were we broken at the checkpoint?
+	if (CurrentHP <= 0.0f)
+	{
+		RemoveFromLevel();
+		return;
+	}
+
+	// bring the box back and put it where it was
+	Mesh->SetCollisionObjectType(InitialObjectType);
+	SetActorEnableCollision(true);
+	SetActorHiddenInGame(false);
+
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+	Mesh->SetSimulatePhysics(true);
+	Mesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	Mesh->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+}
+
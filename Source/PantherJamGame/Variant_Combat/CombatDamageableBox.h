@@ -5,13 +5,15 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "CombatDamageable.h"
+#include "CombatCheckpointable.h"
 #include "CombatDamageableBox.generated.h"
 
 /**
  *  A simple physics box that reacts to damage through the ICombatDamageable interface
+ *  Broken boxes are hidden instead of destroyed, so checkpoints can bring them back
  */
 UCLASS(abstract)
-class ACombatDamageableBox : public AActor, public ICombatDamageable
+class ACombatDamageableBox : public AActor, public ICombatDamageable, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 	
@@ -36,6 +38,9 @@ protected:
 
 	FTimerHandle DeathTimer;
 
+	/** Collision object type before the box was broken */
+	TEnumAsByte<ECollisionChannel> InitialObjectType = ECC_WorldDynamic;
+
 	/** Blueprint damage handler for effect playback */
 	UFUNCTION(BlueprintImplementableEvent, Category="Damage")
 	void OnBoxDamaged(const FVector& DamageLocation, const FVector& DamageImpulse);
@@ -49,6 +54,9 @@ protected:
 
 public:
 
+	/** Initialization */
+	virtual void BeginPlay() override;
+
 	/** EndPlay cleanup */
 	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
@@ -64,4 +72,11 @@ public:
 	virtual void ApplyHealing(float Healing, AActor* Healer) override;
 
 	// ~End CombatDamageable interface
+
+	// ~Begin CombatCheckpointable interface
+
+	/** Saves or restores the HP and placement, bringing the box back if it was broken after the checkpoint */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~End CombatCheckpointable interface
 };
@@ -5,6 +5,7 @@
 #include "Components/SceneComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "PantherJamStats.h"
 
 ACombatDummy::ACombatDummy()
 {
@@ -33,6 +34,9 @@ ACombatDummy::ACombatDummy()
 
 void ACombatDummy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
+	// count the damage event
+	PANTHERJAM_INC_COUNTER(DamageEvents, 1);
+
 	// apply impulse to the dummy
 	Dummy->AddImpulseAtLocation(DamageImpulse, DamageLocation);
 
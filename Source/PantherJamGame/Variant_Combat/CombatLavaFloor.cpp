@@ -3,6 +3,7 @@
 
 #include "CombatLavaFloor.h"
 #include "CombatDamageable.h"
+#include "CombatDamageQueueSubsystem.h"
 #include "Components/StaticMeshComponent.h"
 
 ACombatLavaFloor::ACombatLavaFloor()
@@ -19,9 +20,16 @@ ACombatLavaFloor::ACombatLavaFloor()
 void ACombatLavaFloor::OnFloorHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
 	// check if the hit actor is damageable by casting to the interface
-	if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(OtherActor))
+	if (Cast<ICombatDamageable>(OtherActor))
 	{
-		// damage the actor
-		Damageable->ApplyDamage(Damage, this, Hit.ImpactPoint, FVector::ZeroVector);
+		// queue the damage. Hit events fire for every contact, so coalesce them to one hit per frame
+		FCombatDamageEvent DamageEvent;
+		DamageEvent.Target = OtherActor;
+		DamageEvent.Causer = this;
+		DamageEvent.Location = Hit.ImpactPoint;
+		DamageEvent.Damage = Damage;
+		DamageEvent.bCoalesce = true;
+
+		UCombatDamageQueueSubsystem::QueueDamage(DamageEvent);
 	}
 }
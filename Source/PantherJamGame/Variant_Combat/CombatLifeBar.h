@@ -8,6 +8,7 @@
 
 /**
  *  A basic life bar user widget.
+ *  Combatants only create one when Combat.LifeBars.Batched is off. Otherwise their bars are drawn by UCombatLifeBarLayer.
  */
 UCLASS(abstract)
 class UCombatLifeBar : public UUserWidget
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarLayer.h"
+#include "CombatLifeBarSubsystem.h"
+#include "Engine/World.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+#include "PantherJamStats.h"
+
+int32 UCombatLifeBarLayer::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(LifeBarPaint);
+
+	UWorld* World = GetWorld();
+	UCombatLifeBarSubsystem* LifeBars = World ? World->GetSubsystem<UCombatLifeBarSubsystem>() : nullptr;
+
+	if (!LifeBars)
+	{
+		return LayerId;
+	}
+
+	const FSlateBrush* Brush = FCoreStyle::Get().GetBrush(TEXT("WhiteBrush"));
+	const FVector2f Size(BarSize);
+	const FVector2f HalfSize = Size * 0.5f;
+
+	// keep every background on one layer and every fill on the next, so they batch
+	const int32 BackgroundLayer = LayerId + 1;
+	const int32 FillLayer = LayerId + 2;
+
+	for (const FCombatLifeBarDrawItem& Item : LifeBars->GetDrawItems())
+	{
+		const FVector2f Corner = Item.Position - HalfSize;
+
+		FSlateDrawElement::MakeBox(OutDrawElements, BackgroundLayer, AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(Corner)), Brush, ESlateDrawEffect::None, BackgroundColor);
+
+		if (Item.Percent > 0.0f)
+		{
+			const FVector2f FillSize(Size.X * Item.Percent, Size.Y);
+
+			FSlateDrawElement::MakeBox(OutDrawElements, FillLayer, AllottedGeometry.ToPaintGeometry(FillSize, FSlateLayoutTransform(Corner)), Brush, ESlateDrawEffect::None, Item.Color);
+		}
+	}
+
+	return FillLayer;
+}
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "CombatLifeBarLayer.generated.h"
+
+/**
+ *  Full screen HUD layer that paints every visible combat life bar in one pass.
+ *  All backgrounds share one layer and all fills another, so Slate batches them into two draw calls.
+ */
+UCLASS()
+class UCombatLifeBarLayer : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Size of each life bar */
+	UPROPERTY(EditAnywhere, Category="LifeBar")
+	FVector2D BarSize = FVector2D(80.0f, 8.0f);
+
+	/** Color of the empty part of each life bar */
+	UPROPERTY(EditAnywhere, Category="LifeBar")
+	FLinearColor BackgroundColor = FLinearColor(0.0f, 0.0f, 0.0f, 0.6f);
+
+protected:
+
+	/** Draws the culled life bars */
+	virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+};
@@ -0,0 +1,291 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarSubsystem.h"
+#include "CombatLifeBar.h"
+#include "CombatLifeBarLayer.h"
+#include "CombatPreloadSubsystem.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Components/WidgetComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
+
+static TAutoConsoleVariable<bool> CVarLifeBarsBatched(
+	TEXT("Combat.LifeBars.Batched"),
+	true,
+	TEXT("If true, combat life bars are drawn together by a single HUD layer. If false, each combatant gets its own widget component. Applies to combatants spawned after the change."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLifeBarsMaxDistance(
+	TEXT("Combat.LifeBars.MaxDistance"),
+	2500.0f,
+	TEXT("Life bars further than this from the camera aren't drawn, in cm."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLifeBarsCullInterval(
+	TEXT("Combat.LifeBars.CullInterval"),
+	0.1f,
+	TEXT("Time between distance and occlusion checks for life bars that haven't changed, in seconds."),
+	ECVF_Default);
+
+bool UCombatLifeBarSubsystem::IsBatched()
+{
+	return CVarLifeBarsBatched.GetValueOnGameThread();
+}
+
+void UCombatLifeBarSubsystem::RegisterLifeBar(AActor* Actor, UWidgetComponent* Component, const FLinearColor& Color, const TSoftClassPtr<UCombatLifeBar>& LegacyWidgetClass)
+{
+	if (!Actor || !FPantherJamPresentation::IsEnabled(Actor))
+	{
+		return;
+	}
+
+	UCombatLifeBarSubsystem* Subsystem = Actor->GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>();
+
+	// pooled combatants register again every time they're reused
+	if (!Subsystem || Subsystem->FindEntry(Actor))
+	{
+		return;
+	}
+
+	FCombatLifeBarEntry& Entry = Subsystem->Entries.AddDefaulted_GetRef();
+	Entry.Actor = Actor;
+	Entry.Color = Color;
+
+	Subsystem->EntryIndices.Add(Actor, Subsystem->Entries.Num() - 1);
+
+	if (!Component)
+	{
+		return;
+	}
+
+	// the component is placed in the combatant's blueprint, so the bar goes where it is
+	Entry.Offset = Component->GetRelativeLocation();
+
+	if (IsBatched())
+	{
+		FPantherJamPresentation::DisableComponent(Component);
+		return;
+	}
+
+	// for comparison, let the component draw the bar with its own widget like before
+	if (!LegacyWidgetClass.IsNull())
+	{
+		Component->SetWidgetClass(UCombatPreloadSubsystem::GetOrLoad(Actor, LegacyWidgetClass));
+	}
+
+	Component->InitWidget();
+
+	if (UCombatLifeBar* Widget = Cast<UCombatLifeBar>(Component->GetUserWidgetObject()))
+	{
+		Widget->SetBarColor(Color);
+		Widget->SetLifePercentage(Entry.Percent);
+
+		Entry.LegacyWidget = Widget;
+	}
+
+	Entry.LegacyComponent = Component;
+}
+
+void UCombatLifeBarSubsystem::UnregisterLifeBar(AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	UCombatLifeBarSubsystem* Subsystem = World ? World->GetSubsystem<UCombatLifeBarSubsystem>() : nullptr;
+
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	if (const int32* Index = Subsystem->EntryIndices.Find(Actor))
+	{
+		Subsystem->RemoveEntry(*Index);
+	}
+}
+
+void UCombatLifeBarSubsystem::SetLifePercentage(AActor* Actor, float Percent)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	UCombatLifeBarSubsystem* Subsystem = World ? World->GetSubsystem<UCombatLifeBarSubsystem>() : nullptr;
+	FCombatLifeBarEntry* Entry = Subsystem ? Subsystem->FindEntry(Actor) : nullptr;
+
+	if (!Entry)
+	{
+		return;
+	}
+
+	Percent = FMath::Clamp(Percent, 0.0f, 1.0f);
+
+	if (Entry->Percent == Percent)
+	{
+		return;
+	}
+
+	Entry->Percent = Percent;
+	Entry->bDirty = true;
+
+	if (UCombatLifeBar* Widget = Entry->LegacyWidget.Get())
+	{
+		Widget->SetLifePercentage(Percent);
+	}
+}
+
+void UCombatLifeBarSubsystem::SetLifeBarHidden(AActor* Actor, bool bHidden)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	UCombatLifeBarSubsystem* Subsystem = World ? World->GetSubsystem<UCombatLifeBarSubsystem>() : nullptr;
+	FCombatLifeBarEntry* Entry = Subsystem ? Subsystem->FindEntry(Actor) : nullptr;
+
+	if (!Entry || Entry->bHidden == bHidden)
+	{
+		return;
+	}
+
+	Entry->bHidden = bHidden;
+	Entry->bDirty = true;
+
+	if (UWidgetComponent* Component = Entry->LegacyComponent.Get())
+	{
+		Component->SetHiddenInGame(bHidden);
+	}
+}
+
+int32 UCombatLifeBarSubsystem::GetNumWidgets() const
+{
+	int32 NumWidgets = Layer ? 1 : 0;
+
+	for (const FCombatLifeBarEntry& Entry : Entries)
+	{
+		NumWidgets += Entry.LegacyWidget.IsValid() ? 1 : 0;
+	}
+
+	return NumWidgets;
+}
+
+void UCombatLifeBarSubsystem::Tick(float DeltaTime)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(LifeBarUpdate);
+
+	DrawItems.Reset();
+
+	APlayerController* PC = GetWorld()->GetFirstPlayerController();
+
+	if (!PC || !PC->IsLocalController())
+	{
+		return;
+	}
+
+	// add the layer once there's a player to draw for
+	if (!Layer && IsBatched() && FPantherJamPresentation::IsEnabled(this))
+	{
+		Layer = CreateWidget<UCombatLifeBarLayer>(PC, UCombatLifeBarLayer::StaticClass());
+		Layer->AddToViewport(-1);
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const float MaxDistanceSquared = FMath::Square(CVarLifeBarsMaxDistance.GetValueOnGameThread());
+
+	// changed bars are culled right away, the rest only every so often
+	TimeSinceCull += DeltaTime;
+
+	const bool bCullAll = TimeSinceCull >= CVarLifeBarsCullInterval.GetValueOnGameThread();
+
+	if (bCullAll)
+	{
+		TimeSinceCull = 0.0f;
+	}
+
+	for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+	{
+		FCombatLifeBarEntry& Entry = Entries[Index];
+		AActor* Actor = Entry.Actor.Get();
+
+		// drop the bars of actors that went away without unregistering
+		if (!Actor)
+		{
+			RemoveEntry(Index);
+			continue;
+		}
+
+		// widget component bars draw themselves
+		if (Entry.LegacyComponent.IsValid())
+		{
+			continue;
+		}
+
+		if (Entry.bDirty || bCullAll)
+		{
+			Entry.bDirty = false;
+			Entry.bCulled = Entry.bHidden
+				|| FVector::DistSquared(ViewLocation, Actor->GetActorLocation()) > MaxDistanceSquared
+				|| !Actor->WasRecentlyRendered(0.1f);
+		}
+
+		if (Entry.bCulled)
+		{
+			continue;
+		}
+
+		FVector2D ScreenPosition;
+
+		if (UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(PC, Actor->GetActorLocation() + Entry.Offset, ScreenPosition, true))
+		{
+			DrawItems.Add({ FVector2f(ScreenPosition), Entry.Percent, Entry.Color });
+		}
+	}
+
+	PANTHERJAM_INC_COUNTER(LifeBarWidgets, GetNumWidgets());
+	PANTHERJAM_INC_COUNTER(LifeBarsDrawn, DrawItems.Num());
+}
+
+TStatId UCombatLifeBarSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatLifeBarSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatLifeBarSubsystem::Deinitialize()
+{
+	if (Layer)
+	{
+		Layer->RemoveFromParent();
+		Layer = nullptr;
+	}
+
+	Entries.Reset();
+	EntryIndices.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UCombatLifeBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FCombatLifeBarEntry* UCombatLifeBarSubsystem::FindEntry(AActor* Actor)
+{
+	const int32* Index = EntryIndices.Find(Actor);
+
+	return Index ? &Entries[*Index] : nullptr;
+}
+
+void UCombatLifeBarSubsystem::RemoveEntry(int32 Index)
+{
+	FCombatLifeBarEntry& Entry = Entries[Index];
+
+	EntryIndices.Remove(Entry.Actor);
+
+	// move the last entry into the gap
+	Entries.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (Entries.IsValidIndex(Index))
+	{
+		EntryIndices.Add(Entries[Index].Actor, Index);
+	}
+}
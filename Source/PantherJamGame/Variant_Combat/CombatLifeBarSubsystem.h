@@ -0,0 +1,137 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatLifeBarSubsystem.generated.h"
+
+class UCombatLifeBar;
+class UCombatLifeBarLayer;
+class UWidgetComponent;
+
+/**
+ *  A combatant's life bar
+ */
+struct FCombatLifeBarEntry
+{
+	/** Combatant the bar floats over */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Offset from the actor's location to the bar */
+	FVector Offset = FVector::ZeroVector;
+
+	/** Fill color */
+	FLinearColor Color = FLinearColor::Red;
+
+	/** Filled fraction of the bar */
+	float Percent = 1.0f;
+
+	/** If true, the owner has hidden the bar */
+	bool bHidden = false;
+
+	/** If true, the bar was changed since it was last culled */
+	bool bDirty = true;
+
+	/** If true, the bar is too far away or its actor wasn't rendered */
+	bool bCulled = true;
+
+	/** Combatant's own widget component, only drawing the bar when life bars aren't batched */
+	TWeakObjectPtr<UWidgetComponent> LegacyComponent;
+
+	/** Life bar widget of the legacy component */
+	TWeakObjectPtr<UCombatLifeBar> LegacyWidget;
+};
+
+/**
+ *  A culled life bar, ready to be drawn
+ */
+struct FCombatLifeBarDrawItem
+{
+	/** Bar center in viewport widget space */
+	FVector2f Position;
+
+	/** Filled fraction of the bar */
+	float Percent;
+
+	/** Fill color */
+	FLinearColor Color;
+};
+
+/**
+ *  Draws the life bars of every combatant from a single HUD layer widget, instead of giving each one
+ *  its own widget component, user widget and render target.
+ *  Bars are culled by distance and by whether their actor was rendered last frame. Changed bars are culled right away,
+ *  the rest on an interval. Widget count, update and paint times are reported under "stat PantherJam".
+ *  Combatants keep their life bar widget component, which places the bar. Combat.LifeBars.Batched 0 lets the component
+ *  draw the bar with its own widget instead, for comparison.
+ */
+UCLASS()
+class UCombatLifeBarSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Life bars of every registered combatant */
+	TArray<FCombatLifeBarEntry> Entries;
+
+	/** Index of each combatant's entry */
+	TMap<TWeakObjectPtr<AActor>, int32> EntryIndices;
+
+	/** Bars that survived culling this frame */
+	TArray<FCombatLifeBarDrawItem> DrawItems;
+
+	/** Layer widget the bars are drawn in */
+	UPROPERTY(Transient)
+	TObjectPtr<UCombatLifeBarLayer> Layer;
+
+	/** Time since every bar was last culled */
+	float TimeSinceCull = 0.0f;
+
+public:
+
+	/** Returns true if life bars are drawn by the shared layer instead of per combatant widget components */
+	static bool IsBatched();
+
+	/**
+	 *  Adds a life bar over the actor, placed at the life bar component.
+	 *  When life bars aren't batched, the component draws the bar with LegacyWidgetClass if set, or its own widget class otherwise.
+	 */
+	static void RegisterLifeBar(AActor* Actor, UWidgetComponent* Component, const FLinearColor& Color, const TSoftClassPtr<UCombatLifeBar>& LegacyWidgetClass);
+
+	/** Removes the actor's life bar */
+	static void UnregisterLifeBar(AActor* Actor);
+
+	/** Sets the filled fraction of the actor's life bar */
+	static void SetLifePercentage(AActor* Actor, float Percent);
+
+	/** Shows or hides the actor's life bar */
+	static void SetLifeBarHidden(AActor* Actor, bool bHidden);
+
+	/** Returns the bars to draw this frame */
+	const TArray<FCombatLifeBarDrawItem>& GetDrawItems() const { return DrawItems; }
+
+	/** Returns the number of user widgets used to draw life bars */
+	int32 GetNumWidgets() const;
+
+	/** Culls and projects the life bars */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for this subsystem */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the actor's entry, if it has one */
+	FCombatLifeBarEntry* FindEntry(AActor* Actor);
+
+	/** Removes the entry at the given index, keeping the array compact */
+	void RemoveEntry(int32 Index);
+};
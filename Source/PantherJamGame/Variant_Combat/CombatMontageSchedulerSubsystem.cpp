@@ -0,0 +1,373 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatMontageSchedulerSubsystem.h"
+#include "CombatAttacker.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<int32> CVarMontageTimingTables(
+	TEXT("Combat.MontageTimingTables"),
+	1,
+	TEXT("0: always play attack montages on the anim instance.\n")
+	TEXT("1: play attack montages from their timing tables when the mesh is not animating or skips animation updates.\n")
+	TEXT("2: always play attack montages from their timing tables."),
+	ECVF_Default);
+
+/** Max number of section changes a single playback can go through in one frame */
+static constexpr int32 MaxPlaybackStepsPerFrame = 16;
+
+bool UCombatMontageSchedulerSubsystem::PlayMontage(USkeletalMeshComponent* Mesh, UAnimMontage* Montage, const FCombatMontageTimingTable& Table, FOnMontageEnded& EndDelegate)
+{
+	// play the montage from its timing table if the mesh won't animate it, or won't animate it every frame
+	if (Table.IsValidFor(Montage))
+	{
+		const bool bAnimating = IsAnimatingMontages(Mesh);
+
+		if (!bAnimating || IsSkippingAnimUpdates(Mesh))
+		{
+			if (UCombatMontageSchedulerSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatMontageSchedulerSubsystem>())
+			{
+				Subsystem->StartPlayback(Mesh, Table, EndDelegate);
+
+				// still show the montage on meshes that animate
+				if (bAnimating)
+				{
+					Subsystem->PlayVisualMontage(Mesh, Montage);
+				}
+
+				return true;
+			}
+		}
+	}
+
+	// play the montage on the anim instance
+	if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+	{
+		const float MontageLength = AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+
+		// subscribe to montage completed and interrupted events
+		if (MontageLength > 0.0f)
+		{
+			AnimInstance->Montage_SetEndDelegate(EndDelegate, Montage);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UCombatMontageSchedulerSubsystem::JumpToSection(USkeletalMeshComponent* Mesh, FName SectionName, UAnimMontage* Montage)
+{
+	// is the montage playing from its timing table?
+	if (UCombatMontageSchedulerSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatMontageSchedulerSubsystem>())
+	{
+		FCombatMontagePlayback* Playback = Subsystem->Playbacks.Find(Mesh);
+
+		if (Playback && Playback->Table->Montage.Get() == Montage)
+		{
+			const int32 SectionIndex = Playback->Table->FindSection(SectionName);
+
+			if (SectionIndex != INDEX_NONE)
+			{
+				Subsystem->SetPlaybackSection(*Playback, SectionIndex);
+			}
+		}
+	}
+
+	// jump to the section on the anim instance. This also keeps visual only montages in step
+	if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+	{
+		AnimInstance->Montage_JumpToSection(SectionName, Montage);
+	}
+}
+
+void UCombatMontageSchedulerSubsystem::StopMontage(USkeletalMeshComponent* Mesh, float BlendOutTime, UAnimMontage* Montage)
+{
+	// is the montage playing from its timing table?
+	if (UCombatMontageSchedulerSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatMontageSchedulerSubsystem>())
+	{
+		const TObjectKey<USkeletalMeshComponent> MeshKey(Mesh);
+		FCombatMontagePlayback* Playback = Subsystem->Playbacks.Find(MeshKey);
+
+		if (Playback && (!Montage || Playback->Table->Montage.Get() == Montage))
+		{
+			// take the playback off the schedule before calling back, in case the callback plays another montage
+			FOnMontageEnded EndDelegate = MoveTemp(Playback->EndDelegate);
+			UAnimMontage* StoppedMontage = Playback->Table->Montage.Get();
+			Subsystem->Playbacks.Remove(MeshKey);
+
+			EndDelegate.ExecuteIfBound(StoppedMontage, true);
+		}
+	}
+
+	// stop the montage on the anim instance. This also stops visual only montages
+	if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+	{
+		AnimInstance->Montage_Stop(BlendOutTime, Montage);
+	}
+}
+
+FVector UCombatMontageSchedulerSubsystem::GetAttackSourceLocation(const USkeletalMeshComponent* Mesh, FName SourceBone)
+{
+	// attack traces fired from a timing table use the bone position baked into it
+	if (const UCombatMontageSchedulerSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatMontageSchedulerSubsystem>())
+	{
+		if (Subsystem->FiringMesh == Mesh && Subsystem->FiringEvent->SourceBone == SourceBone)
+		{
+			return Mesh->GetComponentTransform().TransformPosition(Subsystem->FiringEvent->SourceLocation);
+		}
+	}
+
+	// otherwise read the animated socket
+	return Mesh->GetSocketLocation(SourceBone);
+}
+
+bool UCombatMontageSchedulerSubsystem::IsAnimatingMontages(const USkeletalMeshComponent* Mesh)
+{
+	switch (CVarMontageTimingTables.GetValueOnGameThread())
+	{
+	case 0:
+		return true;
+
+	case 1:
+		return Mesh->GetAnimInstance() && Mesh->IsComponentTickEnabled() && Mesh->ShouldTickPose();
+
+	default:
+		return false;
+	}
+}
+
+bool UCombatMontageSchedulerSubsystem::IsSkippingAnimUpdates(const USkeletalMeshComponent* Mesh)
+{
+	return CVarMontageTimingTables.GetValueOnGameThread() == 1 && Mesh->ShouldUseUpdateRateOptimizations();
+}
+
+bool UCombatMontageSchedulerSubsystem::IsDrivingAttackNotifies(const USkeletalMeshComponent* Mesh)
+{
+	const UWorld* World = Mesh->GetWorld();
+	const UCombatMontageSchedulerSubsystem* Subsystem = World ? World->GetSubsystem<UCombatMontageSchedulerSubsystem>() : nullptr;
+
+	return Subsystem && (Subsystem->Playbacks.Contains(Mesh) || Subsystem->VisualMontages.Contains(Mesh));
+}
+
+void UCombatMontageSchedulerSubsystem::PlayVisualMontage(USkeletalMeshComponent* Mesh, UAnimMontage* Montage)
+{
+	UAnimInstance* AnimInstance = Mesh->GetAnimInstance();
+
+	if (!AnimInstance || AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true) <= 0.0f)
+	{
+		return;
+	}
+
+	// keep ignoring the anim instance's notifies until the montage has fully played out, since it can lag behind the table
+	++VisualMontages.FindOrAdd(Mesh);
+
+	FOnMontageEnded VisualEndDelegate = FOnMontageEnded::CreateUObject(this, &UCombatMontageSchedulerSubsystem::OnVisualMontageEnded, TObjectKey<USkeletalMeshComponent>(Mesh));
+	AnimInstance->Montage_SetEndDelegate(VisualEndDelegate, Montage);
+}
+
+void UCombatMontageSchedulerSubsystem::OnVisualMontageEnded(UAnimMontage* Montage, bool bInterrupted, TObjectKey<USkeletalMeshComponent> MeshKey)
+{
+	if (int32* Count = VisualMontages.Find(MeshKey))
+	{
+		if (--(*Count) <= 0)
+		{
+			VisualMontages.Remove(MeshKey);
+		}
+	}
+}
+
+void UCombatMontageSchedulerSubsystem::StartPlayback(USkeletalMeshComponent* Mesh, const FCombatMontageTimingTable& Table, FOnMontageEnded& EndDelegate)
+{
+	// a new montage replaces whatever the mesh was playing
+	FCombatMontagePlayback& Playback = Playbacks.FindOrAdd(Mesh);
+	Playback.Mesh = Mesh;
+	Playback.Table = &Table;
+	Playback.EndDelegate = EndDelegate;
+
+	SetPlaybackSection(Playback, Table.FindSectionAtTime(0.0f));
+
+	PANTHERJAM_INC_COUNTER(ScheduledMontages, 1);
+}
+
+void UCombatMontageSchedulerSubsystem::SetPlaybackSection(FCombatMontagePlayback& Playback, int32 SectionIndex)
+{
+	Playback.SectionIndex = SectionIndex;
+	Playback.Position = Playback.Table->Sections[SectionIndex].StartTime;
+	Playback.NextEvent = Playback.Table->FindFirstEventAtTime(Playback.Position);
+	Playback.Serial = ++NextSerial;
+}
+
+void UCombatMontageSchedulerSubsystem::AdvancePlayback(const TObjectKey<USkeletalMeshComponent>& MeshKey, float DeltaTime)
+{
+	FCombatMontagePlayback* Playback = Playbacks.Find(MeshKey);
+
+	if (!Playback)
+	{
+		return;
+	}
+
+	float RemainingTime = DeltaTime * Playback->Table->RateScale;
+
+	for (int32 Step = 0; Step < MaxPlaybackStepsPerFrame; ++Step)
+	{
+		// drop the playback if the mesh is gone
+		USkeletalMeshComponent* Mesh = Playback->Mesh.Get();
+
+		if (!Mesh)
+		{
+			Playbacks.Remove(MeshKey);
+			return;
+		}
+
+		const FCombatMontageTimingTable& Table = *Playback->Table;
+		const FCombatMontageSectionTiming& Section = Table.Sections[Playback->SectionIndex];
+
+		const float StartTime = Playback->Position;
+		const float EndTime = FMath::Min(StartTime + RemainingTime, Section.EndTime);
+		const bool bSectionFinished = StartTime + RemainingTime >= Section.EndTime;
+
+		// fire the events we pass over. Events at the end of the section only fire if we reach it
+		bool bJumped = false;
+
+		while (Playback->NextEvent < Table.Events.Num())
+		{
+			const FCombatMontageTimingEvent& Event = Table.Events[Playback->NextEvent];
+
+			if (Event.Time > EndTime || (Event.Time == EndTime && !bSectionFinished))
+			{
+				break;
+			}
+
+			++Playback->NextEvent;
+
+			const uint32 Serial = Playback->Serial;
+			FireEvent(Mesh, Event);
+
+			// the event may have stopped the montage, restarted it or jumped to another section
+			Playback = Playbacks.Find(MeshKey);
+
+			if (!Playback)
+			{
+				return;
+			}
+
+			if (Playback->Serial != Serial)
+			{
+				RemainingTime = FMath::Max(RemainingTime - (Event.Time - StartTime), 0.0f);
+				bJumped = true;
+				break;
+			}
+		}
+
+		if (bJumped)
+		{
+			continue;
+		}
+
+		RemainingTime -= EndTime - StartTime;
+		Playback->Position = EndTime;
+
+		if (!bSectionFinished)
+		{
+			return;
+		}
+
+		// move on to the next section
+		if (Table.Sections.IsValidIndex(Section.NextSection))
+		{
+			SetPlaybackSection(*Playback, Section.NextSection);
+			continue;
+		}
+
+		// the montage has finished. Take it off the schedule before calling back, in case the callback plays another one
+		FOnMontageEnded EndDelegate = MoveTemp(Playback->EndDelegate);
+		UAnimMontage* FinishedMontage = Table.Montage.Get();
+		Playbacks.Remove(MeshKey);
+
+		EndDelegate.ExecuteIfBound(FinishedMontage, false);
+		return;
+	}
+}
+
+void UCombatMontageSchedulerSubsystem::FireEvent(const USkeletalMeshComponent* Mesh, const FCombatMontageTimingEvent& Event)
+{
+	ICombatAttacker* Attacker = Cast<ICombatAttacker>(Mesh->GetOwner());
+
+	if (!Attacker)
+	{
+		return;
+	}
+
+	switch (Event.Type)
+	{
+	case ECombatMontageEvent::AttackTrace:
+
+		// expose the baked bone position to GetAttackSourceLocation while the trace is set up
+		FiringEvent = &Event;
+		FiringMesh = Mesh;
+
+		Attacker->DoAttackTrace(Event.SourceBone);
+
+		FiringEvent = nullptr;
+		FiringMesh = nullptr;
+		break;
+
+	case ECombatMontageEvent::CheckCombo:
+
+		Attacker->CheckCombo();
+		break;
+
+	case ECombatMontageEvent::CheckChargedAttack:
+
+		Attacker->CheckChargedAttack();
+		break;
+	}
+}
+
+void UCombatMontageSchedulerSubsystem::Tick(float DeltaTime)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(MontageSchedule);
+
+	Super::Tick(DeltaTime);
+
+	// advance a snapshot of the playbacks, since events can start and stop montages
+	Playbacks.GenerateKeyArray(TickMeshes);
+
+	for (const TObjectKey<USkeletalMeshComponent>& MeshKey : TickMeshes)
+	{
+		AdvancePlayback(MeshKey, DeltaTime);
+	}
+
+	// forget visual montages on meshes that were destroyed before they ended
+	for (auto It = VisualMontages.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+TStatId UCombatMontageSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatMontageSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatMontageSchedulerSubsystem::Deinitialize()
+{
+	Playbacks.Empty();
+	VisualMontages.Empty();
+	TickMeshes.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatMontageSchedulerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Animation/AnimInstance.h"
+#include "UObject/ObjectKey.h"
+#include "CombatMontageTiming.h"
+#include "CombatMontageSchedulerSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ *  An attack montage being played back from its timing table
+ */
+struct FCombatMontagePlayback
+{
+	/** Mesh the montage stands in for */
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+	/** Timing table for the montage. Owned by the mesh's actor */
+	const FCombatMontageTimingTable* Table = nullptr;
+
+	/** Called when the montage ends or is stopped */
+	FOnMontageEnded EndDelegate;
+
+	/** Section currently playing */
+	int32 SectionIndex = 0;
+
+	/** Current montage time */
+	float Position = 0.0f;
+
+	/** Next event to fire */
+	int32 NextEvent = 0;
+
+	/** Changes whenever the playback is restarted or jumps to a section */
+	uint32 Serial = 0;
+};
+
+/**
+ *  Plays combat attack montages for meshes that aren't animating, such as on dedicated servers or for far away enemies.
+ *  The montage sections and attack notifies are replayed from a timing table baked in the editor, so
+ *  DoAttackTrace, CheckCombo and CheckChargedAttack fire at the same times and from the same bone positions
+ *  without evaluating any animation. Meshes that are animating play their montages on the anim instance as usual.
+ *  Meshes that animate with update rate optimizations would dispatch notifies late or several at once,
+ *  so their gameplay also runs from the table while the anim instance plays the montage for visuals only.
+ *  Can be toggled with Combat.MontageTimingTables.
+ */
+UCLASS()
+class UCombatMontageSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Montages played from timing tables, by mesh */
+	TMap<TObjectKey<USkeletalMeshComponent>, FCombatMontagePlayback> Playbacks;
+
+	/** Number of visual only montages still playing on each mesh's anim instance */
+	TMap<TObjectKey<USkeletalMeshComponent>, int32> VisualMontages;
+
+	/** Meshes to advance this frame. Kept around to reuse the allocation */
+	TArray<TObjectKey<USkeletalMeshComponent>> TickMeshes;
+
+	/** Attack trace event currently firing, if any */
+	const FCombatMontageTimingEvent* FiringEvent = nullptr;
+
+	/** Mesh the attack trace event is firing for */
+	const USkeletalMeshComponent* FiringMesh = nullptr;
+
+	/** Source of playback serial numbers */
+	uint32 NextSerial = 0;
+
+public:
+
+	/** Plays an attack montage on the mesh, either on its anim instance or from the timing table. Returns true if the montage started */
+	static bool PlayMontage(USkeletalMeshComponent* Mesh, UAnimMontage* Montage, const FCombatMontageTimingTable& Table, FOnMontageEnded& EndDelegate);
+
+	/** Jumps to a section of an attack montage playing on the mesh */
+	static void JumpToSection(USkeletalMeshComponent* Mesh, FName SectionName, UAnimMontage* Montage);
+
+	/** Stops an attack montage playing on the mesh, or all of them if no montage is given */
+	static void StopMontage(USkeletalMeshComponent* Mesh, float BlendOutTime, UAnimMontage* Montage = nullptr);
+
+	/** Returns the world location an attack trace from the given bone or socket should start at */
+	static FVector GetAttackSourceLocation(const USkeletalMeshComponent* Mesh, FName SourceBone);
+
+	/** Returns true if the mesh will advance montages on its anim instance */
+	static bool IsAnimatingMontages(const USkeletalMeshComponent* Mesh);
+
+	/** Returns true if the mesh may skip animation updates, delaying its notifies */
+	static bool IsSkippingAnimUpdates(const USkeletalMeshComponent* Mesh);
+
+	/** Returns true if the mesh's attack notifies come from a timing table, so the anim instance's copies must be ignored */
+	static bool IsDrivingAttackNotifies(const USkeletalMeshComponent* Mesh);
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Starts playing a montage from its timing table */
+	void StartPlayback(USkeletalMeshComponent* Mesh, const FCombatMontageTimingTable& Table, FOnMontageEnded& EndDelegate);
+
+	/** Plays a montage on the anim instance for visuals only, alongside its timing table */
+	void PlayVisualMontage(USkeletalMeshComponent* Mesh, UAnimMontage* Montage);
+
+	/** Called when a visual only montage ends on the anim instance */
+	void OnVisualMontageEnded(UAnimMontage* Montage, bool bInterrupted, TObjectKey<USkeletalMeshComponent> MeshKey);
+
+	/** Moves a playback to the start of a section */
+	void SetPlaybackSection(FCombatMontagePlayback& Playback, int32 SectionIndex);
+
+	/** Advances a playback, firing any events it passes and ending it if it runs out of sections */
+	void AdvancePlayback(const TObjectKey<USkeletalMeshComponent>& MeshKey, float DeltaTime);
+
+	/** Fires a timing table event on the mesh's owner */
+	void FireEvent(const USkeletalMeshComponent* Mesh, const FCombatMontageTimingEvent& Event);
+};
@@ -0,0 +1,264 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatMontageTiming.h"
+#include "Animation/AnimMontage.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/Crc.h"
+#include "AnimNotify_DoAttackTrace.h"
+
+#if WITH_EDITOR
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "AnimNotify_CheckCombo.h"
+#include "AnimNotify_CheckChargedAttack.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatMontageTiming, Log, All);
+
+bool FCombatMontageTimingTable::IsValidFor(const UAnimMontage* InMontage) const
+{
+	if (!InMontage || Montage.Get() != InMontage || Sections.IsEmpty())
+	{
+		return false;
+	}
+
+	// the montage may have been edited and saved without saving the table's owner, so check once that it still matches
+	if (!bCheckedMontageHash)
+	{
+		bCheckedMontageHash = true;
+		bMatchesMontage = HashMontage(InMontage) == MontageHash;
+
+		if (!bMatchesMontage)
+		{
+			UE_LOG(LogCombatMontageTiming, Warning, TEXT("%s changed since its timing table was built. Playing the montage instead until the owner is saved again"), *InMontage->GetPathName());
+		}
+	}
+
+	return bMatchesMontage;
+}
+
+uint32 FCombatMontageTimingTable::HashMontage(const UAnimMontage* InMontage)
+{
+	if (!InMontage)
+	{
+		return 0;
+	}
+
+	// names are hashed by their text, since FName hashes aren't stable between runs
+	auto HashName = [](FName Name) { return FCrc::StrCrc32(*Name.ToString()); };
+
+	uint32 Hash = HashCombine(GetTypeHash(InMontage->RateScale), GetTypeHash(InMontage->GetPlayLength()));
+
+	for (const FCompositeSection& Section : InMontage->CompositeSections)
+	{
+		Hash = HashCombine(Hash, HashName(Section.SectionName));
+		Hash = HashCombine(Hash, HashName(Section.NextSectionName));
+		Hash = HashCombine(Hash, GetTypeHash(Section.GetTime()));
+	}
+
+	auto HashNotifies = [&Hash, &HashName](const TArray<FAnimNotifyEvent>& Notifies)
+	{
+		for (const FAnimNotifyEvent& NotifyEvent : Notifies)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(NotifyEvent.GetTriggerTime()));
+			Hash = HashCombine(Hash, NotifyEvent.Notify ? HashName(NotifyEvent.Notify->GetClass()->GetFName()) : 0);
+
+			if (const UAnimNotify_DoAttackTrace* TraceNotify = Cast<UAnimNotify_DoAttackTrace>(NotifyEvent.Notify))
+			{
+				Hash = HashCombine(Hash, HashName(TraceNotify->GetAttackBoneName()));
+			}
+		}
+	};
+
+	HashNotifies(InMontage->Notifies);
+
+	for (const FSlotAnimationTrack& SlotTrack : InMontage->SlotAnimTracks)
+	{
+		for (const FAnimSegment& Segment : SlotTrack.AnimTrack.AnimSegments)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Segment.StartPos));
+			Hash = HashCombine(Hash, GetTypeHash(Segment.AnimStartTime));
+			Hash = HashCombine(Hash, GetTypeHash(Segment.AnimEndTime));
+			Hash = HashCombine(Hash, GetTypeHash(Segment.AnimPlayRate));
+			Hash = HashCombine(Hash, GetTypeHash(Segment.LoopingCount));
+
+			if (const UAnimSequenceBase* Animation = Segment.GetAnimReference())
+			{
+				Hash = HashCombine(Hash, FCrc::StrCrc32(*Animation->GetPathName()));
+				HashNotifies(Animation->Notifies);
+			}
+		}
+	}
+
+	return Hash;
+}
+
+int32 FCombatMontageTimingTable::FindSection(FName SectionName) const
+{
+	return Sections.IndexOfByPredicate([SectionName](const FCombatMontageSectionTiming& Section) { return Section.Name == SectionName; });
+}
+
+int32 FCombatMontageTimingTable::FindSectionAtTime(float Time) const
+{
+	const int32 SectionIndex = Sections.IndexOfByPredicate([Time](const FCombatMontageSectionTiming& Section) { return Time >= Section.StartTime && Time < Section.EndTime; });
+
+	// anything past the end belongs to the last section
+	return SectionIndex != INDEX_NONE ? SectionIndex : Sections.Num() - 1;
+}
+
+int32 FCombatMontageTimingTable::FindFirstEventAtTime(float Time) const
+{
+	return Algo::LowerBoundBy(Events, Time, &FCombatMontageTimingEvent::Time);
+}
+
+#if WITH_EDITOR
+
+/** Samples the component space location of a bone or skeleton socket in an animation */
+static FVector SampleSourceLocation(const UAnimSequence* Sequence, FName SourceBone, double Time)
+{
+	const USkeleton* Skeleton = Sequence->GetSkeleton();
+
+	if (!Skeleton)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// sockets are sampled through their parent bone
+	FName BoneName = SourceBone;
+	FTransform ComponentTransform = FTransform::Identity;
+
+	if (const USkeletalMeshSocket* Socket = Skeleton->FindSocket(SourceBone))
+	{
+		BoneName = Socket->BoneName;
+		ComponentTransform = Socket->GetSocketLocalTransform();
+	}
+
+	// walk up the bone chain to get to component space
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	const FAnimExtractContext ExtractContext(Time);
+
+	for (int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName); BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+	{
+		FTransform BoneTransform;
+		Sequence->GetBoneTransform(BoneTransform, FSkeletonPoseBoneIndex(BoneIndex), ExtractContext, false);
+
+		ComponentTransform *= BoneTransform;
+	}
+
+	return ComponentTransform.GetLocation();
+}
+
+void FCombatMontageTimingTable::Build(UAnimMontage* InMontage)
+{
+	Montage = InMontage;
+	RateScale = 1.0f;
+	Sections.Reset();
+	Events.Reset();
+	MontageHash = HashMontage(InMontage);
+	bCheckedMontageHash = false;
+
+	if (!InMontage)
+	{
+		return;
+	}
+
+	RateScale = InMontage->RateScale;
+
+	// copy the sections
+	for (int32 SectionIndex = 0; SectionIndex < InMontage->CompositeSections.Num(); ++SectionIndex)
+	{
+		FCombatMontageSectionTiming& Section = Sections.AddDefaulted_GetRef();
+		Section.Name = InMontage->GetSectionName(SectionIndex);
+		InMontage->GetSectionStartAndEndTime(SectionIndex, Section.StartTime, Section.EndTime);
+	}
+
+	// link up the section that follows each one
+	for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+	{
+		Sections[SectionIndex].NextSection = FindSection(InMontage->CompositeSections[SectionIndex].NextSectionName);
+	}
+
+	// adds an attack notify at the given montage time
+	auto AddNotify = [this, InMontage](const UAnimNotify* Notify, float Time)
+	{
+		FCombatMontageTimingEvent Event;
+		Event.Time = Time;
+
+		if (const UAnimNotify_DoAttackTrace* TraceNotify = Cast<UAnimNotify_DoAttackTrace>(Notify))
+		{
+			Event.Type = ECombatMontageEvent::AttackTrace;
+			Event.SourceBone = TraceNotify->GetAttackBoneName();
+
+			// bake the source bone pose from the animation playing at that time
+			if (InMontage->SlotAnimTracks.Num() > 0)
+			{
+				if (const FAnimSegment* Segment = InMontage->SlotAnimTracks[0].AnimTrack.GetSegmentAtTime(Time))
+				{
+					if (const UAnimSequence* Sequence = Cast<UAnimSequence>(Segment->GetAnimReference()))
+					{
+						Event.SourceLocation = SampleSourceLocation(Sequence, Event.SourceBone, Segment->ConvertTrackPosToAnimPos(Time));
+					}
+				}
+			}
+		}
+		else if (Cast<UAnimNotify_CheckCombo>(Notify))
+		{
+			Event.Type = ECombatMontageEvent::CheckCombo;
+		}
+		else if (Cast<UAnimNotify_CheckChargedAttack>(Notify))
+		{
+			Event.Type = ECombatMontageEvent::CheckChargedAttack;
+		}
+		else
+		{
+			// not an attack notify
+			return;
+		}
+
+		Events.Add(Event);
+	};
+
+	// gather the notifies placed on the montage
+	for (const FAnimNotifyEvent& NotifyEvent : InMontage->Notifies)
+	{
+		AddNotify(NotifyEvent.Notify, NotifyEvent.GetTriggerTime());
+	}
+
+	// gather the notifies placed on the animations the montage plays, converted to montage time
+	for (const FSlotAnimationTrack& SlotTrack : InMontage->SlotAnimTracks)
+	{
+		for (const FAnimSegment& Segment : SlotTrack.AnimTrack.AnimSegments)
+		{
+			const UAnimSequenceBase* Animation = Segment.GetAnimReference();
+
+			if (!Animation || Segment.AnimPlayRate <= 0.0f)
+			{
+				continue;
+			}
+
+			const float LoopLength = (Segment.AnimEndTime - Segment.AnimStartTime) / Segment.AnimPlayRate;
+
+			for (const FAnimNotifyEvent& NotifyEvent : Animation->Notifies)
+			{
+				const float AnimTime = NotifyEvent.GetTriggerTime();
+
+				if (AnimTime < Segment.AnimStartTime || AnimTime >= Segment.AnimEndTime)
+				{
+					continue;
+				}
+
+				for (int32 Loop = 0; Loop < Segment.LoopingCount; ++Loop)
+				{
+					AddNotify(NotifyEvent.Notify, Segment.StartPos + Loop * LoopLength + (AnimTime - Segment.AnimStartTime) / Segment.AnimPlayRate);
+				}
+			}
+		}
+	}
+
+	// keep the events in playback order
+	Events.StableSort([](const FCombatMontageTimingEvent& A, const FCombatMontageTimingEvent& B) { return A.Time < B.Time; });
+}
+
+#endif
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CombatMontageTiming.generated.h"
+
+class UAnimMontage;
+
+/**
+ *  Attack notifies that can be replayed from a timing table
+ */
+UENUM()
+enum class ECombatMontageEvent : uint8
+{
+	AttackTrace,
+	CheckCombo,
+	CheckChargedAttack
+};
+
+/**
+ *  A single attack notify baked out of a montage
+ */
+USTRUCT()
+struct FCombatMontageTimingEvent
+{
+	GENERATED_BODY()
+
+	/** Montage time the notify fires at */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	float Time = 0.0f;
+
+	/** Notify type */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	ECombatMontageEvent Type = ECombatMontageEvent::AttackTrace;
+
+	/** Bone or socket the attack trace starts from */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	FName SourceBone;
+
+	/** Component space location of the source bone or socket when the notify fires */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	FVector SourceLocation = FVector::ZeroVector;
+};
+
+/**
+ *  A montage section baked out of a montage
+ */
+USTRUCT()
+struct FCombatMontageSectionTiming
+{
+	GENERATED_BODY()
+
+	/** Section name, as used by Montage_JumpToSection */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	FName Name;
+
+	/** Montage time the section starts at */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	float StartTime = 0.0f;
+
+	/** Montage time the section ends at */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	float EndTime = 0.0f;
+
+	/** Index of the section that plays after this one, or INDEX_NONE if the montage ends here */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	int32 NextSection = INDEX_NONE;
+};
+
+/**
+ *  Compact copy of an attack montage's sections and attack notifies.
+ *  Built in the editor whenever the owner is saved or cooked, so attacks can be resolved
+ *  without evaluating the montage on a skeletal mesh.
+ *  The table keeps a hash of the montage's sections and notifies, and refuses to stand in for a montage
+ *  that has been edited since, so callers play the montage itself until the owner is saved again.
+ */
+USTRUCT()
+struct FCombatMontageTimingTable
+{
+	GENERATED_BODY()
+
+	/** Montage the table was built from. Soft, so the table doesn't force the montage to load */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	TSoftObjectPtr<UAnimMontage> Montage;
+
+	/** Montage play rate */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	float RateScale = 1.0f;
+
+	/** Montage sections */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	TArray<FCombatMontageSectionTiming> Sections;
+
+	/** Attack notifies, sorted by time */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	TArray<FCombatMontageTimingEvent> Events;
+
+	/** Hash of the montage's sections and notifies when the table was built */
+	UPROPERTY(VisibleAnywhere, Category="Timing")
+	uint32 MontageHash = 0;
+
+private:
+
+	/** If true, the montage has been hashed and compared against MontageHash */
+	mutable bool bCheckedMontageHash = false;
+
+	/** If true, the montage still matched MontageHash when it was checked */
+	mutable bool bMatchesMontage = false;
+
+public:
+
+	/** Returns true if the table was built from the given montage, the montage hasn't changed since, and the table can stand in for it */
+	bool IsValidFor(const UAnimMontage* InMontage) const;
+
+	/** Returns a hash of the montage's sections and notifies, including those on the animations it plays */
+	static uint32 HashMontage(const UAnimMontage* InMontage);
+
+	/** Returns the index of the section with the given name, or INDEX_NONE */
+	int32 FindSection(FName SectionName) const;
+
+	/** Returns the index of the section playing at the given time */
+	int32 FindSectionAtTime(float Time) const;
+
+	/** Returns the index of the first event at or after the given time */
+	int32 FindFirstEventAtTime(float Time) const;
+
+#if WITH_EDITOR
+	/** Rebuilds the table from the montage's sections, attack notifies and source bone poses */
+	void Build(UAnimMontage* InMontage);
+#endif
+};
@@ -9,6 +9,7 @@
 #include "CombatCharacter.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
+#include "PantherJamStats.h"
 
 void ACombatPlayerController::SetupInputComponent()
 {
@@ -39,6 +40,8 @@ void ACombatPlayerController::SetRespawnTransform(const FTransform& NewRespawn)
 void ACombatPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
 	// spawn a new character at the respawn transform
+	PANTHERJAM_INC_COUNTER(Spawns, 1);
+
 	if (ACombatCharacter* RespawnedCharacter = GetWorld()->SpawnActor<ACombatCharacter>(CharacterClass, RespawnTransform))
 	{
 		// possess the character
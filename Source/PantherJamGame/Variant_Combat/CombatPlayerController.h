@@ -45,6 +45,9 @@ public:
 	/** Updates the character respawn transform */
 	void SetRespawnTransform(const FTransform& NewRespawn);
 
+	/** Returns the character respawn transform */
+	const FTransform& GetRespawnTransform() const { return RespawnTransform; }
+
 protected:
 
 	/** Called if the possessed pawn is destroyed */
@@ -0,0 +1,205 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatPreloadSubsystem.h"
+#include "CombatActivationVolume.h"
+#include "PantherJamPlayerSnapshotSubsystem.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<bool> CVarPreloadAsync(
+	TEXT("Combat.Preload.Async"),
+	true,
+	TEXT("If true, combat assets are loaded asynchronously when they're about to be needed. If false, they're loaded up front like hard references."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarPreloadZoneCheckInterval(
+	TEXT("Combat.Preload.ZoneCheckInterval"),
+	0.25f,
+	TEXT("Time between checks for players approaching activation volumes, in seconds."),
+	ECVF_Default);
+
+bool UCombatPreloadSubsystem::IsAsyncEnabled()
+{
+	return CVarPreloadAsync.GetValueOnGameThread();
+}
+
+void UCombatPreloadSubsystem::RequestPreload(const UObject* WorldContextObject, TArray<FSoftObjectPath> Assets, FSimpleDelegate OnLoaded)
+{
+	Assets.RemoveAll([](const FSoftObjectPath& Asset) { return Asset.IsNull(); });
+
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UCombatPreloadSubsystem* Subsystem = World ? World->GetSubsystem<UCombatPreloadSubsystem>() : nullptr;
+
+	if (Assets.IsEmpty() || !Subsystem)
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+
+	// load everything right away, the way hard references would
+	if (!IsAsyncEnabled())
+	{
+		Subsystem->Handles.Add(StreamableManager.RequestSyncLoad(Assets));
+
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	// the delegate is called right away if everything is already loaded
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(Assets, OnLoaded);
+
+	if (Handle.IsValid())
+	{
+		Subsystem->Handles.Add(Handle);
+	}
+	else
+	{
+		OnLoaded.ExecuteIfBound();
+	}
+}
+
+void UCombatPreloadSubsystem::AddPreloadZone(ACombatActivationVolume* Volume, const FBox& Bounds, float Distance)
+{
+	if (!Volume)
+	{
+		return;
+	}
+
+	UCombatPreloadSubsystem* Subsystem = Volume->GetWorld()->GetSubsystem<UCombatPreloadSubsystem>();
+
+	// without async loading, there's no point in waiting for the player
+	if (!Subsystem || !IsAsyncEnabled())
+	{
+		Volume->PreloadActivatables();
+		return;
+	}
+
+	FCombatPreloadZone& Zone = Subsystem->Zones.AddDefaulted_GetRef();
+	Zone.Volume = Volume;
+	Zone.Bounds = Bounds;
+	Zone.Distance = Distance;
+}
+
+void UCombatPreloadSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceZoneCheck += DeltaTime;
+
+	if (TimeSinceZoneCheck >= CVarPreloadZoneCheckInterval.GetValueOnGameThread())
+	{
+		TimeSinceZoneCheck = 0.0f;
+
+		CheckZones();
+	}
+}
+
+TStatId UCombatPreloadSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatPreloadSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatPreloadSubsystem::Deinitialize()
+{
+	// let the assets unload along with the world
+	for (const TSharedPtr<FStreamableHandle>& Handle : Handles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+
+	Handles.Empty();
+	Zones.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatPreloadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+UObject* UCombatPreloadSubsystem::LoadBlocking(const UObject* WorldContextObject, const FSoftObjectPath& Path)
+{
+	if (Path.IsNull())
+	{
+		return nullptr;
+	}
+
+	// the asset may already be in memory without us holding on to it
+	if (UObject* LoadedAsset = Path.ResolveObject())
+	{
+		return LoadedAsset;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// this also waits for any async load of the asset that's still in flight
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestSyncLoad(Path);
+	UObject* LoadedAsset = Handle.IsValid() ? Handle->GetLoadedAsset() : nullptr;
+
+	const double LoadTime = FPlatformTime::Seconds() - StartTime;
+
+	PANTHERJAM_INC_COUNTER(BlockingLoads, 1);
+	PANTHERJAM_INC_FLOAT_COUNTER(BlockingLoadTime, LoadTime * 1000.0);
+
+	// hold on to the asset so we don't block on it again
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+
+	if (UCombatPreloadSubsystem* Subsystem = World ? World->GetSubsystem<UCombatPreloadSubsystem>() : nullptr)
+	{
+		Subsystem->Handles.Add(Handle);
+
+		++Subsystem->BlockingLoads;
+		Subsystem->BlockingLoadTime += LoadTime;
+	}
+
+	return LoadedAsset;
+}
+
+void UCombatPreloadSubsystem::CheckZones()
+{
+	if (Zones.IsEmpty())
+	{
+		return;
+	}
+
+	UPantherJamPlayerSnapshotSubsystem* PlayerSnapshots = UPantherJamPlayerSnapshotSubsystem::Get(this);
+
+	if (!PlayerSnapshots)
+	{
+		return;
+	}
+
+	for (int32 ZoneIndex = Zones.Num() - 1; ZoneIndex >= 0; --ZoneIndex)
+	{
+		const FCombatPreloadZone& Zone = Zones[ZoneIndex];
+		ACombatActivationVolume* Volume = Zone.Volume.Get();
+
+		if (!Volume)
+		{
+			Zones.RemoveAtSwap(ZoneIndex);
+			continue;
+		}
+
+		// has any player come close enough?
+		const bool bApproached = PlayerSnapshots->GetPlayers().ContainsByPredicate([&Zone](const FPantherJamPlayerSnapshot& Player)
+		{
+			return Player.GetPawn() && Zone.Bounds.ComputeSquaredDistanceToPoint(Player.Location) <= FMath::Square(Zone.Distance);
+		});
+
+		if (bApproached)
+		{
+			Zones.RemoveAtSwap(ZoneIndex);
+
+			Volume->PreloadActivatables();
+		}
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatPreloadSubsystem.generated.h"
+
+class ACombatActivationVolume;
+struct FStreamableHandle;
+
+/**
+ *  An activation volume whose activatables start loading their assets when a player comes close
+ */
+struct FCombatPreloadZone
+{
+	/** Volume to preload for */
+	TWeakObjectPtr<ACombatActivationVolume> Volume;
+
+	/** World bounds of the volume */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Distance from the bounds at which the preload starts */
+	float Distance = 0.0f;
+};
+
+/**
+ *  Loads the soft referenced combat assets, such as enemy classes, attack montages and life bar widgets,
+ *  through the streamable manager ahead of the time they're needed.
+ *  Enemy spawners start loading their enemies when their activation volume is approached or when they're activated,
+ *  and only block if the asset still hasn't arrived at spawn time. Blocking loads are reported under "stat PantherJam".
+ *  Combat.Preload.Async 0 loads everything up front instead, the way hard references would.
+ */
+UCLASS()
+class UCombatPreloadSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Handles for every load started in this world. Keeps the assets loaded until the world goes away */
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+
+	/** Activation volumes waiting for a player to come close */
+	TArray<FCombatPreloadZone> Zones;
+
+	/** Time since the preload zones were last checked */
+	float TimeSinceZoneCheck = 0.0f;
+
+	/** Number of loads that had to block the game thread */
+	int32 BlockingLoads = 0;
+
+	/** Total time spent blocking on loads, in seconds */
+	double BlockingLoadTime = 0.0;
+
+public:
+
+	/** Returns true if assets are loaded asynchronously ahead of time, or false if they're loaded up front */
+	static bool IsAsyncEnabled();
+
+	/** Starts loading the given assets and calls OnLoaded once they're all in. Loads them right away if async loading is disabled */
+	static void RequestPreload(const UObject* WorldContextObject, TArray<FSoftObjectPath> Assets, FSimpleDelegate OnLoaded = FSimpleDelegate());
+
+	/** Preloads the volume's activatables when a player comes within the given distance of it */
+	static void AddPreloadZone(ACombatActivationVolume* Volume, const FBox& Bounds, float Distance);
+
+	/** Returns the asset, blocking until it's loaded if it isn't already */
+	template<typename T>
+	static T* GetOrLoad(const UObject* WorldContextObject, const TSoftObjectPtr<T>& Asset)
+	{
+		if (T* LoadedAsset = Asset.Get())
+		{
+			return LoadedAsset;
+		}
+
+		return Cast<T>(LoadBlocking(WorldContextObject, Asset.ToSoftObjectPath()));
+	}
+
+	/** Returns the class, blocking until it's loaded if it isn't already */
+	template<typename T>
+	static TSubclassOf<T> GetOrLoad(const UObject* WorldContextObject, const TSoftClassPtr<T>& Class)
+	{
+		if (UClass* LoadedClass = Class.Get())
+		{
+			return LoadedClass;
+		}
+
+		return Cast<UClass>(LoadBlocking(WorldContextObject, Class.ToSoftObjectPath()));
+	}
+
+	/** Returns the number of loads that had to block the game thread */
+	int32 GetBlockingLoads() const { return BlockingLoads; }
+
+	/** Returns the total time spent blocking on loads, in milliseconds */
+	float GetBlockingLoadTimeMs() const { return float(BlockingLoadTime * 1000.0); }
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Loads an asset that's needed right now, blocking the game thread */
+	static UObject* LoadBlocking(const UObject* WorldContextObject, const FSoftObjectPath& Path);
+
+	/** Starts the preloads for any zones a player has come close to */
+	void CheckZones();
+};
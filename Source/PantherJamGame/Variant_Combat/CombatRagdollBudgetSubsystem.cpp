@@ -0,0 +1,325 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatRagdollBudgetSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/World.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
+
+static TAutoConsoleVariable<int32> CVarRagdollMaxSimulatedBodies(
+	TEXT("Combat.Ragdoll.MaxSimulatedBodies"),
+	256,
+	TEXT("Max number of skeletal physics bodies combat ragdolls and hit reactions may simulate at the same time. 0 or less disables the budget."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRagdollHitReactionTimeout(
+	TEXT("Combat.Ragdoll.HitReactionTimeout"),
+	2.0f,
+	TEXT("Time after which a partial ragdoll hit reaction is ended even if the character hasn't landed, in seconds."),
+	ECVF_Default);
+
+void UCombatRagdollBudgetSubsystem::StartHitReaction(USkeletalMeshComponent* Mesh, FName PelvisBoneName, UAnimMontage* FallbackMontage)
+{
+	if (!Mesh)
+	{
+		return;
+	}
+
+	UCombatRagdollBudgetSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatRagdollBudgetSubsystem>();
+	const int32 MaxBodies = CVarRagdollMaxSimulatedBodies.GetValueOnGameThread();
+
+	// meshes already simulating keep their bodies, everyone else needs room in the budget
+	const bool bHasBudget = !Subsystem
+		|| MaxBodies <= 0
+		|| Subsystem->FindRagdoll(Mesh) != INDEX_NONE
+		|| Subsystem->SimulatedBodies + Mesh->Bodies.Num() <= MaxBodies;
+
+	if (bHasBudget)
+	{
+		// enable partial ragdoll physics, but keep the pelvis vertical
+		Mesh->SetPhysicsBlendWeight(0.5f);
+		Mesh->SetBodySimulatePhysics(PelvisBoneName, false);
+
+		if (Subsystem)
+		{
+			Subsystem->TrackRagdoll(Mesh, false);
+		}
+
+		return;
+	}
+
+	PANTHERJAM_INC_COUNTER(DegradedHitReactions, 1);
+
+	// fall back to the additive hit reaction. Nobody would see it on a dedicated server
+	if (FallbackMontage && FPantherJamPresentation::IsEnabled(Mesh))
+	{
+		if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+		{
+			AnimInstance->Montage_Play(FallbackMontage);
+		}
+	}
+}
+
+void UCombatRagdollBudgetSubsystem::EndHitReaction(USkeletalMeshComponent* Mesh)
+{
+	if (!Mesh)
+	{
+		return;
+	}
+
+	if (UCombatRagdollBudgetSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatRagdollBudgetSubsystem>())
+	{
+		const int32 RagdollIndex = Subsystem->FindRagdoll(Mesh);
+
+		// death ragdolls are only stopped through StopRagdoll
+		if (RagdollIndex != INDEX_NONE && Subsystem->Ragdolls[RagdollIndex].bFullRagdoll)
+		{
+			return;
+		}
+
+		if (RagdollIndex != INDEX_NONE)
+		{
+			Subsystem->SimulatedBodies -= Subsystem->Ragdolls[RagdollIndex].NumBodies;
+			Subsystem->Ragdolls.RemoveAt(RagdollIndex);
+		}
+	}
+
+	// disable ragdoll physics
+	Mesh->SetPhysicsBlendWeight(0.0f);
+}
+
+void UCombatRagdollBudgetSubsystem::StartRagdoll(USkeletalMeshComponent* Mesh)
+{
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// enable full ragdoll physics
+	Mesh->SetSimulatePhysics(true);
+
+	if (UCombatRagdollBudgetSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatRagdollBudgetSubsystem>())
+	{
+		Subsystem->TrackRagdoll(Mesh, true);
+		Subsystem->EnforceBudget();
+	}
+}
+
+void UCombatRagdollBudgetSubsystem::StopRagdoll(USkeletalMeshComponent* Mesh)
+{
+	if (!Mesh)
+	{
+		return;
+	}
+
+	if (UCombatRagdollBudgetSubsystem* Subsystem = Mesh->GetWorld()->GetSubsystem<UCombatRagdollBudgetSubsystem>())
+	{
+		const int32 RagdollIndex = Subsystem->FindRagdoll(Mesh);
+
+		if (RagdollIndex != INDEX_NONE)
+		{
+			Subsystem->SimulatedBodies -= Subsystem->Ragdolls[RagdollIndex].NumBodies;
+			Subsystem->Ragdolls.RemoveAt(RagdollIndex);
+		}
+	}
+
+	// let animation drive the pose again in case the ragdoll was frozen
+	Mesh->bNoSkeletonUpdate = false;
+	Mesh->bPauseAnims = false;
+
+	// stop ragdolling
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetPhysicsBlendWeight(0.0f);
+}
+
+void UCombatRagdollBudgetSubsystem::Tick(float DeltaTime)
+{
+	UpdateSimulatedBodies();
+
+	// the budget may have been lowered since the last ragdoll started
+	EnforceBudget();
+
+	int32 FrozenRagdolls = 0;
+
+	for (const FCombatRagdoll& Ragdoll : Ragdolls)
+	{
+		FrozenRagdolls += Ragdoll.bFrozen ? 1 : 0;
+	}
+
+	PANTHERJAM_INC_COUNTER(RagdollBodies, SimulatedBodies);
+	PANTHERJAM_INC_COUNTER(FrozenRagdolls, FrozenRagdolls);
+}
+
+TStatId UCombatRagdollBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatRagdollBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatRagdollBudgetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// time the physics step for the stats
+	if (FPhysScene* PhysScene = InWorld.GetPhysicsScene())
+	{
+		PhysicsPreTickHandle = PhysScene->OnPhysScenePreTick.AddUObject(this, &UCombatRagdollBudgetSubsystem::OnPhysicsPreTick);
+		PhysicsPostTickHandle = PhysScene->OnPhysScenePostTick.AddUObject(this, &UCombatRagdollBudgetSubsystem::OnPhysicsPostTick);
+	}
+}
+
+void UCombatRagdollBudgetSubsystem::Deinitialize()
+{
+	if (FPhysScene* PhysScene = GetWorld()->GetPhysicsScene())
+	{
+		PhysScene->OnPhysScenePreTick.Remove(PhysicsPreTickHandle);
+		PhysScene->OnPhysScenePostTick.Remove(PhysicsPostTickHandle);
+	}
+
+	Ragdolls.Empty();
+	SimulatedBodies = 0;
+
+	Super::Deinitialize();
+}
+
+bool UCombatRagdollBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCombatRagdollBudgetSubsystem::FindRagdoll(const USkeletalMeshComponent* Mesh) const
+{
+	return Ragdolls.IndexOfByPredicate([Mesh](const FCombatRagdoll& Ragdoll) { return Ragdoll.Mesh.Get() == Mesh; });
+}
+
+FCombatRagdoll& UCombatRagdollBudgetSubsystem::TrackRagdoll(USkeletalMeshComponent* Mesh, bool bFullRagdoll)
+{
+	const int32 RagdollIndex = FindRagdoll(Mesh);
+
+	if (RagdollIndex != INDEX_NONE)
+	{
+		// hit reactions that turn into deaths count as new ragdolls, so they aren't the first to be frozen
+		if (!bFullRagdoll || Ragdolls[RagdollIndex].bFullRagdoll)
+		{
+			return Ragdolls[RagdollIndex];
+		}
+
+		SimulatedBodies -= Ragdolls[RagdollIndex].NumBodies;
+		Ragdolls.RemoveAt(RagdollIndex);
+	}
+
+	FCombatRagdoll& Ragdoll = Ragdolls.AddDefaulted_GetRef();
+	Ragdoll.Mesh = Mesh;
+	Ragdoll.NumBodies = Mesh->Bodies.Num();
+	Ragdoll.StartTime = GetWorld()->GetTimeSeconds();
+	Ragdoll.bFullRagdoll = bFullRagdoll;
+
+	SimulatedBodies += Ragdoll.NumBodies;
+
+	return Ragdoll;
+}
+
+void UCombatRagdollBudgetSubsystem::EnforceBudget()
+{
+	const int32 MaxBodies = CVarRagdollMaxSimulatedBodies.GetValueOnGameThread();
+
+	if (MaxBodies <= 0)
+	{
+		return;
+	}
+
+	// free the oldest bodies first, but always let the newest ragdoll fall
+	for (int32 RagdollIndex = 0; SimulatedBodies > MaxBodies && RagdollIndex < Ragdolls.Num() - 1;)
+	{
+		FCombatRagdoll& Ragdoll = Ragdolls[RagdollIndex];
+
+		if (Ragdoll.bFrozen)
+		{
+			++RagdollIndex;
+		}
+		else if (Ragdoll.bFullRagdoll)
+		{
+			FreezeRagdoll(Ragdoll);
+			++RagdollIndex;
+		}
+		else
+		{
+			// end the hit reaction early
+			if (USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get())
+			{
+				Mesh->SetPhysicsBlendWeight(0.0f);
+			}
+
+			SimulatedBodies -= Ragdoll.NumBodies;
+			Ragdolls.RemoveAt(RagdollIndex);
+		}
+	}
+}
+
+void UCombatRagdollBudgetSubsystem::FreezeRagdoll(FCombatRagdoll& Ragdoll)
+{
+	if (USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get())
+	{
+		// keep the last simulated pose instead of going back to animation
+		Mesh->bNoSkeletonUpdate = true;
+		Mesh->bPauseAnims = true;
+
+		// the bodies become kinematic and stop costing simulation time
+		Mesh->SetSimulatePhysics(false);
+	}
+
+	SimulatedBodies -= Ragdoll.NumBodies;
+	Ragdoll.NumBodies = 0;
+	Ragdoll.bFrozen = true;
+}
+
+void UCombatRagdollBudgetSubsystem::UpdateSimulatedBodies()
+{
+	const double HitReactionTimeout = CVarRagdollHitReactionTimeout.GetValueOnGameThread();
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	SimulatedBodies = 0;
+
+	for (int32 RagdollIndex = Ragdolls.Num() - 1; RagdollIndex >= 0; --RagdollIndex)
+	{
+		FCombatRagdoll& Ragdoll = Ragdolls[RagdollIndex];
+		USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+
+		// drop destroyed meshes, and meshes whose physics were switched off behind our back
+		if (!Mesh || (!Ragdoll.bFrozen && !Mesh->IsAnySimulatingPhysics()))
+		{
+			Ragdolls.RemoveAt(RagdollIndex);
+			continue;
+		}
+
+		// end hit reactions that never landed
+		if (!Ragdoll.bFullRagdoll && CurrentTime - Ragdoll.StartTime > HitReactionTimeout)
+		{
+			Mesh->SetPhysicsBlendWeight(0.0f);
+			Ragdolls.RemoveAt(RagdollIndex);
+			continue;
+		}
+
+		SimulatedBodies += Ragdoll.NumBodies;
+	}
+}
+
+void UCombatRagdollBudgetSubsystem::OnPhysicsPreTick(FPhysScene* PhysScene, float DeltaTime)
+{
+	PhysicsStepStartTime = FPlatformTime::Seconds();
+}
+
+void UCombatRagdollBudgetSubsystem::OnPhysicsPostTick(FPhysScene* PhysScene)
+{
+	if (PhysicsStepStartTime > 0.0)
+	{
+		PANTHERJAM_INC_FLOAT_COUNTER(PhysicsStep, (FPlatformTime::Seconds() - PhysicsStepStartTime) * 1000.0);
+	}
+
+	PhysicsStepStartTime = 0.0;
+}
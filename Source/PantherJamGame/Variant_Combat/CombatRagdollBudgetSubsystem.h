@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Physics/PhysicsInterfaceDeclares.h"
+#include "CombatRagdollBudgetSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+class UAnimMontage;
+
+/**
+ *  A skeletal mesh simulating physics under the ragdoll budget
+ */
+struct FCombatRagdoll
+{
+	/** Simulating mesh */
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+	/** Number of physics bodies the mesh simulates */
+	int32 NumBodies = 0;
+
+	/** World time the mesh started simulating */
+	double StartTime = 0.0;
+
+	/** If true, this is a full death ragdoll. Otherwise it's a partial hit reaction */
+	bool bFullRagdoll = false;
+
+	/** If true, the ragdoll has been frozen into a kinematic snapshot of its last pose */
+	bool bFrozen = false;
+};
+
+/**
+ *  Caps the number of skeletal physics bodies combat characters simulate at the same time.
+ *  Death ragdolls always start, freezing the oldest ragdolls into kinematic snapshots of their last pose to stay under budget.
+ *  Partial ragdoll hit reactions only start if there's room, otherwise they degrade to an additive hit reaction montage.
+ *  Active and frozen bodies and the physics step time are reported under "stat PantherJam".
+ *  The budget is set with Combat.Ragdoll.MaxSimulatedBodies.
+ */
+UCLASS()
+class UCombatRagdollBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Tracked meshes, oldest first */
+	TArray<FCombatRagdoll> Ragdolls;
+
+	/** Number of bodies currently simulating across all tracked meshes */
+	int32 SimulatedBodies = 0;
+
+	/** Platform time at the start of this frame's physics step */
+	double PhysicsStepStartTime = 0.0;
+
+	/** Physics scene delegate handles */
+	FDelegateHandle PhysicsPreTickHandle;
+	FDelegateHandle PhysicsPostTickHandle;
+
+public:
+
+	/** Starts a partial ragdoll hit reaction on the mesh if the budget allows, or plays the additive fallback montage instead */
+	static void StartHitReaction(USkeletalMeshComponent* Mesh, FName PelvisBoneName, UAnimMontage* FallbackMontage);
+
+	/** Ends a partial ragdoll hit reaction on the mesh */
+	static void EndHitReaction(USkeletalMeshComponent* Mesh);
+
+	/** Starts a full death ragdoll on the mesh, freezing older ragdolls if over budget */
+	static void StartRagdoll(USkeletalMeshComponent* Mesh);
+
+	/** Stops any ragdoll on the mesh and hands it back to animation */
+	static void StopRagdoll(USkeletalMeshComponent* Mesh);
+
+	/** Returns the number of bodies currently simulating under the budget */
+	int32 GetSimulatedBodies() const { return SimulatedBodies; }
+
+	// ~begin UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the index of the tracked entry for the mesh, or INDEX_NONE */
+	int32 FindRagdoll(const USkeletalMeshComponent* Mesh) const;
+
+	/** Starts tracking a mesh, or updates its entry if it's already tracked */
+	FCombatRagdoll& TrackRagdoll(USkeletalMeshComponent* Mesh, bool bFullRagdoll);
+
+	/** Frees bodies, oldest first, until the budget is met */
+	void EnforceBudget();
+
+	/** Freezes a death ragdoll into a kinematic snapshot of its current pose */
+	void FreezeRagdoll(FCombatRagdoll& Ragdoll);
+
+	/** Recounts the simulating bodies, dropping stale entries */
+	void UpdateSimulatedBodies();
+
+	/** Called when the physics scene starts stepping */
+	void OnPhysicsPreTick(FPhysScene* PhysScene, float DeltaTime);
+
+	/** Called when the physics scene is done stepping */
+	void OnPhysicsPostTick(FPhysScene* PhysScene);
+};
@@ -12,6 +12,9 @@
 #include "EnhancedInputComponent.h"
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
+#include "PantherJamInputRecordingSubsystem.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
 
 APlatformingCharacter::APlatformingCharacter()
 {
@@ -102,6 +105,8 @@ void APlatformingCharacter::Dash()
 
 void APlatformingCharacter::MultiJump()
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(MultiJump);
+
 	// ignore jumps while dashing
 	if(bIsDashing)
 		return;
@@ -123,6 +128,8 @@ void APlatformingCharacter::MultiJump()
 			FCollisionQueryParams QueryParams;
 			QueryParams.AddIgnoredActor(this);
 
+			PANTHERJAM_INC_COUNTER(Traces, 1);
+
 			if (GetWorld()->SweepSingleByChannel(OutHit, TraceStart, TraceEnd, FQuat(), ECollisionChannel::ECC_Visibility, TraceShape, QueryParams))
 			{
 				// rotate the character to face away from the wall, so we're correctly oriented for the next wall jump
@@ -181,6 +188,8 @@ void APlatformingCharacter::ResetWallJump()
 
 void APlatformingCharacter::DoMove(float Right, float Forward)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Move, FVector2f(Right, Forward));
+
 	if (GetController() != nullptr)
 	{
 		// momentarily disable movement inputs if we've just wall jumped
@@ -205,6 +214,8 @@ void APlatformingCharacter::DoMove(float Right, float Forward)
 
 void APlatformingCharacter::DoLook(float Yaw, float Pitch)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Look, FVector2f(Yaw, Pitch));
+
 	if (GetController() != nullptr)
 	{
 		// add yaw and pitch input to controller
@@ -215,6 +226,8 @@ void APlatformingCharacter::DoLook(float Yaw, float Pitch)
 
 void APlatformingCharacter::DoDash()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Dash);
+
 	// ignore the input if we've already dashed and have yet to reset
 	if (bHasDashed)
 		return;
@@ -247,16 +260,49 @@ void APlatformingCharacter::DoDash()
 
 void APlatformingCharacter::DoJumpStart()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::JumpStart);
+
 	// handle special jump cases
 	MultiJump();
 }
 
 void APlatformingCharacter::DoJumpEnd()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::JumpEnd);
+
 	// stop jumping
 	StopJumping();
 }
 
+void APlatformingCharacter::ReplayInput(EPantherJamInputAction Action, const FVector2f& Value)
+{
+	switch (Action)
+	{
+	case EPantherJamInputAction::Move:
+		DoMove(Value.X, Value.Y);
+		break;
+
+	case EPantherJamInputAction::Look:
+		DoLook(Value.X, Value.Y);
+		break;
+
+	case EPantherJamInputAction::Dash:
+		DoDash();
+		break;
+
+	case EPantherJamInputAction::JumpStart:
+		DoJumpStart();
+		break;
+
+	case EPantherJamInputAction::JumpEnd:
+		DoJumpEnd();
+		break;
+
+	default:
+		break;
+	}
+}
+
 void APlatformingCharacter::DashMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
 	// if the montage was interrupted, end the dash
@@ -295,6 +341,18 @@ bool APlatformingCharacter::HasWallJumped() const
 	return bHasWallJumped;
 }
 
+void APlatformingCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// nobody is watching on a dedicated server, so switch off the camera
+	if (!FPantherJamPresentation::IsEnabled(this))
+	{
+		FPantherJamPresentation::DisableComponent(CameraBoom);
+		FPantherJamPresentation::DisableComponent(FollowCamera);
+	}
+}
+
 void APlatformingCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Animation/AnimInstance.h"
+#include "PantherJamInputReplayable.h"
 #include "PlatformingCharacter.generated.h"
 
 
@@ -23,7 +24,7 @@ class UAnimMontage;
  *  - Dash
  */
 UCLASS(abstract)
-class APlatformingCharacter : public ACharacter
+class APlatformingCharacter : public ACharacter, public IPantherJamInputReplayable
 {
 	GENERATED_BODY()
 
@@ -101,6 +102,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Input")
 	virtual void DoJumpEnd();
 
+	// ~begin IPantherJamInputReplayable interface
+
+	/** Performs a recorded input through the Do* entry points */
+	virtual void ReplayInput(EPantherJamInputAction Action, const FVector2f& Value) override;
+
+	// ~end IPantherJamInputReplayable interface
+
 protected:
 
 	/** Called from a delegate when the dash montage ends */
@@ -126,6 +134,9 @@ public:
 	bool HasWallJumped() const;
 
 public:	
+
+	/** BeginPlay initialization */
+	virtual void BeginPlay() override;
 	
 	/** EndPlay cleanup */
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
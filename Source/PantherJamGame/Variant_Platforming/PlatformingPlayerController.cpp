@@ -9,6 +9,7 @@
 #include "PlatformingCharacter.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
+#include "PantherJamStats.h"
 
 void APlatformingPlayerController::SetupInputComponent()
 {
@@ -41,6 +42,8 @@ void APlatformingPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 		// spawn a character at the player start
 		const FTransform SpawnTransform = ActorList[0]->GetActorTransform();
 
+		PANTHERJAM_INC_COUNTER(Spawns, 1);
+
 		if (APlatformingCharacter* RespawnedCharacter = GetWorld()->SpawnActor<APlatformingCharacter>(CharacterClass, SpawnTransform))
 		{
 			// possess the character
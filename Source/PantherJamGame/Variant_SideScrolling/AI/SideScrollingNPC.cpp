@@ -4,6 +4,7 @@
 #include "SideScrollingNPC.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "PantherJamAILODSubsystem.h"
 
 ASideScrollingNPC::ASideScrollingNPC()
 {
@@ -12,12 +13,29 @@ ASideScrollingNPC::ASideScrollingNPC()
 	GetCharacterMovement()->MaxWalkSpeed = 150.0f;
 }
 
+void ASideScrollingNPC::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// let the AI LOD manage our tick rate
+	if (UPantherJamAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UPantherJamAILODSubsystem>())
+	{
+		AILOD->RegisterAgent(this);
+	}
+}
+
 void ASideScrollingNPC::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
 	// clear the deactivation timer
 	GetWorld()->GetTimerManager().ClearTimer(DeactivationTimer);
+
+	// stop managing our tick rate
+	if (UPantherJamAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UPantherJamAILODSubsystem>())
+	{
+		AILOD->UnregisterAgent(this);
+	}
 }
 
 void ASideScrollingNPC::Interaction(AActor* Interactor)
@@ -5,20 +5,49 @@
 #include "StateTreeExecutionContext.h"
 #include "StateTreeExecutionTypes.h"
 #include "AIController.h"
-#include "Kismet/GameplayStatics.h"
+#include "PantherJamPlayerSnapshotSubsystem.h"
+#include "PantherJamStats.h"
 
 EStateTreeRunStatus FStateTreeGetPlayerTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(StateTreeTask);
+
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+	// are we waiting for a reduced rate update?
+	InstanceData.TimeUntilUpdate -= DeltaTime;
+
+	if (InstanceData.TimeUntilUpdate > 0.0f || !IsValid(InstanceData.NPC))
+	{
+		return EStateTreeRunStatus::Running;
+	}
+
+	const FVector NPCLocation = InstanceData.NPC->GetActorLocation();
+
+	// get the target player from this frame's player snapshot
+	const FPantherJamPlayerSnapshot* TargetPlayer = nullptr;
+
+	if (UPantherJamPlayerSnapshotSubsystem* PlayerSnapshots = UPantherJamPlayerSnapshotSubsystem::Get(InstanceData.NPC))
+	{
+		TargetPlayer = InstanceData.bTargetClosestPlayer ? PlayerSnapshots->FindClosestPlayer(NPCLocation) : PlayerSnapshots->GetPlayer(InstanceData.PlayerIndex);
+	}
+
 	// set the player pawn as the target
-	InstanceData.TargetPlayer = UGameplayStatics::GetPlayerPawn(InstanceData.Controller.Get(), 0);
+	InstanceData.TargetPlayer = TargetPlayer ? TargetPlayer->GetPawn() : nullptr;
 
-	// are the NPC and target valid?
-	if (IsValid(InstanceData.TargetPlayer) && IsValid(InstanceData.NPC))
+	// is the target valid?
+	if (TargetPlayer)
 	{
-		InstanceData.bValidTarget = FVector::Distance(InstanceData.NPC->GetActorLocation(), InstanceData.TargetPlayer->GetActorLocation()) < InstanceData.RangeMax;
+		const float DistanceToTarget = FVector::Distance(NPCLocation, TargetPlayer->Location);
+
+		InstanceData.bValidTarget = DistanceToTarget < InstanceData.RangeMax;
+
+		// update at a reduced rate while the target is far away
+		if (InstanceData.ReducedUpdateDistance > 0.0f && DistanceToTarget > InstanceData.ReducedUpdateDistance)
+		{
+			InstanceData.TimeUntilUpdate = InstanceData.ReducedUpdateInterval;
+		}
 	}
 
 	return EStateTreeRunStatus::Running;
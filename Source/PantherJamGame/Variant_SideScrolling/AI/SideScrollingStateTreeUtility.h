@@ -36,6 +36,25 @@ struct FStateTreeGetPlayerInstanceData
 	/** Max distance to be considered a valid target */
 	UPROPERTY(EditAnywhere, Category = Parameter, meta=(ClampMin = 0, Units = "cm"))
 	float RangeMax = 1000.0f;
+
+	/** Index of the player to target. Ignored when targeting the closest player */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0))
+	int32 PlayerIndex = 0;
+
+	/** If true, the closest player is targeted instead of a fixed player index */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	bool bTargetClosestPlayer = false;
+
+	/** Beyond this distance from the target, the task only updates every ReducedUpdateInterval. Zero updates every tick */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "cm"))
+	float ReducedUpdateDistance = 0.0f;
+
+	/** Time between updates while beyond ReducedUpdateDistance */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "s"))
+	float ReducedUpdateInterval = 0.25f;
+
+	/** Time left until the next update */
+	float TimeUntilUpdate = 0.0f;
 };
 
 /**
@@ -3,6 +3,7 @@
 
 #include "SideScrollingMovingPlatform.h"
 #include "Components/SceneComponent.h"
+#include "SideScrollingFloorProfileSubsystem.h"
 
 ASideScrollingMovingPlatform::ASideScrollingMovingPlatform()
 {
@@ -12,6 +13,14 @@ ASideScrollingMovingPlatform::ASideScrollingMovingPlatform()
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 }
 
+void ASideScrollingMovingPlatform::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// keep the camera's floor profile up to date as we move
+	USideScrollingFloorProfileSubsystem::RegisterDynamicFloor(this);
+}
+
 void ASideScrollingMovingPlatform::Interaction(AActor* Interactor)
 {
 	// ignore interactions if we're already moving
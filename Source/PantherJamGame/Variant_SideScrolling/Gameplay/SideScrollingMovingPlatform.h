@@ -38,6 +38,11 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Moving Platform")
 	bool bOneShot = false;
 
+protected:
+
+	/** Registers the platform with the floor height profile */
+	virtual void BeginPlay() override;
+
 public:
 
 // ~begin IInteractable interface 
@@ -4,9 +4,18 @@
 #include "SideScrollingPickup.h"
 #include "GameFramework/Character.h"
 #include "SideScrollingGameMode.h"
+#include "SideScrollingPickupFieldSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/SceneComponent.h"
+#include "Components/StaticMeshComponent.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarPickupFieldConvertAll(
+	TEXT("SideScrolling.PickupField.ConvertAll"),
+	false,
+	TEXT("If true, every side scrolling pickup moves into the pickup field on BeginPlay, not only the ones marked with bAddToPickupField."),
+	ECVF_Default);
 
 ASideScrollingPickup::ASideScrollingPickup()
 {
@@ -30,6 +39,23 @@ ASideScrollingPickup::ASideScrollingPickup()
 	OnActorBeginOverlap.AddDynamic(this, &ASideScrollingPickup::BeginOverlap);
 }
 
+void ASideScrollingPickup::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bAddToPickupField || CVarPickupFieldConvertAll.GetValueOnGameThread())
+	{
+		// the field draws the pickup with the mesh added by the Blueprint
+		const UStaticMeshComponent* Mesh = FindComponentByClass<UStaticMeshComponent>();
+
+		// stay an actor if the field can't take us
+		if (USideScrollingPickupFieldSubsystem::AddPickup(this, Sphere->GetComponentLocation(), Sphere->GetScaledSphereRadius(), Mesh))
+		{
+			Destroy();
+		}
+	}
+}
+
 void ASideScrollingPickup::BeginOverlap(AActor* OverlappedActor, AActor* OtherActor)
 {
 	// have we collided against a character?
@@ -11,6 +11,8 @@ class USphereComponent;
 /**
  *  A simple side scrolling game pickup
  *  Increments a counter on the GameMode
+ *  Pickups marked with bAddToPickupField are moved into the pickup field on BeginPlay, so large numbers of them
+ *  don't each need an actor and a collision body
  */
 UCLASS(abstract)
 class ASideScrollingPickup : public AActor
@@ -21,13 +23,25 @@ class ASideScrollingPickup : public AActor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Components", meta = (AllowPrivateAccess = "true"))
 	USphereComponent* Sphere;
 
+protected:
+
+	/** If true, this pickup is replaced by an instance in the pickup field when play begins. Field pickups don't call BP_OnPickedUp */
+	UPROPERTY(EditAnywhere, Category="Pickup")
+	bool bAddToPickupField = false;
+
 public:
 
 	/** Constructor */
 	ASideScrollingPickup();
 
+	/** Sets whether this pickup moves into the pickup field. Only has an effect before BeginPlay */
+	void SetAddToPickupField(bool bEnabled) { bAddToPickupField = bEnabled; }
+
 protected:
 
+	/** Moves the pickup into the pickup field if requested */
+	virtual void BeginPlay() override;
+
 	/** Handles pickup collision */
 	UFUNCTION()
 	void BeginOverlap(AActor* OverlappedActor, AActor* OtherActor);
@@ -0,0 +1,261 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingPickupFieldSubsystem.h"
+#include "SideScrollingGameMode.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
+
+static TAutoConsoleVariable<float> CVarPickupFieldCellSize(
+	TEXT("SideScrolling.PickupField.CellSize"),
+	400.0f,
+	TEXT("Size of each pickup field spatial hash cell, in cm. Applies to fields created after the change."),
+	ECVF_Default);
+
+bool USideScrollingPickupFieldSubsystem::AddPickup(const UObject* WorldContextObject, const FVector& Location, float Radius, const UStaticMeshComponent* Mesh)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	USideScrollingPickupFieldSubsystem* Subsystem = World ? World->GetSubsystem<USideScrollingPickupFieldSubsystem>() : nullptr;
+
+	if (!Subsystem || !Mesh || !Mesh->GetStaticMesh())
+	{
+		return false;
+	}
+
+	// the hash can't be resized once it holds pickups
+	if (Subsystem->Pickups.IsEmpty())
+	{
+		Subsystem->CellSize = FMath::Max(CVarPickupFieldCellSize.GetValueOnGameThread(), 1.0f);
+	}
+
+	FSideScrollingFieldPickup& Pickup = Subsystem->Pickups.AddDefaulted_GetRef();
+	Pickup.Location = Location;
+	Pickup.Radius = Radius;
+
+	// nobody sees the pickups on a dedicated server, so only collect them there
+	if (FPantherJamPresentation::IsEnabled(Subsystem))
+	{
+		if (UHierarchicalInstancedStaticMeshComponent* Instances = Subsystem->GetInstancedMesh(Mesh))
+		{
+			Pickup.Instances = Instances;
+			Pickup.InstanceIndex = Instances->AddInstance(Mesh->GetComponentTransform(), true);
+		}
+	}
+
+	Subsystem->Cells.FindOrAdd(Subsystem->GetCell(Location)).Add(Subsystem->Pickups.Num() - 1);
+	Subsystem->MaxRadius = FMath::Max(Subsystem->MaxRadius, Radius);
+	++Subsystem->NumRemaining;
+
+	return true;
+}
+
+void USideScrollingPickupFieldSubsystem::Tick(float DeltaTime)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(PickupField);
+
+	if (NumRemaining == 0)
+	{
+		return;
+	}
+
+	// one query per player character
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const ACharacter* Character = It->IsValid() ? Cast<ACharacter>((*It)->GetPawn()) : nullptr;
+
+		if (!Character)
+		{
+			continue;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+
+		QueryCapsule(Capsule->GetComponentLocation(), Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight());
+	}
+}
+
+TStatId USideScrollingPickupFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USideScrollingPickupFieldSubsystem, STATGROUP_Tickables);
+}
+
+void USideScrollingPickupFieldSubsystem::Deinitialize()
+{
+	Pickups.Empty();
+	Cells.Empty();
+	InstancedMeshes.Empty();
+
+	FieldActor = nullptr;
+	NumRemaining = 0;
+
+	Super::Deinitialize();
+}
+
+bool USideScrollingPickupFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FIntVector USideScrollingPickupFieldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+UHierarchicalInstancedStaticMeshComponent* USideScrollingPickupFieldSubsystem::GetInstancedMesh(const UStaticMeshComponent* Mesh)
+{
+	UStaticMesh* StaticMesh = Mesh->GetStaticMesh();
+
+	if (const TObjectPtr<UHierarchicalInstancedStaticMeshComponent>* Found = InstancedMeshes.Find(StaticMesh))
+	{
+		return *Found;
+	}
+
+	// the instanced meshes need an actor to live in
+	if (!FieldActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		FieldActor = GetWorld()->SpawnActor<AActor>(SpawnParams);
+
+		if (!FieldActor)
+		{
+			return nullptr;
+		}
+	}
+
+	// draw with the same mesh and materials as the pickup, without any collision
+	UHierarchicalInstancedStaticMeshComponent* Instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(FieldActor);
+
+	if (USceneComponent* Root = FieldActor->GetRootComponent())
+	{
+		Instances->SetupAttachment(Root);
+
+	} else {
+
+		FieldActor->SetRootComponent(Instances);
+	}
+
+	Instances->SetStaticMesh(StaticMesh);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCastShadow(Mesh->CastShadow);
+
+	for (int32 MaterialIndex = 0; MaterialIndex < Mesh->GetNumMaterials(); ++MaterialIndex)
+	{
+		Instances->SetMaterial(MaterialIndex, Mesh->GetMaterial(MaterialIndex));
+	}
+
+	Instances->RegisterComponent();
+
+	InstancedMeshes.Add(StaticMesh, Instances);
+
+	return Instances;
+}
+
+void USideScrollingPickupFieldSubsystem::QueryCapsule(const FVector& Center, float Radius, float HalfHeight)
+{
+	// only look at the cells any pickup touching the capsule could be in
+	const FVector Extent(Radius + MaxRadius, Radius + MaxRadius, HalfHeight + MaxRadius);
+	const FIntVector MinCell = GetCell(Center - Extent);
+	const FIntVector MaxCell = GetCell(Center + Extent);
+
+	// the capsule is the set of points within Radius of its axis
+	const FVector AxisOffset(0.0f, 0.0f, FMath::Max(HalfHeight - Radius, 0.0f));
+	const FVector AxisStart = Center - AxisOffset;
+	const FVector AxisEnd = Center + AxisOffset;
+
+	TArray<int32, TInlineAllocator<8>> Touching;
+	int32 Candidates = 0;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32, TInlineAllocator<4>>* Cell = Cells.Find(FIntVector(X, Y, Z));
+
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (const int32 Index : *Cell)
+				{
+					const FSideScrollingFieldPickup& Pickup = Pickups[Index];
+
+					++Candidates;
+
+					if (FMath::PointDistToSegmentSquared(Pickup.Location, AxisStart, AxisEnd) <= FMath::Square(Radius + Pickup.Radius))
+					{
+						Touching.Add(Index);
+					}
+				}
+			}
+		}
+	}
+
+	PANTHERJAM_INC_COUNTER(PickupFieldCandidates, Candidates);
+
+	// collect after the search, since collecting edits the cells
+	for (const int32 Index : Touching)
+	{
+		CollectPickup(Index);
+	}
+}
+
+void USideScrollingPickupFieldSubsystem::CollectPickup(int32 Index)
+{
+	// like actor pickups, only the side scrolling game mode collects
+	ASideScrollingGameMode* GM = Cast<ASideScrollingGameMode>(GetWorld()->GetAuthGameMode());
+
+	if (!GM)
+	{
+		return;
+	}
+
+	FSideScrollingFieldPickup& Pickup = Pickups[Index];
+
+	if (Pickup.bCollected)
+	{
+		return;
+	}
+
+	Pickup.bCollected = true;
+	--NumRemaining;
+
+	// take it out of the hash so it isn't queried again
+	const FIntVector CellKey = GetCell(Pickup.Location);
+
+	if (TArray<int32, TInlineAllocator<4>>* Cell = Cells.Find(CellKey))
+	{
+		Cell->RemoveSingleSwap(Index);
+
+		if (Cell->IsEmpty())
+		{
+			Cells.Remove(CellKey);
+		}
+	}
+
+	// hide the instance instead of removing it, so the other instance indices stay valid.
+	// Marking it dirty through the update only sends the changed instance to the renderer
+	if (UHierarchicalInstancedStaticMeshComponent* Instances = Pickup.Instances.Get())
+	{
+		Instances->UpdateInstanceTransform(Pickup.InstanceIndex, FTransform(FQuat::Identity, Pickup.Location, FVector::ZeroVector), true, true);
+	}
+
+	GM->ProcessPickup();
+
+	OnPickupCollected.Broadcast(Pickup.Location);
+}
@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SideScrollingPickupFieldSubsystem.generated.h"
+
+class UStaticMesh;
+class UStaticMeshComponent;
+class UHierarchicalInstancedStaticMeshComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSideScrollingFieldPickupCollected, FVector, Location);
+
+/**
+ *  A pickup stored in the field
+ */
+struct FSideScrollingFieldPickup
+{
+	/** Center of the pickup's collection sphere */
+	FVector Location = FVector::ZeroVector;
+
+	/** Radius of the collection sphere */
+	float Radius = 0.0f;
+
+	/** Instanced mesh drawing the pickup */
+	TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent> Instances;
+
+	/** Index of the pickup's instance */
+	int32 InstanceIndex = INDEX_NONE;
+
+	/** If true, the pickup has been collected */
+	bool bCollected = false;
+};
+
+/**
+ *  Holds large numbers of side scrolling pickups without an actor, collision body or overlap per pickup.
+ *  Pickups are stored in a spatial hash and drawn through one hierarchical instanced static mesh per pickup mesh.
+ *  Each frame, every player character does one query against the hash, and collected pickups go through
+ *  ASideScrollingGameMode::ProcessPickup like actor pickups do.
+ *  Placed ASideScrollingPickup actors marked with bAddToPickupField convert themselves into the field on BeginPlay.
+ *  Field pickups don't run BP_OnPickedUp. Bind OnPickupCollected to play their effects instead.
+ */
+UCLASS()
+class USideScrollingPickupFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Called when a player collects a field pickup */
+	UPROPERTY(BlueprintAssignable, Category="Pickup")
+	FOnSideScrollingFieldPickupCollected OnPickupCollected;
+
+protected:
+
+	/** Every pickup added to the field */
+	TArray<FSideScrollingFieldPickup> Pickups;
+
+	/** Indices of the uncollected pickups in each cell of the spatial hash */
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+
+	/** Instanced mesh components, one per pickup mesh */
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UStaticMesh>, TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> InstancedMeshes;
+
+	/** Actor owning the instanced mesh components */
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> FieldActor;
+
+	/** Size of each spatial hash cell */
+	float CellSize = 400.0f;
+
+	/** Largest collection radius in the field */
+	float MaxRadius = 0.0f;
+
+	/** Number of pickups not yet collected */
+	int32 NumRemaining = 0;
+
+public:
+
+	/**
+	 *  Adds a pickup to the field, drawn with the given mesh component's mesh, materials and world transform.
+	 *  Returns false if the pickup can't be added, in which case the caller should stay an actor.
+	 */
+	static bool AddPickup(const UObject* WorldContextObject, const FVector& Location, float Radius, const UStaticMeshComponent* Mesh);
+
+	/** Returns the number of pickups not yet collected */
+	int32 GetNumRemaining() const { return NumRemaining; }
+
+	/** Collects the pickups each player character is touching */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for this subsystem */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the spatial hash cell containing the location */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Returns the instanced mesh component for the mesh, creating it if needed */
+	UHierarchicalInstancedStaticMeshComponent* GetInstancedMesh(const UStaticMeshComponent* Mesh);
+
+	/** Collects the pickups overlapping the given capsule */
+	void QueryCapsule(const FVector& Center, float Radius, float HalfHeight);
+
+	/** Collects a pickup, hiding its instance and reporting it to the game mode */
+	void CollectPickup(int32 Index);
+};
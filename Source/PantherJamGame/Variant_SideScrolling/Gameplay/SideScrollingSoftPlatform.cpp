@@ -6,10 +6,12 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/BoxComponent.h"
 #include "SideScrollingCharacter.h"
+#include "SideScrollingFloorProfileSubsystem.h"
+#include "SideScrollingSoftCollisionSubsystem.h"
 
 ASideScrollingSoftPlatform::ASideScrollingSoftPlatform()
 {
- 	PrimaryActorTick.bCanEverTick = true;
+ 	PrimaryActorTick.bCanEverTick = false;
 
 	// create the root component
 	RootComponent = Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
@@ -34,26 +36,37 @@ ASideScrollingSoftPlatform::ASideScrollingSoftPlatform()
 
 	// subscribe to the overlap events
 	CollisionCheckBox->OnComponentBeginOverlap.AddDynamic(this, &ASideScrollingSoftPlatform::OnSoftCollisionOverlap);
+	CollisionCheckBox->OnComponentEndOverlap.AddDynamic(this, &ASideScrollingSoftPlatform::OnSoftCollisionEndOverlap);
+}
+
+void ASideScrollingSoftPlatform::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// keep the camera's floor profile up to date if we're moved or our collision changes
+	USideScrollingFloorProfileSubsystem::RegisterDynamicFloor(this);
 }
 
 void ASideScrollingSoftPlatform::OnSoftCollisionOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	// have we overlapped a character?
-	if (ASideScrollingCharacter* Char = Cast<ASideScrollingCharacter>(OtherActor))
+	// have we overlapped a character's capsule?
+	ASideScrollingCharacter* Char = Cast<ASideScrollingCharacter>(OtherActor);
+
+	if (Char && OtherComp == Char->GetRootComponent())
 	{
-		// disable the soft collision channel
-		Char->SetSoftCollision(true);
+		// let the character pass until it clears every soft platform
+		USideScrollingSoftCollisionSubsystem::AddOverlap(Char);
 	}
 }
 
-void ASideScrollingSoftPlatform::NotifyActorEndOverlap(AActor* OtherActor)
+void ASideScrollingSoftPlatform::OnSoftCollisionEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-	Super::NotifyActorEndOverlap(OtherActor);
+	// has a character's capsule left?
+	ASideScrollingCharacter* Char = Cast<ASideScrollingCharacter>(OtherActor);
 
-	// have we overlapped a character?
-	if (ASideScrollingCharacter* Char = Cast<ASideScrollingCharacter>(OtherActor))
+	if (Char && OtherComp == Char->GetRootComponent())
 	{
-		// enable the soft collision channel
-		Char->SetSoftCollision(false);
+		// block again once it's not overlapping any other soft platform
+		USideScrollingSoftCollisionSubsystem::RemoveOverlap(Char);
 	}
 }
@@ -37,10 +37,14 @@ public:
 
 protected:
 
+	/** Registers the platform with the floor height profile */
+	virtual void BeginPlay() override;
+
 	/** Handles soft collision check box overlaps */
 	UFUNCTION()
 	void OnSoftCollisionOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
-	/** Restores soft collision state when overlap ends */
-	virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
+	/** Handles soft collision check box overlaps ending */
+	UFUNCTION()
+	void OnSoftCollisionEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 };
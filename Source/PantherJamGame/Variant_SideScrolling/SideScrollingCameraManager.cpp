@@ -6,9 +6,28 @@
 #include "Engine/HitResult.h"
 #include "CollisionQueryParams.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "SideScrollingFloorProfileSubsystem.h"
+#include "PantherJamStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSideScrollingCamera, Log, All);
+
+static TAutoConsoleVariable<bool> CVarFloorProfileEnabled(
+	TEXT("SideScrolling.FloorProfile.Enabled"),
+	true,
+	TEXT("If true, the side scrolling camera looks up the ground below its target in the baked floor height profile. If false, it traces for it every frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarFloorProfileValidate(
+	TEXT("SideScrolling.FloorProfile.Validate"),
+	false,
+	TEXT("If true, the side scrolling camera also traces for ground and counts the frames where the floor height profile disagrees."),
+	ECVF_Default);
 
 void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime)
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(CameraUpdate);
+
 	// ensure the view target is a pawn
 	APawn* TargetPawn = Cast<APawn>(OutVT.Target);
 
@@ -57,16 +76,36 @@ void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float De
 
 		} else {
 
-			// run a trace below the character to determine if we need to do a height update
-			FHitResult OutHit;
+			// look up the ground below the character in the floor profile, or trace for it if the profile can't tell
+			bool bHasFloor = false;
+
+			USideScrollingFloorProfileSubsystem* FloorProfile = CVarFloorProfileEnabled.GetValueOnGameThread() ? GetWorld()->GetSubsystem<USideScrollingFloorProfileSubsystem>() : nullptr;
 
-			const FVector End = CurrentActorLocation + FVector(0.0f, 0.0f, -1000.0f);
+			if (FloorProfile && FloorProfile->FindFloorBelow(CurrentActorLocation, FloorCheckDistance, bHasFloor))
+			{
+				// compare against the trace we skipped
+				if (CVarFloorProfileValidate.GetValueOnGameThread())
+				{
+					++FloorProfileChecks;
+
+					if (TraceFloorBelow(TargetPawn, CurrentActorLocation) != bHasFloor)
+					{
+						++FloorProfileMismatches;
+
+						PANTHERJAM_INC_COUNTER(FloorProfileMismatches, 1);
+
+						UE_LOG(LogSideScrollingCamera, Verbose, TEXT("Floor profile disagrees with the trace at %s"), *CurrentActorLocation.ToString());
+					}
+				}
+
+			} else {
 
-			FCollisionQueryParams QueryParams;
-			QueryParams.AddIgnoredActor(TargetPawn);
+				bHasFloor = TraceFloorBelow(TargetPawn, CurrentActorLocation);
+
+			}
 
 			// only update height if we're not about to hit ground
-			bZUpdate = !GetWorld()->LineTraceSingleByChannel(OutHit, CurrentActorLocation, End, ECC_Visibility, QueryParams);
+			bZUpdate = !bHasFloor;
 
 		}
 
@@ -102,4 +141,25 @@ void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float De
 
 		OutVT.POV.Location = FMath::VInterpTo(CurrentCameraLocation, TargetCameraLocation, DeltaTime, 2.0f);
 	}
-}
\ No newline at end of file
+}
+
+void ASideScrollingCameraManager::ResetFloorProfileCounters()
+{
+	FloorProfileChecks = 0;
+	FloorProfileMismatches = 0;
+}
+
+bool ASideScrollingCameraManager::TraceFloorBelow(const APawn* TargetPawn, const FVector& Location) const
+{
+	// run a trace below the character
+	FHitResult OutHit;
+
+	const FVector End = Location + FVector(0.0f, 0.0f, -FloorCheckDistance);
+
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(TargetPawn);
+
+	PANTHERJAM_INC_COUNTER(Traces, 1);
+
+	return GetWorld()->LineTraceSingleByChannel(OutHit, Location, End, ECC_Visibility, QueryParams);
+}
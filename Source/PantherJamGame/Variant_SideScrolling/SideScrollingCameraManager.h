@@ -6,8 +6,12 @@
 #include "Camera/PlayerCameraManager.h"
 #include "SideScrollingCameraManager.generated.h"
 
+class APawn;
+
 /**
- *  Simple side scrolling camera with smooth scrolling and horizontal bounds
+ *  Simple side scrolling camera with smooth scrolling and horizontal bounds.
+ *  Ground below a moving target is looked up in the level's baked floor height profile instead of traced for.
+ *  SideScrolling.FloorProfile.Validate 1 traces as well and counts disagreements under "stat PantherJam".
  */
 UCLASS()
 class ASideScrollingCameraManager : public APlayerCameraManager
@@ -19,6 +23,18 @@ public:
 	/** Overrides the default camera view target calculation */
 	virtual void UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime) override;
 
+	/** Returns the number of frames the floor profile was validated against a trace */
+	UFUNCTION(BlueprintPure, Category="Side Scrolling Camera")
+	int32 GetFloorProfileChecks() const { return FloorProfileChecks; }
+
+	/** Returns the number of validated frames where the floor profile disagreed with the trace */
+	UFUNCTION(BlueprintPure, Category="Side Scrolling Camera")
+	int32 GetFloorProfileMismatches() const { return FloorProfileMismatches; }
+
+	/** Resets the floor profile validation counters */
+	UFUNCTION(BlueprintCallable, Category="Side Scrolling Camera")
+	void ResetFloorProfileCounters();
+
 public:
 
 	/** How close we want to stay to the view target */
@@ -37,6 +53,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Side Scrolling Camera", meta=(ClampMin=0, ClampMax=10000, Units="cm"))
 	float CameraXMaxBounds = 10000.0f;
 
+	/** How far below the target the camera looks for ground before it follows the target's height */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Side Scrolling Camera", meta=(ClampMin=0, ClampMax=10000, Units="cm"))
+	float FloorCheckDistance = 1000.0f;
+
+protected:
+
+	/** Returns true if a trace finds ground within FloorCheckDistance below the location */
+	bool TraceFloorBelow(const APawn* TargetPawn, const FVector& Location) const;
+
 protected:
 
 	/** Last cached camera vertical location. The camera only adjusts its height if necessary. */
@@ -44,4 +69,10 @@ protected:
 
 	/** First-time update camera setup flag */
 	bool bSetup = true;
+
+	/** Number of frames the floor profile was validated against a trace */
+	int32 FloorProfileChecks = 0;
+
+	/** Number of validated frames where the floor profile disagreed with the trace */
+	int32 FloorProfileMismatches = 0;
 };
@@ -13,6 +13,10 @@
 #include "SideScrollingInteractable.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "TimerManager.h"
+#include "SideScrollingSoftCollisionSubsystem.h"
+#include "PantherJamInputRecordingSubsystem.h"
+#include "PantherJamStats.h"
+#include "PantherJamPresentation.h"
 
 ASideScrollingCharacter::ASideScrollingCharacter()
 {
@@ -59,6 +63,17 @@ ASideScrollingCharacter::ASideScrollingCharacter()
 	JumpMaxCount = 2;
 }
 
+void ASideScrollingCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// nobody is watching on a dedicated server, so switch off the camera
+	if (!FPantherJamPresentation::IsEnabled(this))
+	{
+		FPantherJamPresentation::DisableComponent(Camera);
+	}
+}
+
 void ASideScrollingCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
@@ -143,6 +158,8 @@ void ASideScrollingCharacter::DropReleased(const FInputActionValue& Value)
 
 void ASideScrollingCharacter::DoMove(float Forward)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Move, FVector2f(Forward, 0.0f));
+
 	// is movement temporarily disabled after wall jumping?
 	if (!bHasWallJumped)
 	{
@@ -159,23 +176,31 @@ void ASideScrollingCharacter::DoMove(float Forward)
 
 void ASideScrollingCharacter::DoDrop(float Value)
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Drop, FVector2f(Value, 0.0f));
+
 	// save the movement value
 	DropValue = Value;
 }
 
 void ASideScrollingCharacter::DoJumpStart()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::JumpStart);
+
 	// handle advanced jump behaviors
 	MultiJump();
 }
 
 void ASideScrollingCharacter::DoJumpEnd()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::JumpEnd);
+
 	StopJumping();
 }
 
 void ASideScrollingCharacter::DoInteract()
 {
+	UPantherJamInputRecordingSubsystem::RecordInput(this, EPantherJamInputAction::Interact);
+
 	// do a sphere trace to look for interactive objects
 	FHitResult OutHit;
 
@@ -192,6 +217,8 @@ void ASideScrollingCharacter::DoInteract()
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
+	PANTHERJAM_INC_COUNTER(Traces, 1);
+
 	if (GetWorld()->SweepSingleByObjectType(OutHit, Start, End, FQuat::Identity, ObjectParams, ColSphere, QueryParams))
 	{
 		// have we hit an interactable?
@@ -203,8 +230,39 @@ void ASideScrollingCharacter::DoInteract()
 	}
 }
 
+void ASideScrollingCharacter::ReplayInput(EPantherJamInputAction Action, const FVector2f& Value)
+{
+	switch (Action)
+	{
+	case EPantherJamInputAction::Move:
+		DoMove(Value.X);
+		break;
+
+	case EPantherJamInputAction::Drop:
+		DoDrop(Value.X);
+		break;
+
+	case EPantherJamInputAction::JumpStart:
+		DoJumpStart();
+		break;
+
+	case EPantherJamInputAction::JumpEnd:
+		DoJumpEnd();
+		break;
+
+	case EPantherJamInputAction::Interact:
+		DoInteract();
+		break;
+
+	default:
+		break;
+	}
+}
+
 void ASideScrollingCharacter::MultiJump()
 {
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(MultiJump);
+
 	// does the user want to drop to a lower platform?
 	if (DropValue > 0.0f)
 	{
@@ -234,6 +292,8 @@ void ASideScrollingCharacter::MultiJump()
 		FCollisionQueryParams QueryParams;
 		QueryParams.AddIgnoredActor(this);
 
+		PANTHERJAM_INC_COUNTER(Traces, 1);
+
 		GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
 
 		if (OutHit.bBlockingHit)
@@ -291,13 +351,15 @@ void ASideScrollingCharacter::CheckForSoftCollision()
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
+	PANTHERJAM_INC_COUNTER(Traces, 1);
+
 	GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, ObjectParams, QueryParams);
 
 	// did we hit a soft floor?
 	if (OutHit.GetActor())
 	{
 		// drop through the floor
-		SetSoftCollision(true);
+		USideScrollingSoftCollisionSubsystem::RequestDrop(this);
 	}
 }
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "PantherJamInputReplayable.h"
 #include "SideScrollingCharacter.generated.h"
 
 class UCameraComponent;
@@ -14,7 +15,7 @@ struct FInputActionValue;
  *  A player-controllable character side scrolling game
  */
 UCLASS(abstract)
-class ASideScrollingCharacter : public ACharacter
+class ASideScrollingCharacter : public ACharacter, public IPantherJamInputReplayable
 {
 	GENERATED_BODY()
 
@@ -97,6 +98,9 @@ public:
 
 protected:
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** Gameplay cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
@@ -142,6 +146,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Input")
 	virtual void DoInteract();
 
+	// ~begin IPantherJamInputReplayable interface
+
+	/** Performs a recorded input through the Do* entry points */
+	virtual void ReplayInput(EPantherJamInputAction Action, const FVector2f& Value) override;
+
+	// ~end IPantherJamInputReplayable interface
+
 protected:
 
 	/** Handles advanced jump logic */
@@ -155,7 +166,7 @@ protected:
 
 public:
 
-	/** Sets the soft collision response. True passes, False blocks */
+	/** Sets the soft collision response. True passes, False blocks. Use USideScrollingSoftCollisionSubsystem instead of calling this directly */
 	void SetSoftCollision(bool bEnabled);
 
 public:
@@ -0,0 +1,290 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingFloorProfileSubsystem.h"
+#include "SideScrollingGameMode.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/HitResult.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "CollisionQueryParams.h"
+#include "HAL/IConsoleManager.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<float> CVarFloorProfileBinSize(
+	TEXT("SideScrolling.FloorProfile.BinSize"),
+	25.0f,
+	TEXT("Width of each slice of the floor height profile, in cm. Applies to the next bake."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarFloorProfileMaxBins(
+	TEXT("SideScrolling.FloorProfile.MaxBins"),
+	8192,
+	TEXT("Maximum number of slices in the floor height profile. Slices are widened to fit larger levels."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFloorProfilePlaneTolerance(
+	TEXT("SideScrolling.FloorProfile.PlaneTolerance"),
+	50.0f,
+	TEXT("How far off the baked play plane a location can be and still use the floor height profile, in cm."),
+	ECVF_Default);
+
+/** Maximum number of traces down a single slice. Bounds the number of stacked floors per slice */
+static constexpr int32 MaxTracesPerBin = 16;
+
+void USideScrollingFloorProfileSubsystem::RegisterDynamicFloor(AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	USideScrollingFloorProfileSubsystem* Subsystem = World ? World->GetSubsystem<USideScrollingFloorProfileSubsystem>() : nullptr;
+
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	for (const FSideScrollingDynamicFloor& Floor : Subsystem->DynamicFloors)
+	{
+		if (Floor.Actor == Actor)
+		{
+			return;
+		}
+	}
+
+	FSideScrollingDynamicFloor& Floor = Subsystem->DynamicFloors.AddDefaulted_GetRef();
+	Floor.Actor = Actor;
+	Floor.Bounds = GetFloorBounds(Actor);
+}
+
+bool USideScrollingFloorProfileSubsystem::FindFloorBelow(const FVector& Location, float MaxDistance, bool& bOutHasFloor)
+{
+	if (!bBaked || Bins.IsEmpty() || !FMath::IsNearlyEqual(Location.Y, PlaneY, CVarFloorProfilePlaneTolerance.GetValueOnGameThread()))
+	{
+		return false;
+	}
+
+	const float BinX = (Location.X - MinX) / BinSize;
+	const int32 Index = FMath::FloorToInt32(BinX);
+
+	// the slice centers on either side of the location
+	const int32 NeighbourIndex = BinX - Index < 0.5f ? Index - 1 : Index + 1;
+
+	if (!Bins.IsValidIndex(Index) || !Bins.IsValidIndex(NeighbourIndex))
+	{
+		return false;
+	}
+
+	bOutHasFloor = HasFloorBelow(Bins[Index], Location, MaxDistance);
+
+	// a ledge between the two centers could be on either side of us, so let the caller trace
+	return HasFloorBelow(Bins[NeighbourIndex], Location, MaxDistance) == bOutHasFloor;
+}
+
+void USideScrollingFloorProfileSubsystem::Tick(float DeltaTime)
+{
+	for (int32 Index = DynamicFloors.Num() - 1; Index >= 0; --Index)
+	{
+		FSideScrollingDynamicFloor& Floor = DynamicFloors[Index];
+		const AActor* Actor = Floor.Actor.Get();
+
+		// an invalid box leaves the dirty range at the old bounds, so removed platforms are baked out too
+		const FBox Bounds = Actor ? GetFloorBounds(Actor) : FBox(ForceInit);
+
+		const bool bUnchanged = Bounds.IsValid == Floor.Bounds.IsValid
+			&& Bounds.Min.Equals(Floor.Bounds.Min, 1.0f)
+			&& Bounds.Max.Equals(Floor.Bounds.Max, 1.0f);
+
+		if (!bUnchanged)
+		{
+			// bake the slices under both the old and the new bounds
+			FBox DirtyBounds = Floor.Bounds;
+			DirtyBounds += Bounds;
+
+			if (bBaked && DirtyBounds.IsValid)
+			{
+				BakeRange(DirtyBounds.Min.X, DirtyBounds.Max.X);
+			}
+
+			Floor.Bounds = Bounds;
+		}
+
+		if (!Actor)
+		{
+			DynamicFloors.RemoveAtSwap(Index, EAllowShrinking::No);
+		}
+	}
+}
+
+TStatId USideScrollingFloorProfileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USideScrollingFloorProfileSubsystem, STATGROUP_Tickables);
+}
+
+void USideScrollingFloorProfileSubsystem::Deinitialize()
+{
+	Bins.Empty();
+	DynamicFloors.Empty();
+
+	Super::Deinitialize();
+}
+
+bool USideScrollingFloorProfileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USideScrollingFloorProfileSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// only side scrolling levels use the profile. Clients don't have the game mode, so go by the world settings
+	const AGameModeBase* GameMode = InWorld.GetAuthGameMode();
+	const UClass* GameModeClass = GameMode ? GameMode->GetClass() : InWorld.GetWorldSettings()->DefaultGameMode.Get();
+
+	if (!GameModeClass || !GameModeClass->IsChildOf<ASideScrollingGameMode>())
+	{
+		return;
+	}
+
+	// players spawn on the play plane
+	TActorIterator<APlayerStart> It(&InWorld);
+
+	if (!It)
+	{
+		return;
+	}
+
+	Bake(It->GetActorLocation().Y);
+}
+
+void USideScrollingFloorProfileSubsystem::Bake(float InPlaneY)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(FloorProfileBake);
+
+	bBaked = true;
+	PlaneY = InPlaneY;
+	Bins.Reset();
+
+	const float PlaneTolerance = CVarFloorProfilePlaneTolerance.GetValueOnGameThread();
+
+	// find the extents of the level geometry that crosses the play plane
+	FBox LevelBounds(ForceInit);
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (It->IsA<APawn>())
+		{
+			continue;
+		}
+
+		const FBox Bounds = GetFloorBounds(*It);
+
+		if (Bounds.IsValid && Bounds.Min.Y - PlaneTolerance <= PlaneY && Bounds.Max.Y + PlaneTolerance >= PlaneY)
+		{
+			LevelBounds += Bounds;
+		}
+	}
+
+	if (!LevelBounds.IsValid)
+	{
+		return;
+	}
+
+	// widen the slices if the level is too long to fit
+	const float Length = FMath::Max(LevelBounds.Max.X - LevelBounds.Min.X, 1.0f);
+	const int32 MaxBins = FMath::Max(CVarFloorProfileMaxBins.GetValueOnGameThread(), 1);
+
+	BinSize = FMath::Max(CVarFloorProfileBinSize.GetValueOnGameThread(), Length / MaxBins);
+	MinX = LevelBounds.Min.X;
+	TopZ = LevelBounds.Max.Z + 10.0f;
+	BottomZ = LevelBounds.Min.Z - 10.0f;
+
+	Bins.SetNum(FMath::Clamp(FMath::CeilToInt32(Length / BinSize), 1, MaxBins));
+
+	for (int32 Index = 0; Index < Bins.Num(); ++Index)
+	{
+		BakeBin(Index);
+	}
+}
+
+void USideScrollingFloorProfileSubsystem::BakeRange(float StartX, float EndX)
+{
+	PANTHERJAM_SCOPE_CYCLE_COUNTER(FloorProfileBake);
+
+	if (Bins.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 FirstIndex = FMath::Max(FMath::FloorToInt32((StartX - MinX) / BinSize), 0);
+	const int32 LastIndex = FMath::Min(FMath::FloorToInt32((EndX - MinX) / BinSize), Bins.Num() - 1);
+
+	for (int32 Index = FirstIndex; Index <= LastIndex; ++Index)
+	{
+		BakeBin(Index);
+	}
+}
+
+void USideScrollingFloorProfileSubsystem::BakeBin(int32 Index)
+{
+	FSideScrollingFloorBin& Bin = Bins[Index];
+	Bin.Heights.Reset();
+
+	const float X = MinX + (Index + 0.5f) * BinSize;
+
+	FVector Start(X, PlaneY, TopZ);
+	const FVector End(X, PlaneY, BottomZ);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SideScrollingFloorProfile), false);
+
+	// trace down the slice, one floor at a time
+	for (int32 Step = 0; Step < MaxTracesPerBin && Start.Z > End.Z; ++Step)
+	{
+		FHitResult Hit;
+
+		PANTHERJAM_INC_COUNTER(Traces, 1);
+
+		if (!GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, QueryParams))
+		{
+			break;
+		}
+
+		// pawns and geometry we started inside of aren't floors, so look past them
+		if (Hit.bStartPenetrating || Cast<APawn>(Hit.GetActor()))
+		{
+			QueryParams.AddIgnoredComponent(Hit.GetComponent());
+			continue;
+		}
+
+		Bin.Heights.Add(Hit.ImpactPoint.Z);
+
+		// continue from just below the floor
+		Start.Z = Hit.ImpactPoint.Z - 1.0f;
+	}
+}
+
+bool USideScrollingFloorProfileSubsystem::HasFloorBelow(const FSideScrollingFloorBin& Bin, const FVector& Location, float MaxDistance)
+{
+	// heights are sorted from the top, so the first one below us is the floor we'd land on
+	for (const float Height : Bin.Heights)
+	{
+		if (Height <= Location.Z)
+		{
+			return Location.Z - Height <= MaxDistance;
+		}
+	}
+
+	return false;
+}
+
+FBox USideScrollingFloorProfileSubsystem::GetFloorBounds(const AActor* Actor)
+{
+	if (!Actor->GetActorEnableCollision())
+	{
+		return FBox(ForceInit);
+	}
+
+	// only colliding components can be floors
+	return Actor->GetComponentsBoundingBox(false);
+}
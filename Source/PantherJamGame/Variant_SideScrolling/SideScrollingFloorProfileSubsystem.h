@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SideScrollingFloorProfileSubsystem.generated.h"
+
+/**
+ *  Floor heights baked for one slice of the level along X
+ */
+struct FSideScrollingFloorBin
+{
+	/** Heights of every floor surface in the slice, from highest to lowest */
+	TArray<float, TInlineAllocator<4>> Heights;
+};
+
+/**
+ *  A platform that can move or change its collision after the profile is baked
+ */
+struct FSideScrollingDynamicFloor
+{
+	/** The platform actor */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Colliding bounds of the platform when its slices were last baked */
+	FBox Bounds = FBox(ForceInit);
+};
+
+/**
+ *  Bakes the walkable floor heights of a side scrolling level into a 1D profile along X,
+ *  so the camera can tell if there's ground below its target with a lookup instead of a downward trace every frame.
+ *  Side scrolling levels are baked at begin play along the player start's plane, by tracing down the center of each slice once.
+ *  Near ledges, where neighbouring slices disagree, lookups refuse to answer so the caller traces instead.
+ *  Moving and soft platforms register themselves, and the slices they cover are baked again whenever their bounds change.
+ *  Pawns are never baked into the profile.
+ */
+UCLASS()
+class USideScrollingFloorProfileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Baked slices, starting at MinX */
+	TArray<FSideScrollingFloorBin> Bins;
+
+	/** Platforms that can change after baking */
+	TArray<FSideScrollingDynamicFloor> DynamicFloors;
+
+	/** World X of the start of the first slice */
+	float MinX = 0.0f;
+
+	/** Width of each slice */
+	float BinSize = 25.0f;
+
+	/** World Y of the plane the profile was baked along */
+	float PlaneY = 0.0f;
+
+	/** Highest point of the level geometry. Slices are traced down from here */
+	float TopZ = 0.0f;
+
+	/** Lowest point of the level geometry. Slices are traced down to here */
+	float BottomZ = 0.0f;
+
+	/** If true, the profile has been baked */
+	bool bBaked = false;
+
+public:
+
+	/** Registers a platform that can move or change its collision during play */
+	static void RegisterDynamicFloor(AActor* Actor);
+
+	/**
+	 *  Looks up whether there's a floor below the location, within the given distance.
+	 *  Returns false if the profile can't answer for this location, in which case the caller should trace instead.
+	 *  That's the case off the baked plane, outside the level, and where this slice and the neighbouring one
+	 *  the location is closest to disagree, since the slices are only sampled at their centers.
+	 */
+	bool FindFloorBelow(const FVector& Location, float MaxDistance, bool& bOutHasFloor);
+
+	/** Refreshes the slices under platforms that moved */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for this subsystem */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Bakes the profile for side scrolling levels, before any actor begins play */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Bakes every slice of the level along the given plane */
+	void Bake(float InPlaneY);
+
+	/** Bakes the slices overlapping the given X range again */
+	void BakeRange(float StartX, float EndX);
+
+	/** Traces down the given slice and stores the floor heights found */
+	void BakeBin(int32 Index);
+
+	/** Returns true if the slice has a floor below the location, within the given distance */
+	static bool HasFloorBelow(const FSideScrollingFloorBin& Bin, const FVector& Location, float MaxDistance);
+
+	/** Returns the colliding bounds of the actor */
+	static FBox GetFloorBounds(const AActor* Actor);
+};
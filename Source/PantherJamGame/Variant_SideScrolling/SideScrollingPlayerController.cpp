@@ -9,6 +9,7 @@
 #include "SideScrollingCharacter.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
+#include "PantherJamStats.h"
 
 void ASideScrollingPlayerController::SetupInputComponent()
 {
@@ -41,6 +42,8 @@ void ASideScrollingPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 		// spawn a character at the player start
 		const FTransform SpawnTransform = ActorList[0]->GetActorTransform();
 
+		PANTHERJAM_INC_COUNTER(Spawns, 1);
+
 		if (ASideScrollingCharacter* RespawnedCharacter = GetWorld()->SpawnActor<ASideScrollingCharacter>(CharacterClass, SpawnTransform))
 		{
 			// possess the character
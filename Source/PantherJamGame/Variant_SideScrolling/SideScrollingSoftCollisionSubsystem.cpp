@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingSoftCollisionSubsystem.h"
+#include "SideScrollingCharacter.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "PantherJamStats.h"
+
+static TAutoConsoleVariable<bool> CVarSoftCollisionBatched(
+	TEXT("SideScrolling.SoftCollision.Batched"),
+	true,
+	TEXT("If true, soft collision changes are applied once per character per frame. If false, they're applied as soon as they happen."),
+	ECVF_Default);
+
+void USideScrollingSoftCollisionSubsystem::AddOverlap(ASideScrollingCharacter* Character)
+{
+	if (USideScrollingSoftCollisionSubsystem* Subsystem = Get(Character))
+	{
+		FSideScrollingSoftCollisionState& State = Subsystem->States.FindOrAdd(Character);
+		++State.OverlapCount;
+
+		Subsystem->OnStateChanged(Character, State);
+	}
+}
+
+void USideScrollingSoftCollisionSubsystem::RemoveOverlap(ASideScrollingCharacter* Character)
+{
+	USideScrollingSoftCollisionSubsystem* Subsystem = Get(Character);
+	FSideScrollingSoftCollisionState* State = Subsystem ? Subsystem->States.Find(Character) : nullptr;
+
+	if (!State || State->OverlapCount <= 0)
+	{
+		return;
+	}
+
+	// once the character clears every platform, it's done dropping
+	if (--State->OverlapCount == 0)
+	{
+		State->bDropRequested = false;
+	}
+
+	Subsystem->OnStateChanged(Character, *State);
+}
+
+void USideScrollingSoftCollisionSubsystem::RequestDrop(ASideScrollingCharacter* Character)
+{
+	if (USideScrollingSoftCollisionSubsystem* Subsystem = Get(Character))
+	{
+		FSideScrollingSoftCollisionState& State = Subsystem->States.FindOrAdd(Character);
+		State.bDropRequested = true;
+
+		Subsystem->OnStateChanged(Character, State);
+	}
+}
+
+void USideScrollingSoftCollisionSubsystem::Tick(float DeltaTime)
+{
+	if (PendingEvents == 0)
+	{
+		return;
+	}
+
+	int32 Applied = 0;
+
+	for (auto It = States.CreateIterator(); It; ++It)
+	{
+		ASideScrollingCharacter* Character = It.Key().Get();
+
+		if (!Character)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		FSideScrollingSoftCollisionState& State = It.Value();
+
+		Applied += ApplyState(Character, State) ? 1 : 0;
+
+		// forget characters that are back to blocking and aren't touching any platform
+		if (State.OverlapCount == 0 && !State.bDropRequested && !State.bApplied)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	PANTHERJAM_INC_COUNTER(SoftCollisionUpdates, Applied);
+	PANTHERJAM_INC_COUNTER(SoftCollisionUpdatesAvoided, FMath::Max(PendingEvents - Applied, 0));
+
+	PendingEvents = 0;
+}
+
+TStatId USideScrollingSoftCollisionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USideScrollingSoftCollisionSubsystem, STATGROUP_Tickables);
+}
+
+void USideScrollingSoftCollisionSubsystem::Deinitialize()
+{
+	States.Empty();
+
+	Super::Deinitialize();
+}
+
+bool USideScrollingSoftCollisionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USideScrollingSoftCollisionSubsystem* USideScrollingSoftCollisionSubsystem::Get(const ASideScrollingCharacter* Character)
+{
+	UWorld* World = Character ? Character->GetWorld() : nullptr;
+
+	return World ? World->GetSubsystem<USideScrollingSoftCollisionSubsystem>() : nullptr;
+}
+
+void USideScrollingSoftCollisionSubsystem::OnStateChanged(ASideScrollingCharacter* Character, FSideScrollingSoftCollisionState& State)
+{
+	// hold the change until the end of the frame
+	if (CVarSoftCollisionBatched.GetValueOnGameThread())
+	{
+		++PendingEvents;
+		return;
+	}
+
+	// ref counting alone still skips changes that don't flip the state
+	if (ApplyState(Character, State))
+	{
+		PANTHERJAM_INC_COUNTER(SoftCollisionUpdates, 1);
+
+	} else {
+
+		PANTHERJAM_INC_COUNTER(SoftCollisionUpdatesAvoided, 1);
+	}
+}
+
+bool USideScrollingSoftCollisionSubsystem::ApplyState(ASideScrollingCharacter* Character, FSideScrollingSoftCollisionState& State)
+{
+	const bool bPass = State.OverlapCount > 0 || State.bDropRequested;
+
+	if (bPass == State.bApplied)
+	{
+		return false;
+	}
+
+	State.bApplied = bPass;
+	Character->SetSoftCollision(bPass);
+
+	return true;
+}
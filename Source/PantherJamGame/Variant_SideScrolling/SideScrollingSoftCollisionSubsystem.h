@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SideScrollingSoftCollisionSubsystem.generated.h"
+
+class ASideScrollingCharacter;
+
+/**
+ *  Soft collision state of a single character
+ */
+struct FSideScrollingSoftCollisionState
+{
+	/** Number of soft platform check boxes the character is overlapping */
+	int32 OverlapCount = 0;
+
+	/** If true, the character asked to drop through the floor below and should pass until it clears the platform */
+	bool bDropRequested = false;
+
+	/** Soft collision state last applied to the character's capsule */
+	bool bApplied = false;
+};
+
+/**
+ *  Decides when characters pass through soft platforms.
+ *  Overlaps with soft platform check boxes are ref counted per character, so overlapping several platforms at once
+ *  only blocks again once the character clears all of them.
+ *  Changes are applied from Tick, after movement, so each character gets at most one collision response change
+ *  and physics filter update per frame. Applied and avoided updates are reported under "stat PantherJam".
+ *  SideScrolling.SoftCollision.Batched 0 applies changes as soon as they happen instead, for comparison.
+ */
+UCLASS()
+class USideScrollingSoftCollisionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Soft collision state of every character touching a soft platform */
+	TMap<TWeakObjectPtr<ASideScrollingCharacter>, FSideScrollingSoftCollisionState> States;
+
+	/** Number of overlap and drop events since the last tick. Each one used to change the collision response */
+	int32 PendingEvents = 0;
+
+public:
+
+	/** Called when the character starts overlapping a soft platform's check box */
+	static void AddOverlap(ASideScrollingCharacter* Character);
+
+	/** Called when the character stops overlapping a soft platform's check box */
+	static void RemoveOverlap(ASideScrollingCharacter* Character);
+
+	/** Lets the character drop through the soft floor below it */
+	static void RequestDrop(ASideScrollingCharacter* Character);
+
+	/** Applies the changed soft collision states */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for this subsystem */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns the subsystem for the character's world, if any */
+	static USideScrollingSoftCollisionSubsystem* Get(const ASideScrollingCharacter* Character);
+
+	/** Marks the character's state as changed, applying it right away if changes aren't batched */
+	void OnStateChanged(ASideScrollingCharacter* Character, FSideScrollingSoftCollisionState& State);
+
+	/** Applies the character's state to its capsule if it changed. Returns true if it did */
+	static bool ApplyState(ASideScrollingCharacter* Character, FSideScrollingSoftCollisionState& State);
+};